@@ -222,7 +222,7 @@ future<> cache_flat_mutation_reader::process_static_row() {
         }
         return make_ready_future<>();
     } else {
-        _read_context.cache().on_row_miss();
+        _read_context.cache().on_row_miss(_permit);
         return ensure_underlying().then([this] {
             return (*_underlying)().then([this] (mutation_fragment_opt&& sr) {
                 if (sr) {
@@ -344,7 +344,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
     return consume_mutation_fragments_until(*_underlying,
         [this] { return _state != state::reading_from_underlying || is_buffer_full(); },
         [this] (mutation_fragment mf) {
-            _read_context.cache().on_row_miss();
+            _read_context.cache().on_row_miss(_permit);
             maybe_add_to_cache(mf);
             add_to_buffer(std::move(mf));
         },
@@ -679,7 +679,8 @@ void cache_flat_mutation_reader::add_to_buffer(const partition_snapshot_row_curs
         if (_read_context.digest_requested()) {
             row.latest_row().cells().prepare_hash(*_schema, column_kind::regular_column);
         }
-        add_clustering_row_to_buffer(mutation_fragment(*_schema, _permit, row.row()));
+        auto& columns = _read_context.projected_columns();
+        add_clustering_row_to_buffer(mutation_fragment(*_schema, _permit, columns ? row.row(*columns) : row.row()));
     } else {
         position_in_partition::less_compare less(*_schema);
         if (less(_lower_bound, row.position())) {
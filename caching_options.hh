@@ -38,7 +38,10 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    // Whether coordinators cache the results of single partition reads,
+    // see service::coordinator_result_cache.
+    bool _coordinator_results = false;
+    caching_options(sstring k, sstring r, bool enabled, bool coordinator_results = false);
 
     friend class schema;
     caching_options();
@@ -47,6 +50,10 @@ class caching_options {
         return _enabled;
     }
 
+    bool coordinator_results() const {
+        return _coordinator_results;
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
@@ -440,6 +440,8 @@ class compaction {
     sstables::compaction_type _type;
     uint64_t _max_sstable_size;
     uint32_t _sstable_level;
+    // The output is repaired only if all the input is.
+    uint64_t _repaired_at = 0;
     uint64_t _start_size = 0;
     uint64_t _end_size = 0;
     uint64_t _estimated_partitions = 0;
@@ -486,6 +488,11 @@ class compaction {
         for (auto& sst : _sstables) {
             _stats_collector.update(sst->get_encoding_stats_for_compaction());
         }
+        if (!_sstables.empty()) {
+            _repaired_at = (*std::min_element(_sstables.begin(), _sstables.end(), [] (const shared_sstable& a, const shared_sstable& b) {
+                return a->repaired_at() < b->repaired_at();
+            }))->repaired_at();
+        }
         std::unordered_set<utils::UUID> ssts_run_ids;
         _contains_multi_fragment_runs = std::any_of(_sstables.begin(), _sstables.end(), [&ssts_run_ids] (shared_sstable& sst) {
             return !ssts_run_ids.insert(sst->run_identifier()).second;
@@ -527,6 +534,7 @@ class compaction {
         cfg.run_identifier = _run_identifier;
         cfg.replay_position = _rp;
         cfg.sstable_level = _sstable_level;
+        cfg.repaired_at = _repaired_at;
         return cfg;
     }
 
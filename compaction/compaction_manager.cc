@@ -217,6 +217,25 @@ std::vector<sstables::shared_sstable> compaction_manager::get_candidates(const t
     return candidates;
 }
 
+std::vector<std::vector<sstables::shared_sstable>>
+compaction_manager::split_by_repair_state(const table& t, std::vector<sstables::shared_sstable> candidates) const {
+    std::vector<std::vector<sstables::shared_sstable>> groups;
+    if (t.get_compaction_strategy().type() != sstables::compaction_strategy_type::leveled) {
+        auto repaired = boost::copy_range<std::vector<sstables::shared_sstable>>(candidates
+                | boost::adaptors::filtered(std::mem_fn(&sstables::sstable::is_repaired)));
+        std::erase_if(candidates, std::mem_fn(&sstables::sstable::is_repaired));
+        if (!candidates.empty()) {
+            groups.push_back(std::move(candidates));
+        }
+        if (!repaired.empty()) {
+            groups.push_back(std::move(repaired));
+        }
+    } else if (!candidates.empty()) {
+        groups.push_back(std::move(candidates));
+    }
+    return groups;
+}
+
 void compaction_manager::register_compacting_sstables(const std::vector<sstables::shared_sstable>& sstables) {
     std::unordered_set<sstables::shared_sstable> sstables_to_merge;
     sstables_to_merge.reserve(sstables.size());
@@ -283,24 +302,34 @@ future<> compaction_manager::perform_major_compaction(table* t) {
             }
 
             // candidates are sstables that aren't being operated on by other compaction types.
-            // those are eligible for major compaction.
-            sstables::compaction_strategy cs = t->get_compaction_strategy();
-            sstables::compaction_descriptor descriptor = cs.get_major_compaction_job(t->as_table_state(), get_candidates(*t));
-            auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
-            descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
-                compacting->release_compacting(exhausted_sstables);
-            };
-            task->setup_new_compaction();
-            task->output_run_identifier = descriptor.run_identifier;
-
+            // those are eligible for major compaction. The repaired and unrepaired ones
+            // are compacted separately, like in regular compaction.
             cmlog.info0("User initiated compaction started on behalf of {}.{}", t->schema()->ks_name(), t->schema()->cf_name());
-            compaction_backlog_tracker user_initiated(std::make_unique<user_initiated_backlog_tracker>(_compaction_controller.backlog_of_shares(200), _available_memory));
-            return do_with(std::move(user_initiated), [this, t, descriptor = std::move(descriptor), task] (compaction_backlog_tracker& bt) mutable {
-                register_backlog_tracker(bt);
-                return with_scheduling_group(_compaction_controller.sg(), [this, t, descriptor = std::move(descriptor), task] () mutable {
-                    return t->compact_sstables(std::move(descriptor), task->compaction_data);
+            return do_with(split_by_repair_state(*t, get_candidates(*t)), [this, task, t] (std::vector<std::vector<sstables::shared_sstable>>& groups) {
+                return do_for_each(groups, [this, task, t] (std::vector<sstables::shared_sstable>& candidates) {
+                    if (!can_proceed(task)) {
+                        return make_ready_future<>();
+                    }
+                    sstables::compaction_strategy cs = t->get_compaction_strategy();
+                    sstables::compaction_descriptor descriptor = cs.get_major_compaction_job(t->as_table_state(), std::move(candidates));
+                    auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
+                    descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
+                        compacting->release_compacting(exhausted_sstables);
+                    };
+                    task->setup_new_compaction();
+                    task->output_run_identifier = descriptor.run_identifier;
+
+                    compaction_backlog_tracker user_initiated(std::make_unique<user_initiated_backlog_tracker>(_compaction_controller.backlog_of_shares(200), _available_memory));
+                    return do_with(std::move(user_initiated), [this, t, descriptor = std::move(descriptor), task] (compaction_backlog_tracker& bt) mutable {
+                        register_backlog_tracker(bt);
+                        return with_scheduling_group(_compaction_controller.sg(), [this, t, descriptor = std::move(descriptor), task] () mutable {
+                            return t->compact_sstables(std::move(descriptor), task->compaction_data);
+                        });
+                    }).then([task, compacting = std::move(compacting)] {
+                        task->finish_compaction();
+                    });
                 });
-            }).then([compacting = std::move(compacting)] {});
+            });
         });
     }).then_wrapped([this, task] (future<> f) {
         _stats.active_tasks--;
@@ -673,7 +702,17 @@ void compaction_manager::submit(table* t) {
           return with_scheduling_group(_compaction_controller.sg(), [this, task = std::move(task)] () mutable {
             table& t = *task->compacting_table;
             sstables::compaction_strategy cs = t.get_compaction_strategy();
-            sstables::compaction_descriptor descriptor = cs.get_sstables_for_compaction(t.as_table_state(), get_candidates(t));
+            // Repaired and unrepaired sstables are compacted separately, so
+            // that the data repaired stays so, and isn't read by incremental
+            // repairs. The strategy is given the unrepaired ones first, since
+            // new data lands there.
+            sstables::compaction_descriptor descriptor;
+            for (auto& candidates : split_by_repair_state(t, get_candidates(t))) {
+                descriptor = cs.get_sstables_for_compaction(t.as_table_state(), std::move(candidates));
+                if (!descriptor.sstables.empty()) {
+                    break;
+                }
+            }
             int weight = calculate_weight(descriptor);
 
             if (descriptor.sstables.empty() || !can_proceed(task) || t.is_auto_compaction_disabled_by_user()) {
@@ -811,6 +850,8 @@ future<> compaction_manager::rewrite_sstables(table* t, sstables::compaction_typ
             auto sstable_level = sst->get_sstable_level();
             auto run_identifier = sst->run_identifier();
             auto sstable_set_snapshot = can_purge ? std::make_optional(t.get_sstable_set()) : std::nullopt;
+            // Each sstable is rewritten on its own, so the output keeps its
+            // repair state and repaired and unrepaired data are never mixed.
             auto descriptor = sstables::compaction_descriptor({ sst }, std::move(sstable_set_snapshot), _maintenance_sg.io,
                 sstable_level, sstables::compaction_descriptor::default_max_sstable_bytes, run_identifier, options);
 
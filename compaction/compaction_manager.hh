@@ -182,6 +182,13 @@ class compaction_manager {
     // Get candidates for compaction strategy, which are all sstables but the ones being compacted.
     std::vector<sstables::shared_sstable> get_candidates(const table& t);
 
+    // Split candidates into the groups which compaction may mix: the unrepaired
+    // sstables, then the repaired ones, so that compacting them doesn't make
+    // repaired data unrepaired. Empty groups are left out. Leveled tables get a
+    // single group, since the strategy must see every sstable of a level to keep
+    // the level disjoint; incremental repair isn't supported for them.
+    std::vector<std::vector<sstables::shared_sstable>> split_by_repair_state(const table& t, std::vector<sstables::shared_sstable> candidates) const;
+
     void register_compacting_sstables(const std::vector<sstables::shared_sstable>& sstables);
     void deregister_compacting_sstables(const std::vector<sstables::shared_sstable>& sstables);
 
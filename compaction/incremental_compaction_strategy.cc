@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <unordered_map>
+
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/algorithm/min_element.hpp>
+#include <boost/algorithm/cxx11/any_of.hpp>
+
+#include "incremental_compaction_strategy.hh"
+#include "compaction_backlog_manager.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstable_set_impl.hh"
+#include "cql3/statements/property_definitions.hh"
+#include "exceptions/exceptions.hh"
+
+namespace sstables {
+
+// The backlog of size_tiered_backlog_tracker, with runs in place of sstables:
+// a run is compacted as a whole, so it is the size of the run, not the size
+// of its fragments, which determines how many more times its data will be
+// rewritten. See size_tiered_backlog_tracker.hh for the derivation.
+//
+// For a fragment being written, the written bytes are accounted with the size
+// of the run it belongs to, including the fragments already sealed.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    int64_t _total_bytes = 0;
+    double _runs_backlog_contribution = 0.0f;
+    std::unordered_map<utils::UUID, int64_t> _run_sizes;
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return std::log(x) * inv_log_4;
+    }
+
+    static double contribution(int64_t run_size) {
+        return run_size > 0 ? run_size * log4(run_size) : 0;
+    }
+
+    void update_run_size(const utils::UUID& run_id, int64_t delta) {
+        auto& size = _run_sizes[run_id];
+        _runs_backlog_contribution -= contribution(size);
+        size += delta;
+        _runs_backlog_contribution += contribution(size);
+        if (size <= 0) {
+            _run_sizes.erase(run_id);
+        }
+    }
+
+    int64_t run_size(const shared_sstable& sst) const {
+        auto it = _run_sizes.find(sst->run_identifier());
+        return it != _run_sizes.end() ? it->second : 0;
+    }
+public:
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        int64_t partial_bytes = 0;
+        double partial_contribution = 0;
+        for (auto const& [sst, wp] : ow) {
+            auto written = wp->written();
+            if (written > 0) {
+                partial_bytes += written;
+                partial_contribution += written * log4(run_size(sst) + written);
+            }
+        }
+
+        int64_t compacted_bytes = 0;
+        double compacted_contribution = 0;
+        for (auto const& [sst, rp] : oc) {
+            auto compacted = rp->compacted();
+            compacted_bytes += compacted;
+            compacted_contribution += compacted * log4(std::max(run_size(sst), int64_t(sst->data_size())));
+        }
+
+        auto effective_total_size = _total_bytes + partial_bytes - compacted_bytes;
+        if (effective_total_size <= 0 || _total_bytes == 0) {
+            return 0;
+        }
+        auto runs_contribution = _runs_backlog_contribution + partial_contribution - compacted_contribution;
+        auto b = (effective_total_size * log4(_total_bytes)) - runs_contribution;
+        return b > 0 ? b : 0;
+    }
+
+    virtual void add_sstable(sstables::shared_sstable sst) override {
+        if (sst->data_size() > 0) {
+            _total_bytes += sst->data_size();
+            update_run_size(sst->run_identifier(), sst->data_size());
+        }
+    }
+
+    virtual void remove_sstable(sstables::shared_sstable sst) override {
+        if (sst->data_size() > 0) {
+            _total_bytes -= sst->data_size();
+            update_run_size(sst->run_identifier(), -int64_t(sst->data_size()));
+        }
+    }
+};
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+    , _backlog_tracker(std::make_unique<incremental_backlog_tracker>())
+{
+    using namespace cql3::statements;
+
+    auto fragment_size_in_mb = property_definitions::to_int(FRAGMENT_SIZE_OPTION, get_value(options, FRAGMENT_SIZE_OPTION), DEFAULT_MAX_FRAGMENT_SIZE_IN_MB);
+    if (fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} must be greater than 0, but was {}", FRAGMENT_SIZE_OPTION, fragment_size_in_mb));
+    }
+    _fragment_size = uint64_t(fragment_size_in_mb) * 1024 * 1024;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::get_candidate_runs(table_state& table_s, const std::vector<shared_sstable>& candidates) {
+    std::unordered_map<utils::UUID, sstable_run> runs;
+    for (auto& sst : candidates) {
+        runs[sst->run_identifier()].insert(sst);
+    }
+    // A run is only compacted as a whole, so leave out the runs which have
+    // fragments that are not candidates, e.g. because they are being compacted.
+    table_s.get_sstable_set().for_each_sstable([&runs] (const shared_sstable& sst) {
+        auto it = runs.find(sst->run_identifier());
+        if (it != runs.end() && !it->second.all().contains(sst)) {
+            runs.erase(it);
+        }
+    });
+    std::vector<sstable_run> ret;
+    ret.reserve(runs.size());
+    for (auto& [id, run] : runs) {
+        if (run.data_size() > 0) {
+            ret.push_back(std::move(run));
+        }
+    }
+    return ret;
+}
+
+std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(const std::vector<sstable_run>& runs) const {
+    return size_tiered_compaction_strategy::bucket_by_size(runs, [] (const sstable_run& run) {
+        return run.data_size();
+    }, _options);
+}
+
+std::vector<shared_sstable> incremental_compaction_strategy::runs_to_sstables(std::vector<sstable_run> runs) {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return sstables;
+}
+
+compaction_descriptor incremental_compaction_strategy::make_descriptor(table_state& table_s, std::vector<shared_sstable> sstables) const {
+    return compaction_descriptor(std::move(sstables), table_s.get_sstable_set(), service::get_local_compaction_priority(),
+            compaction_descriptor::default_level, _fragment_size);
+}
+
+// Returns the bucket with the most runs, among those with at least min_threshold
+// runs, trimmed to max_threshold runs.
+static std::vector<sstable_run>
+most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, size_t min_threshold, size_t max_threshold) {
+    std::vector<sstable_run> ret;
+    for (auto& bucket : buckets) {
+        bucket.resize(std::min(bucket.size(), max_threshold));
+        if (bucket.size() >= min_threshold && bucket.size() > ret.size()) {
+            ret = std::move(bucket);
+        }
+    }
+    return ret;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, std::vector<shared_sstable> candidates) {
+    int min_threshold = table_s.min_compaction_threshold();
+    int max_threshold = table_s.schema()->max_compaction_threshold();
+    auto gc_before = gc_clock::now() - table_s.schema()->gc_grace_seconds();
+
+    auto buckets = get_buckets(get_candidate_runs(table_s, candidates));
+
+    auto runs = most_interesting_bucket(buckets, min_threshold, max_threshold);
+    if (runs.empty() && !table_s.compaction_enforce_min_threshold()) {
+        runs = most_interesting_bucket(buckets, 2, max_threshold);
+    }
+    if (!runs.empty()) {
+        return make_descriptor(table_s, runs_to_sstables(std::move(runs)));
+    }
+
+    // Otherwise, compact on its own the oldest run from the biggest tiers
+    // whose droppable tombstone ratio is over the threshold. Compacting a single
+    // run is incremental as well.
+    if (_disable_tombstone_compaction) {
+        return compaction_descriptor();
+    }
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        std::erase_if(bucket, [&] (const sstable_run& run) {
+            auto recently_written = boost::algorithm::any_of(run.all(), [this] (const shared_sstable& sst) {
+                return db_clock::now() - _tombstone_compaction_interval < sst->data_file_write_time();
+            });
+            return recently_written || run.estimate_droppable_tombstone_ratio(gc_before) < _tombstone_threshold;
+        });
+        if (bucket.empty()) {
+            continue;
+        }
+        auto min_timestamp = [] (const sstable_run& run) {
+            auto ts = api::max_timestamp;
+            for (auto& sst : run.all()) {
+                ts = std::min(ts, sst->get_stats_metadata().min_timestamp);
+            }
+            return ts;
+        };
+        auto it = boost::range::min_element(bucket, [&] (const sstable_run& a, const sstable_run& b) {
+            return min_timestamp(a) < min_timestamp(b);
+        });
+        return make_descriptor(table_s, runs_to_sstables({std::move(*it)}));
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates) {
+    return make_descriptor(table_s, std::move(candidates));
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    int min_threshold = table_s.min_compaction_threshold();
+    int max_threshold = table_s.schema()->max_compaction_threshold();
+
+    std::unordered_map<utils::UUID, sstable_run> all_runs;
+    table_s.get_sstable_set().for_each_sstable([&all_runs] (const shared_sstable& sst) {
+        all_runs[sst->run_identifier()].insert(sst);
+    });
+    std::vector<sstable_run> runs;
+    runs.reserve(all_runs.size());
+    for (auto& [id, run] : all_runs) {
+        runs.push_back(std::move(run));
+    }
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(runs)) {
+        if (bucket.size() >= size_t(min_threshold)) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+std::unique_ptr<sstable_set_impl> incremental_compaction_strategy::make_sstable_set(schema_ptr schema) const {
+    return std::make_unique<partitioned_sstable_set>(std::move(schema), make_lw_shared<sstable_list>(), false);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+    // Same policy as STCS, but the output is split into fragments.
+    auto desc = size_tiered_compaction_strategy(_options).get_reshaping_job(std::move(input), std::move(schema), iop, mode);
+    desc.max_sstable_bytes = _fragment_size;
+    return desc;
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstables/sstable_set.hh"
+
+namespace sstables {
+
+// Incremental compaction strategy (ICS).
+//
+// Tiers data like STCS, but the unit of tiering is an sstable run rather than
+// an sstable. Compaction output is split into fragments of at most
+// sstable_size_in_mb, all belonging to the same, token-ordered, run. Since the
+// input of a compaction is made of runs too, compaction can release an input
+// fragment as soon as the output has moved past its last key, instead of
+// holding all its input until it finishes (see
+// compaction::maybe_replace_exhausted_sstables_by_sst()).
+//
+// As a result, the temporary space overhead of a compaction is bounded by
+// about one fragment per input run, rather than by the size of the input as
+// with STCS, and the disk no longer needs 50% of free space for the largest
+// tier (or major compaction) to go through.
+//
+// Options:
+//   sstable_size_in_mb - fragment size, 1000 by default;
+//   min_sstable_size, bucket_low, bucket_high - as in STCS, applied to the
+//       size of runs.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr int32_t DEFAULT_MAX_FRAGMENT_SIZE_IN_MB = 1000;
+    const sstring FRAGMENT_SIZE_OPTION = "sstable_size_in_mb";
+
+    size_tiered_compaction_strategy_options _options;
+    uint64_t _fragment_size;
+    compaction_backlog_tracker _backlog_tracker;
+
+    // Returns the runs made only of the given candidates, i.e. runs none of
+    // whose fragments are being compacted.
+    static std::vector<sstable_run> get_candidate_runs(table_state& table_s, const std::vector<shared_sstable>& candidates);
+
+    std::vector<std::vector<sstable_run>> get_buckets(const std::vector<sstable_run>& runs) const;
+
+    static std::vector<shared_sstable> runs_to_sstables(std::vector<sstable_run> runs);
+
+    compaction_descriptor make_descriptor(table_state& table_s, std::vector<shared_sstable> sstables) const;
+public:
+    explicit incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, std::vector<shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    // Fragments of a run are disjoint, so keeping all of them in the interval
+    // map lets a read select at most one fragment per run.
+    virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const override;
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+
+    uint64_t fragment_size() const {
+        return _fragment_size;
+    }
+};
+
+}
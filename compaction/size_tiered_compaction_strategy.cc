@@ -50,70 +50,13 @@ size_tiered_compaction_strategy_options::size_tiered_compaction_strategy_options
     cold_reads_to_omit = DEFAULT_COLD_READS_TO_OMIT;
 }
 
-std::vector<std::pair<sstables::shared_sstable, uint64_t>>
-size_tiered_compaction_strategy::create_sstable_and_length_pairs(const std::vector<sstables::shared_sstable>& sstables) {
-
-    std::vector<std::pair<sstables::shared_sstable, uint64_t>> sstable_length_pairs;
-    sstable_length_pairs.reserve(sstables.size());
-
-    for(auto& sstable : sstables) {
-        auto sstable_size = sstable->data_size();
-        assert(sstable_size != 0);
-
-        sstable_length_pairs.emplace_back(sstable, sstable_size);
-    }
-
-    return sstable_length_pairs;
-}
-
 std::vector<std::vector<sstables::shared_sstable>>
 size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_sstable>& sstables, size_tiered_compaction_strategy_options options) {
-    // sstables sorted by size of its data file.
-    auto sorted_sstables = create_sstable_and_length_pairs(sstables);
-
-    std::sort(sorted_sstables.begin(), sorted_sstables.end(), [] (auto& i, auto& j) {
-        return i.second < j.second;
-    });
-
-    using bucket_type = std::vector<sstables::shared_sstable>;
-    std::vector<bucket_type> bucket_list;
-    std::vector<double> bucket_average_size_list;
-
-    for (auto& pair : sorted_sstables) {
-        size_t size = pair.second;
-
-        // look for a bucket containing similar-sized files:
-        // group in the same bucket if it's w/in (bucket_low, bucket_high) of the average for this bucket,
-        // or this file and the bucket are all considered "small" (less than `minSSTableSize`)
-        if (!bucket_list.empty()) {
-            auto& bucket_average_size = bucket_average_size_list.back();
-
-            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
-                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
-                auto& bucket = bucket_list.back();
-                auto total_size = bucket.size() * bucket_average_size;
-                auto new_average_size = (total_size + size) / (bucket.size() + 1);
-                auto smallest_sstable_in_bucket = bucket[0]->data_size();
-
-                // SSTables are added in increasing size order so the bucket's
-                // average might drift upwards.
-                // Don't let it drift too high, to a point where the smallest
-                // SSTable might fall out of range.
-                if (size < options.min_sstable_size || smallest_sstable_in_bucket > new_average_size * options.bucket_low) {
-                    bucket.push_back(pair.first);
-                    bucket_average_size = new_average_size;
-                    continue;
-                }
-            }
-        }
-
-        // no similar bucket found; put it in a new one
-        bucket_type new_bucket = {pair.first};
-        bucket_list.push_back(std::move(new_bucket));
-        bucket_average_size_list.push_back(size);
-    }
-
-    return bucket_list;
+    return bucket_by_size(sstables, [] (const sstables::shared_sstable& sst) {
+        auto sstable_size = sst->data_size();
+        assert(sstable_size != 0);
+        return sstable_size;
+    }, options);
 }
 
 std::vector<std::vector<sstables::shared_sstable>>
@@ -89,15 +89,71 @@ class size_tiered_compaction_strategy_options {
     }
 #endif
     friend class size_tiered_compaction_strategy;
+    friend class incremental_compaction_strategy;
 };
 
 class size_tiered_compaction_strategy : public compaction_strategy_impl {
+public:
+    // Groups items of similar size into buckets, size_of(item) returning the size of an item.
+    template <typename T, typename SizeFunc>
+    static std::vector<std::vector<T>> bucket_by_size(const std::vector<T>& items, SizeFunc size_of, const size_tiered_compaction_strategy_options& options) {
+        // items sorted by size.
+        std::vector<std::pair<T, uint64_t>> sorted_items;
+        sorted_items.reserve(items.size());
+        for (auto& item : items) {
+            sorted_items.emplace_back(item, size_of(item));
+        }
+
+        std::sort(sorted_items.begin(), sorted_items.end(), [] (auto& i, auto& j) {
+            return i.second < j.second;
+        });
+
+        using bucket_type = std::vector<T>;
+        std::vector<bucket_type> bucket_list;
+        std::vector<double> bucket_average_size_list;
+        std::vector<uint64_t> bucket_smallest_size_list;
+
+        for (auto& pair : sorted_items) {
+            size_t size = pair.second;
+
+            // look for a bucket containing similar-sized files:
+            // group in the same bucket if it's w/in (bucket_low, bucket_high) of the average for this bucket,
+            // or this file and the bucket are all considered "small" (less than `minSSTableSize`)
+            if (!bucket_list.empty()) {
+                auto& bucket_average_size = bucket_average_size_list.back();
+
+                if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                        (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                    auto& bucket = bucket_list.back();
+                    auto total_size = bucket.size() * bucket_average_size;
+                    auto new_average_size = (total_size + size) / (bucket.size() + 1);
+                    auto smallest_sstable_in_bucket = bucket_smallest_size_list.back();
+
+                    // SSTables are added in increasing size order so the bucket's
+                    // average might drift upwards.
+                    // Don't let it drift too high, to a point where the smallest
+                    // SSTable might fall out of range.
+                    if (size < options.min_sstable_size || smallest_sstable_in_bucket > new_average_size * options.bucket_low) {
+                        bucket.push_back(std::move(pair.first));
+                        bucket_average_size = new_average_size;
+                        continue;
+                    }
+                }
+            }
+
+            // no similar bucket found; put it in a new one
+            bucket_type new_bucket = {std::move(pair.first)};
+            bucket_list.push_back(std::move(new_bucket));
+            bucket_average_size_list.push_back(size);
+            bucket_smallest_size_list.push_back(size);
+        }
+
+        return bucket_list;
+    }
+private:
     size_tiered_compaction_strategy_options _options;
     compaction_backlog_tracker _backlog_tracker;
 
-    // Return a list of pair of shared_sstable and its respective size.
-    static std::vector<std::pair<sstables::shared_sstable, uint64_t>> create_sstable_and_length_pairs(const std::vector<sstables::shared_sstable>& sstables);
-
     // Group files of similar size into buckets.
     static std::vector<std::vector<sstables::shared_sstable>> get_buckets(const std::vector<sstables::shared_sstable>& sstables, size_tiered_compaction_strategy_options options);
 
@@ -73,6 +73,18 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+std::unique_ptr<compression_dictionary> compressor::train_dictionary(const std::vector<bytes_view>&, size_t) const {
+    throw std::runtime_error(name() + " does not support dictionaries");
+}
+
+std::unique_ptr<compression_dictionary> compressor::make_dictionary(bytes) const {
+    throw std::runtime_error(name() + " does not support dictionaries");
+}
+
+shared_ptr<compressor> compressor::with_dictionary(const compression_dictionary&) const {
+    throw std::runtime_error(name() + " does not support dictionaries");
+}
+
 compressor::ptr_type compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
@@ -23,12 +23,30 @@
 
 #include <map>
 #include <set>
+#include <memory>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
 #include "exceptions/exceptions.hh"
+#include "bytes.hh"
+
+/**
+ * A dictionary trained for a compressor, prepared for its use.
+ * It is immutable, so it can be used by many compressors at a time,
+ * on any shard.
+ */
+class compression_dictionary {
+public:
+    virtual ~compression_dictionary() {}
+
+    /**
+     * The dictionary as it was trained, to be stored.
+     */
+    virtual bytes_view content() const = 0;
+};
 
 
 class compressor {
@@ -64,6 +82,29 @@ class compressor {
      */
     virtual std::map<sstring, sstring> options() const;
 
+    /**
+     * Returns true if the compressor can compress with a trained dictionary.
+     */
+    virtual bool supports_dictionary() const {
+        return false;
+    }
+    /**
+     * Trains a dictionary of at most max_size bytes from samples of the data
+     * to compress. Returns nullptr if the samples are not enough to train one.
+     * Runs on the reactor without preemption, so callers bound the samples.
+     */
+    virtual std::unique_ptr<compression_dictionary> train_dictionary(const std::vector<bytes_view>& samples, size_t max_size) const;
+    /**
+     * Prepares a dictionary previously trained by train_dictionary().
+     */
+    virtual std::unique_ptr<compression_dictionary> make_dictionary(bytes content) const;
+    /**
+     * Returns a compressor with the same options as this one which compresses
+     * and uncompresses with the given dictionary. The dictionary must have
+     * been made by the same kind of compressor, and must outlive the result.
+     */
+    virtual shared_ptr<compressor> with_dictionary(const compression_dictionary&) const;
+
     /**
      * Compressor class name.
      */
@@ -379,6 +379,7 @@ scylla_tests = set([
     'test/boost/auth_test',
     'test/boost/batchlog_manager_test',
     'test/boost/big_decimal_test',
+    'test/boost/bloom_filter_test',
     'test/boost/broken_sstable_test',
     'test/boost/bytes_ostream_test',
     'test/boost/cache_flat_mutation_reader_test',
@@ -399,6 +400,7 @@ scylla_tests = set([
     'test/boost/compress_test',
     'test/boost/config_test',
     'test/boost/continuous_data_consumer_test',
+    'test/boost/coordinator_result_cache_test',
     'test/boost/counter_test',
     'test/boost/cql_auth_query_test',
     'test/boost/cql_auth_syntax_test',
@@ -461,10 +463,13 @@ scylla_tests = set([
     'test/boost/query_processor_test',
     'test/boost/range_test',
     'test/boost/range_tombstone_list_test',
+    'test/boost/repair_hash_sketch_test',
+    'test/boost/repair_range_digest_cache_test',
     'test/boost/reusable_buffer_test',
     'test/boost/restrictions_test',
     'test/boost/role_manager_test',
     'test/boost/row_cache_test',
+    'test/boost/rpc_compression_test',
     'test/boost/schema_change_test',
     'test/boost/schema_registry_test',
     'test/boost/secondary_index_test',
@@ -549,6 +554,7 @@ scylla_tests = set([
 perf_tests = set([
     'test/perf/perf_mutation_readers',
     'test/perf/perf_checksum',
+    'test/perf/perf_bloom_filter',
     'test/perf/perf_mutation_fragment',
     'test/perf/perf_idl',
     'test/perf/perf_vint',
@@ -727,6 +733,7 @@ scylla_core = (['database.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
                 'compaction/time_window_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
                 'sstables/prepended_input_stream.cc',
@@ -758,6 +765,7 @@ scylla_core = (['database.cc',
                 'cql3/sets.cc',
                 'cql3/maps.cc',
                 'cql3/values.cc',
+                'cql3/expr/compiled_filter.cc',
                 'cql3/expr/expression.cc',
                 'cql3/expr/prepare_expr.cc',
                 'cql3/functions/user_function.cc',
@@ -834,6 +842,8 @@ scylla_core = (['database.cc',
                 'service/priority_manager.cc',
                 'service/migration_manager.cc',
                 'service/storage_proxy.cc',
+                'service/forward_service.cc',
+                'service/coordinator_result_cache.cc',
                 'service/paxos/proposal.cc',
                 'service/paxos/prepare_response.cc',
                 'service/paxos/paxos_state.cc',
@@ -885,6 +895,7 @@ scylla_core = (['database.cc',
                 'db/view/row_locking.cc',
                 'db/sstables-format-selector.cc',
                 'db/snapshot-ctl.cc',
+                'db/saved_caches.cc',
                 'index/secondary_index_manager.cc',
                 'index/secondary_index.cc',
                 'utils/UUID_gen.cc',
@@ -934,6 +945,7 @@ scylla_core = (['database.cc',
                 'locator/ec2_multi_region_snitch.cc',
                 'locator/gce_snitch.cc',
                 'message/messaging_service.cc',
+                'message/rpc_compression.cc',
                 'service/client_state.cc',
                 'service/storage_service.cc',
                 'service/misc_services.cc',
@@ -963,6 +975,8 @@ scylla_core = (['database.cc',
                 'lister.cc',
                 'repair/repair.cc',
                 'repair/row_level.cc',
+                'repair/hash_sketch.cc',
+                'repair/range_digest_cache.cc',
                 'exceptions/exceptions.cc',
                 'auth/allow_all_authenticator.cc',
                 'auth/allow_all_authorizer.cc',
@@ -994,6 +1008,7 @@ scylla_core = (['database.cc',
                 'duration.cc',
                 'vint-serialization.cc',
                 'utils/arch/powerpc/crc32-vpmsum/crc32_wrapper.cc',
+                'utils/arch/x86/crc32-clmul.cc',
                 'querier.cc',
                 'mutation_writer/multishard_writer.cc',
                 'multishard_mutation_query.cc',
@@ -1121,6 +1136,7 @@ idls = ['idl/gossip_digest.idl.hh',
         'idl/raft.idl.hh',
         'idl/group0.idl.hh',
         'idl/hinted_handoff.idl.hh',
+        'idl/forward_request.idl.hh',
         ]
 
 headers = find_headers('.', excluded_dirs=['idl', 'build', 'seastar', '.git'])
@@ -1180,6 +1196,8 @@ pure_boost_tests = set([
     'test/boost/observable_test',
     'test/boost/range_test',
     'test/boost/range_tombstone_list_test',
+    'test/boost/repair_hash_sketch_test',
+    'test/boost/repair_range_digest_cache_test',
     'test/boost/serialization_test',
     'test/boost/small_vector_test',
     'test/boost/top_k_test',
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cql3/expr/compiled_filter.hh"
+#include "cql3/selection/selection.hh"
+#include "utils/fragment_range.hh"
+
+namespace cql3 {
+
+namespace expr {
+
+namespace {
+
+using cql3::selection::selection;
+
+bool compare(int64_t lhs, oper_t op, int64_t rhs) {
+    switch (op) {
+    case oper_t::EQ:
+        return lhs == rhs;
+    case oper_t::NEQ:
+        return lhs != rhs;
+    case oper_t::LT:
+        return lhs < rhs;
+    case oper_t::LTE:
+        return lhs <= rhs;
+    case oper_t::GT:
+        return lhs > rhs;
+    case oper_t::GTE:
+        return lhs >= rhs;
+    default:
+        throw std::logic_error(format("compiled_filter: compare() called on non-compare op {}", op));
+    }
+}
+
+} // anonymous namespace
+
+size_t compiled_filter::width_of(value_kind kind) {
+    switch (kind) {
+    case value_kind::int32:
+        return sizeof(int32_t);
+    case value_kind::int64:
+        return sizeof(int64_t);
+    case value_kind::uuid:
+        return 2 * sizeof(int64_t);
+    }
+    abort();
+}
+
+std::optional<compiled_filter::value_kind> compiled_filter::fixed_width_kind(const abstract_type& type, oper_t op) {
+    switch (type.get_kind()) {
+    case abstract_type::kind::int32:
+        return value_kind::int32;
+    case abstract_type::kind::long_kind:
+    case abstract_type::kind::timestamp:
+        return value_kind::int64;
+    case abstract_type::kind::uuid:
+    case abstract_type::kind::timeuuid:
+        // Uuids don't sort in the order of their bytes.
+        if (op == oper_t::EQ || op == oper_t::NEQ) {
+            return value_kind::uuid;
+        }
+        return std::nullopt;
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<compiled_filter::fixed_width_comparison> compiled_filter::lower(const expression& e, const selection& sel, const query_options& options) {
+    auto opr = as_if<binary_operator>(&e);
+    if (!opr || !is_compare(opr->op)) {
+        return std::nullopt;
+    }
+    auto cv = as_if<column_value>(&opr->lhs);
+    if (!cv || cv->sub) {
+        return std::nullopt;
+    }
+    auto kind = fixed_width_kind(cv->col->type->without_reversed(), opr->op);
+    if (!kind) {
+        return std::nullopt;
+    }
+    size_t index = cv->col->id;
+    if (!cv->col->is_primary_key()) {
+        auto i = sel.index_of(*cv->col);
+        if (i < 0) {
+            return std::nullopt;
+        }
+        index = i;
+    }
+    managed_bytes_opt rhs;
+    try {
+        rhs = evaluate(opr->rhs, options).value.to_managed_bytes_opt();
+    } catch (...) {
+        // Leave it to is_satisfied_by(), which fails only when given a row.
+        return std::nullopt;
+    }
+    // A null or empty value doesn't compare like the values of the type.
+    if (!rhs || rhs->size() != width_of(*kind)) {
+        return std::nullopt;
+    }
+    fixed_width_comparison c{cv->col, index, *kind, opr->op, 0, 0, e};
+    auto v = managed_bytes_view(*rhs);
+    switch (*kind) {
+    case value_kind::int32:
+        c.rhs = read_simple_exactly<int32_t>(v);
+        break;
+    case value_kind::int64:
+        c.rhs = read_simple_exactly<int64_t>(v);
+        break;
+    case value_kind::uuid:
+        c.rhs = read_simple<int64_t>(v);
+        c.rhs_lsb = read_simple<int64_t>(v);
+        break;
+    }
+    return c;
+}
+
+compiled_filter::compiled_filter(const expression& restr, const selection& sel, const query_options& options) {
+    auto add = [&] (const expression& e) {
+        if (auto c = lower(e, sel, options)) {
+            _comparisons.push_back(std::move(*c));
+        } else {
+            _rest.push_back(e);
+        }
+    };
+    if (auto conj = as_if<conjunction>(&restr)) {
+        for (auto& child : conj->children) {
+            add(child);
+        }
+    } else {
+        add(restr);
+    }
+}
+
+bool compiled_filter::is_satisfied_by(const fixed_width_comparison& c,
+        const std::vector<bytes>& partition_key, const std::vector<bytes>& clustering_key,
+        const std::vector<managed_bytes_opt>& non_pk_values,
+        const selection& sel, const query_options& options) const {
+    managed_bytes_view v;
+    switch (c.col->kind) {
+    case column_kind::partition_key:
+        v = managed_bytes_view(bytes_view(partition_key[c.index]));
+        break;
+    case column_kind::clustering_key:
+        if (c.index >= clustering_key.size()) {
+            return false;
+        }
+        v = managed_bytes_view(bytes_view(clustering_key[c.index]));
+        break;
+    default:
+        if (!non_pk_values[c.index]) {
+            // Same as is_satisfied_by(): a null is equal to nothing.
+            return c.op == oper_t::NEQ;
+        }
+        v = managed_bytes_view(*non_pk_values[c.index]);
+        break;
+    }
+    if (v.size() != width_of(c.kind)) {
+        return expr::is_satisfied_by(c.restriction, partition_key, clustering_key, non_pk_values, sel, options);
+    }
+    switch (c.kind) {
+    case value_kind::int32:
+        return compare(read_simple_exactly<int32_t>(v), c.op, c.rhs);
+    case value_kind::int64:
+        return compare(read_simple_exactly<int64_t>(v), c.op, c.rhs);
+    case value_kind::uuid: {
+        auto msb = read_simple<int64_t>(v);
+        auto lsb = read_simple<int64_t>(v);
+        return (msb == c.rhs && lsb == c.rhs_lsb) == (c.op == oper_t::EQ);
+    }
+    }
+    abort();
+}
+
+bool compiled_filter::is_satisfied_by(
+        const std::vector<bytes>& partition_key, const std::vector<bytes>& clustering_key,
+        const std::vector<managed_bytes_opt>& non_pk_values,
+        const selection& sel, const query_options& options) const {
+    for (auto& c : _comparisons) {
+        if (!is_satisfied_by(c, partition_key, clustering_key, non_pk_values, sel, options)) {
+            return false;
+        }
+    }
+    for (auto& e : _rest) {
+        if (!expr::is_satisfied_by(e, partition_key, clustering_key, non_pk_values, sel, options)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace expr
+
+} // namespace cql3
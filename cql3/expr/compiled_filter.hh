@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "cql3/expr/expression.hh"
+#include "utils/managed_bytes.hh"
+
+namespace cql3 {
+
+namespace expr {
+
+/// A restriction lowered, for the values bound by given query options, into
+/// a form that is cheaper to evaluate over many rows than the restriction.
+///
+/// The comparisons of columns of fixed-width types (int, bigint, timestamp
+/// and, for equality, uuid and timeuuid) with a value are lowered into
+/// comparisons of native integers against the value, decoded once when the
+/// filter is compiled, instead of being done by the type of the column on
+/// serialized values, with the right hand side evaluated for every row.
+/// The rest of the restriction is evaluated by is_satisfied_by().
+class compiled_filter {
+    enum class value_kind : uint8_t {
+        int32,
+        int64,
+        uuid,
+    };
+    struct fixed_width_comparison {
+        const column_definition* col;
+        // Position of the column in the values of the row it is found in
+        size_t index;
+        value_kind kind;
+        oper_t op;
+        // The value compared with: the integer or the two halves of the uuid
+        int64_t rhs;
+        int64_t rhs_lsb;
+        // For values of a width other than the one of the type, i.e. empty ones
+        expression restriction;
+    };
+    std::vector<fixed_width_comparison> _comparisons;
+    std::vector<expression> _rest;
+private:
+    static size_t width_of(value_kind);
+    static std::optional<value_kind> fixed_width_kind(const abstract_type&, oper_t);
+    static std::optional<fixed_width_comparison> lower(const expression&, const selection::selection&, const query_options&);
+    bool is_satisfied_by(const fixed_width_comparison& c,
+            const std::vector<bytes>& partition_key, const std::vector<bytes>& clustering_key,
+            const std::vector<managed_bytes_opt>& non_pk_values,
+            const selection::selection&, const query_options&) const;
+public:
+    compiled_filter(const expression& restr, const selection::selection&, const query_options&);
+
+    /// Same as expr::is_satisfied_by() for the restriction compiled, and the
+    /// same query options.
+    bool is_satisfied_by(
+            const std::vector<bytes>& partition_key, const std::vector<bytes>& clustering_key,
+            const std::vector<managed_bytes_opt>& non_pk_values,
+            const selection::selection&, const query_options&) const;
+
+    /// Number of the comparisons of the restriction which were lowered.
+    size_t lowered_comparisons() const {
+        return _comparisons.size();
+    }
+};
+
+} // namespace expr
+
+} // namespace cql3
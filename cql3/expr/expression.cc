@@ -350,31 +350,6 @@ managed_bytes_opt next_value(query::result_row_view::iterator_type& iter, const
     return std::nullopt;
 }
 
-/// Returns values of non-primary-key columns from selection.  The kth element of the result
-/// corresponds to the kth column in selection.
-std::vector<managed_bytes_opt> get_non_pk_values(const selection& selection, const query::result_row_view& static_row,
-                                         const query::result_row_view* row) {
-    const auto& cols = selection.get_columns();
-    std::vector<managed_bytes_opt> vals(cols.size());
-    auto static_row_iterator = static_row.iterator();
-    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
-    for (size_t i = 0; i < cols.size(); ++i) {
-        switch (cols[i]->kind) {
-        case column_kind::static_column:
-            vals[i] = next_value(static_row_iterator, cols[i]);
-            break;
-        case column_kind::regular_column:
-            if (row) {
-                vals[i] = next_value(*row_iterator, cols[i]);
-            }
-            break;
-        default: // Skip.
-            break;
-        }
-    }
-    return vals;
-}
-
 /// True iff cv matches the CQL LIKE pattern.
 bool like(const column_value& cv, const raw_value_view& pattern, const column_value_eval_bag& bag) {
     if (!cv.col->type->is_string()) {
@@ -639,6 +614,31 @@ static constexpr bool inclusive = true, exclusive = false;
 
 } // anonymous namespace
 
+/// Returns values of non-primary-key columns from selection.  The kth element of the result
+/// corresponds to the kth column in selection.
+std::vector<managed_bytes_opt> get_non_pk_values(const selection& selection, const query::result_row_view& static_row,
+                                         const query::result_row_view* row) {
+    const auto& cols = selection.get_columns();
+    std::vector<managed_bytes_opt> vals(cols.size());
+    auto static_row_iterator = static_row.iterator();
+    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
+    for (size_t i = 0; i < cols.size(); ++i) {
+        switch (cols[i]->kind) {
+        case column_kind::static_column:
+            vals[i] = next_value(static_row_iterator, cols[i]);
+            break;
+        case column_kind::regular_column:
+            if (row) {
+                vals[i] = next_value(*row_iterator, cols[i]);
+            }
+            break;
+        default: // Skip.
+            break;
+        }
+    }
+    return vals;
+}
+
 expression make_conjunction(expression a, expression b) {
     auto children = explode_conjunction(std::move(a));
     boost::copy(explode_conjunction(std::move(b)), back_inserter(children));
@@ -655,6 +655,15 @@ bool is_satisfied_by(
             restr, {options, row_data_from_partition_slice{partition_key, clustering_key, regulars, selection}});
 }
 
+bool is_satisfied_by(
+        const expression& restr,
+        const std::vector<bytes>& partition_key, const std::vector<bytes>& clustering_key,
+        const std::vector<managed_bytes_opt>& non_pk_values,
+        const selection& selection, const query_options& options) {
+    return is_satisfied_by(
+            restr, {options, row_data_from_partition_slice{partition_key, clustering_key, non_pk_values, selection}});
+}
+
 template<typename T>
 nonwrapping_range<std::remove_cvref_t<T>> to_range(oper_t op, T&& val) {
     using U = std::remove_cvref_t<T>;
@@ -417,6 +417,18 @@ extern bool is_satisfied_by(
         const query::result_row_view& static_row, const query::result_row_view* row,
         const selection::selection&, const query_options&);
 
+/// Returns values of non-primary-key columns from selection.  The kth element of the result
+/// corresponds to the kth column in selection.
+extern std::vector<managed_bytes_opt> get_non_pk_values(
+        const selection::selection&, const query::result_row_view& static_row, const query::result_row_view* row);
+
+/// Same as above, for a row whose non-primary-key values were already obtained with get_non_pk_values().
+extern bool is_satisfied_by(
+        const expression& restr,
+        const std::vector<bytes>& partition_key, const std::vector<bytes>& clustering_key,
+        const std::vector<managed_bytes_opt>& non_pk_values,
+        const selection::selection&, const query_options&);
+
 /// A set of discrete values.
 using value_list = std::vector<managed_bytes>; // Sorted and deduped using value comparator.
 
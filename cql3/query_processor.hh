@@ -60,6 +60,7 @@
 namespace service {
 class migration_manager;
 class query_state;
+class forward_service;
 }
 
 namespace cql3 {
@@ -119,6 +120,7 @@ class query_processor {
 private:
     std::unique_ptr<migration_subscriber> _migration_subscriber;
     service::storage_proxy& _proxy;
+    service::forward_service& _forwarder;
     database& _db;
     service::migration_notifier& _mnotifier;
     service::migration_manager& _mm;
@@ -157,7 +159,7 @@ class query_processor {
     static std::unique_ptr<statements::raw::parsed_statement> parse_statement(const std::string_view& query);
     static std::vector<std::unique_ptr<statements::raw::parsed_statement>> parse_statements(std::string_view queries);
 
-    query_processor(service::storage_proxy& proxy, database& db, service::migration_notifier& mn, service::migration_manager& mm, memory_config mcfg, cql_config& cql_cfg);
+    query_processor(service::storage_proxy& proxy, service::forward_service& forwarder, database& db, service::migration_notifier& mn, service::migration_manager& mm, memory_config mcfg, cql_config& cql_cfg);
 
     ~query_processor();
 
@@ -173,6 +175,10 @@ class query_processor {
         return _proxy;
     }
 
+    service::forward_service& forwarder() {
+        return _forwarder;
+    }
+
     const service::migration_manager& get_migration_manager() const noexcept { return _mm; }
     service::migration_manager& get_migration_manager() noexcept { return _mm; }
 
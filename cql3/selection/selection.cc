@@ -457,65 +457,40 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
                 partition_key, clustering_key, static_row, row, selection, _options);
     }
 
-    auto static_row_iterator = static_row.iterator();
-    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
-    auto non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
-    for (auto&& cdef : selection.get_columns()) {
+    if (!_column_filters) {
+        compile(selection);
+    }
+    // Extracted once for all the restrictions, rather than by each.
+    std::vector<managed_bytes_opt> non_pk_values;
+    if (_filters_non_pk_columns) {
+        non_pk_values = expr::get_non_pk_values(selection, static_row, row);
+    }
+    for (auto&& [cdef, filter] : *_column_filters) {
         switch (cdef->kind) {
         case column_kind::static_column:
             // fallthrough
-        case column_kind::regular_column: {
-            if (cdef->kind == column_kind::regular_column && !row_iterator) {
-                continue;
-            }
-            auto restr_it = non_pk_restrictions_map.find(cdef);
-            if (restr_it == non_pk_restrictions_map.end()) {
+        case column_kind::regular_column:
+            if (cdef->kind == column_kind::regular_column && !row) {
                 continue;
             }
-            restrictions::single_column_restriction& restriction = *restr_it->second;
-            bool regular_restriction_matches = expr::is_satisfied_by(
-                    restriction.expression, partition_key, clustering_key, static_row, row, selection, _options);
-            if (!regular_restriction_matches) {
+            if (!filter.is_satisfied_by(partition_key, clustering_key, non_pk_values, selection, _options)) {
                 _current_static_row_does_not_match = (cdef->kind == column_kind::static_column);
                 return false;
             }
-            }
             break;
-        case column_kind::partition_key: {
-            if (_skip_pk_restrictions) {
-                continue;
-            }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
-            auto restr_it = partition_key_restrictions_map.find(cdef);
-            if (restr_it == partition_key_restrictions_map.end()) {
-                continue;
-            }
-            restrictions::single_column_restriction& restriction = *restr_it->second;
-            if (!expr::is_satisfied_by(
-                        restriction.expression, partition_key, clustering_key, static_row, row, selection, _options)) {
+        case column_kind::partition_key:
+            if (!filter.is_satisfied_by(partition_key, clustering_key, non_pk_values, selection, _options)) {
                 _current_partition_key_does_not_match = true;
                 return false;
             }
-            }
             break;
-        case column_kind::clustering_key: {
-            if (_skip_ck_restrictions) {
-                continue;
-            }
-            auto clustering_key_restrictions_map = _restrictions->get_single_column_clustering_key_restrictions();
-            auto restr_it = clustering_key_restrictions_map.find(cdef);
-            if (restr_it == clustering_key_restrictions_map.end()) {
-                continue;
-            }
+        case column_kind::clustering_key:
             if (clustering_key.empty()) {
                 return false;
             }
-            restrictions::single_column_restriction& restriction = *restr_it->second;
-            if (!expr::is_satisfied_by(
-                        restriction.expression, partition_key, clustering_key, static_row, row, selection, _options)) {
+            if (!filter.is_satisfied_by(partition_key, clustering_key, non_pk_values, selection, _options)) {
                 return false;
             }
-            }
             break;
         default:
             break;
@@ -524,6 +499,43 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
     return true;
 }
 
+void result_set_builder::restrictions_filter::compile(const selection& selection) const {
+    _column_filters.emplace();
+    const auto& non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
+    const auto& partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
+    const auto& clustering_key_restrictions_map = _restrictions->get_single_column_clustering_key_restrictions();
+    auto add = [&] (const column_definition* cdef, const auto& restrictions_map) {
+        auto restr_it = restrictions_map.find(cdef);
+        if (restr_it != restrictions_map.end()) {
+            _column_filters->push_back({cdef, expr::compiled_filter(restr_it->second->expression, selection, _options)});
+        }
+    };
+    for (auto&& cdef : selection.get_columns()) {
+        switch (cdef->kind) {
+        case column_kind::static_column:
+            // fallthrough
+        case column_kind::regular_column:
+            add(cdef, non_pk_restrictions_map);
+            break;
+        case column_kind::partition_key:
+            if (!_skip_pk_restrictions) {
+                add(cdef, partition_key_restrictions_map);
+            }
+            break;
+        case column_kind::clustering_key:
+            if (!_skip_ck_restrictions) {
+                add(cdef, clustering_key_restrictions_map);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    _filters_non_pk_columns = boost::algorithm::any_of(*_column_filters, [] (const column_filter& f) {
+        return !f.cdef->is_primary_key();
+    });
+}
+
 bool result_set_builder::restrictions_filter::operator()(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
                                                          const std::vector<bytes>& clustering_key,
@@ -46,6 +46,7 @@
 #include "query-result-reader.hh"
 #include "cql3/column_specification.hh"
 #include "cql3/selection/selector.hh"
+#include "cql3/expr/compiled_filter.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
 #include <seastar/core/thread.hh>
@@ -254,6 +255,14 @@ class result_set_builder {
         mutable uint64_t _rows_fetched_for_last_partition;
         mutable std::optional<partition_key> _last_pkey;
         mutable bool _is_first_partition_on_page = true;
+        // The restrictions to check, in the order of the columns of the selection,
+        // compiled on the first row since they depend on it.
+        struct column_filter {
+            const column_definition* cdef;
+            expr::compiled_filter filter;
+        };
+        mutable std::optional<std::vector<column_filter>> _column_filters;
+        mutable bool _filters_non_pk_columns = false;
     public:
         explicit restrictions_filter(::shared_ptr<restrictions::statement_restrictions> restrictions,
                 const query_options& options,
@@ -268,6 +277,7 @@ class result_set_builder {
             return _rows_dropped;
         }
     private:
+        void compile(const selection& selection) const;
         bool do_filter(const selection& selection, const std::vector<bytes>& pk, const std::vector<bytes>& ck, const query::result_row_view& static_row, const query::result_row_view* row) const;
     };
 
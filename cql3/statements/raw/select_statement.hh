@@ -46,6 +46,7 @@
 #include "cql3/relation.hh"
 #include "cql3/attributes.hh"
 #include "db/config.hh"
+#include "query-request.hh"
 #include <seastar/core/shared_ptr.hh>
 
 namespace cql3 {
@@ -163,6 +164,11 @@ class select_statement : public cf_statement
     /// Returns indices of GROUP BY cells in fetched rows.
     std::vector<size_t> prepare_group_by(const schema& schema, selection::selection& selection) const;
 
+    /// Returns the aggregations to be computed by the replicas if the query is
+    /// a full-scan aggregation which can be parallelized, nullopt otherwise.
+    std::optional<std::vector<query::forward_request::aggregation_info>> get_parallelizable_aggregations(const schema& schema,
+            const restrictions::statement_restrictions& restrictions, bool for_view) const;
+
     bool contains_alias(const column_identifier& name) const;
 
     lw_shared_ptr<column_specification> limit_receiver(bool per_partition = false);
@@ -48,6 +48,7 @@
 #include "cql3/util.hh"
 #include "cql3/restrictions/single_column_primary_key_restrictions.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
+#include "cql3/restrictions/multi_column_restriction.hh"
 #include "cql3/selection/selector_factories.hh"
 #include "validation.hh"
 #include "exceptions/unrecognized_entity_exception.hh"
@@ -56,6 +57,9 @@
 #include "query_result_merger.hh"
 #include "service/pager/query_pagers.hh"
 #include "service/storage_proxy.hh"
+#include "service/forward_service.hh"
+#include "gms/feature_service.hh"
+#include "cql3/functions/aggregate_fcts.hh"
 #include <seastar/core/execution_stage.hh>
 #include "view_info.hh"
 #include "partition_slice_builder.hh"
@@ -63,8 +67,11 @@
 #include "db/timeout_clock.hh"
 #include "db/consistency_level_validations.hh"
 #include "database.hh"
+#include "utils/fb_utilities.hh"
 #include "test/lib/select_statement_utils.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/range/adaptor/map.hpp>
 
 bool is_internal_keyspace(std::string_view name);
 
@@ -251,6 +258,67 @@ select_statement::make_partition_slice(const query_options& options) const
         std::move(static_columns), std::move(regular_columns), _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
 }
 
+static std::optional<query::row_filter_op> to_row_filter_op(expr::oper_t op) {
+    switch (op) {
+    case expr::oper_t::EQ:
+        return query::row_filter_op::eq;
+    case expr::oper_t::LT:
+        return query::row_filter_op::lt;
+    case expr::oper_t::LTE:
+        return query::row_filter_op::lte;
+    case expr::oper_t::GT:
+        return query::row_filter_op::gt;
+    case expr::oper_t::GTE:
+        return query::row_filter_op::gte;
+    default:
+        return std::nullopt;
+    }
+}
+
+void select_statement::add_row_filters(query::partition_slice& slice, const query_options& options) const {
+    // The rows which don't satisfy the row filters are returned with null
+    // cells, which none of the comparisons added is satisfied by, so that
+    // restrictions_filter drops them. Except that it only checks the
+    // clustering restrictions when they are multi-column.
+    if (dynamic_pointer_cast<restrictions::multi_column_restriction>(_restrictions->get_clustering_columns_restrictions())) {
+        return;
+    }
+    for (auto&& [cdef, restriction] : _restrictions->get_non_pk_restriction()) {
+        if (!cdef->is_regular() || !cdef->is_atomic() || cdef->is_counter()
+                || !boost::algorithm::any_of_equal(slice.regular_columns, cdef->id)) {
+            continue;
+        }
+        auto add = [&, cdef = cdef] (const expr::expression& e) {
+            auto opr = expr::as_if<expr::binary_operator>(&e);
+            if (!opr) {
+                return;
+            }
+            auto cv = expr::as_if<expr::column_value>(&opr->lhs);
+            auto op = to_row_filter_op(opr->op);
+            if (!cv || cv->sub || !op) {
+                return;
+            }
+            bytes_opt value;
+            try {
+                value = to_bytes_opt(expr::evaluate(opr->rhs, options).value);
+            } catch (...) {
+                // Left to the filter of the results to fail.
+                return;
+            }
+            if (value) {
+                slice.row_filters.push_back({cdef->id, *op, std::move(*value)});
+            }
+        };
+        if (auto conj = expr::as_if<expr::conjunction>(&restriction->expression)) {
+            for (auto& child : conj->children) {
+                add(child);
+            }
+        } else {
+            add(restriction->expression);
+        }
+    }
+}
+
 uint64_t select_statement::do_get_limit(const query_options& options,
                                         const std::optional<expr::expression>& limit,
                                         uint64_t default_limit) const {
@@ -328,6 +396,9 @@ select_statement::do_execute(service::storage_proxy& proxy,
     _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
 
     auto slice = make_partition_slice(options);
+    if (restrictions_need_filtering && proxy.features().cluster_supports_partition_slice_row_filters()) {
+        add_row_filters(slice, options);
+    }
     auto command = ::make_lw_shared<query::read_command>(
             _schema->id(),
             _schema->version(),
@@ -493,6 +564,9 @@ lw_shared_ptr<query::read_command>
 indexed_table_select_statement::prepare_command_for_base_query(service::storage_proxy& proxy, const query_options& options,
         service::query_state& state, gc_clock::time_point now, bool use_paging) const {
     auto slice = make_partition_slice(options);
+    if (_restrictions->need_filtering() && proxy.features().cluster_supports_partition_slice_row_filters()) {
+        add_row_filters(slice, options);
+    }
     if (use_paging) {
         slice.options.set<query::partition_slice::option::allow_short_read>();
         slice.options.set<query::partition_slice::option::send_partition_key>();
@@ -586,7 +660,7 @@ indexed_table_select_statement::do_execute_base_query(
             if (previous_result_size < query::result_memory_limiter::maximum_result_size && concurrency < max_base_table_query_concurrency) {
                 concurrency *= 2;
             }
-            return proxy.query(_schema, command, std::move(prange), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
+            return proxy.query(_schema, command, std::move(prange), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state(), {}, {}, state.get_latency_breakdown()})
             .then([is_paged, &previous_result_size, &ranges_to_vnodes, &merger] (service::storage_proxy::coordinator_query_result qr) {
                 auto is_short_read = qr.query_result->is_short_read();
                 // Results larger than 1MB should be shipped to the client immediately
@@ -674,7 +748,7 @@ indexed_table_select_statement::do_execute_base_query(
                 if (key.clustering) {
                     command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
                 }
-                return proxy.query(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
+                return proxy.query(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state(), {}, {}, state.get_latency_breakdown()})
                 .then([] (service::storage_proxy::coordinator_query_result qr) {
                     return std::move(qr.query_result);
                 });
@@ -709,6 +783,47 @@ indexed_table_select_statement::execute_base_query(
     });
 }
 
+// Whether a result was read from this node only. Only such results are
+// cached, since this node invalidates them when applying a write.
+static bool read_from_this_node_only(service::storage_proxy& proxy, const service::replicas_per_token_range& replicas) {
+    auto host_id = proxy.get_token_metadata_ptr()->get_host_id_if_known(utils::fb_utilities::get_broadcast_address());
+    return host_id && !replicas.empty() && boost::algorithm::all_of(replicas | boost::adaptors::map_values, [&host_id] (const std::vector<utils::UUID>& ids) {
+        return ids.size() == 1 && ids.front() == *host_id;
+    });
+}
+
+// The earliest expiry of the cells of a result, read with send_expiry.
+static std::optional<gc_clock::time_point> earliest_expiry(const query::result& r, const query::partition_slice& slice) {
+    struct visitor {
+        const query::partition_slice& slice;
+        std::optional<gc_clock::time_point> expiry;
+
+        void visit(const query::result_row_view& row, size_t cells) {
+            auto it = row.iterator();
+            for (size_t i = 0; i < cells; ++i) {
+                auto cell = it.next_atomic_cell();
+                if (cell && cell->expiry()) {
+                    expiry = std::min(expiry.value_or(gc_clock::time_point::max()), *cell->expiry());
+                }
+            }
+        }
+        void accept_new_partition(const partition_key&, uint64_t) {}
+        void accept_new_partition(uint64_t) {}
+        void accept_new_row(const clustering_key&, const query::result_row_view& static_row, const query::result_row_view& row) {
+            visit(row, slice.regular_columns.size());
+        }
+        void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {
+            visit(row, slice.regular_columns.size());
+        }
+        void accept_partition_end(const query::result_row_view& static_row) {
+            visit(static_row, slice.static_columns.size());
+        }
+    };
+    visitor v{slice};
+    query::result_view::consume(r, slice, v);
+    return v.expiry;
+}
+
 future<shared_ptr<cql_transport::messages::result_message>>
 select_statement::execute(service::storage_proxy& proxy,
                           lw_shared_ptr<query::read_command> cmd,
@@ -733,7 +848,7 @@ select_statement::execute(service::storage_proxy& proxy,
                         command,
                         std::move(prange),
                         options.get_consistency(),
-                        {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()}).then([] (service::storage_proxy::coordinator_query_result qr) {
+                        {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state(), {}, {}, state.get_latency_breakdown()}).then([] (service::storage_proxy::coordinator_query_result qr) {
                     return std::move(qr.query_result);
                 });
             }, std::move(merger));
@@ -741,13 +856,81 @@ select_statement::execute(service::storage_proxy& proxy,
             return this->process_results(std::move(result), cmd, options, now);
         });
     } else {
-        return proxy.query(_schema, cmd, std::move(partition_ranges), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
-            .then([this, &options, now, cmd] (service::storage_proxy::coordinator_query_result qr) {
+        auto cache_key = result_cache_key(proxy, partition_ranges, options);
+        auto& cache = proxy.get_result_cache();
+        service::coordinator_result_cache::generation_type generation = 0;
+        if (cache_key) {
+            // For the entry to expire with the earliest expiring cell.
+            cmd->slice.options.set<query::partition_slice::option::send_expiry>();
+            if (auto result = cache.find(*cache_key)) {
+                return this->process_results(make_foreign(std::move(result)), cmd, options, now);
+            }
+            generation = cache.generation(*cache_key);
+        }
+        return proxy.query(_schema, cmd, std::move(partition_ranges), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state(), {}, {}, state.get_latency_breakdown()})
+            .then([this, &proxy, &options, now, cmd, &cache, cache_key = std::move(cache_key), generation] (service::storage_proxy::coordinator_query_result qr) mutable {
+                if (cache_key && !qr.query_result->is_short_read() && read_from_this_node_only(proxy, qr.last_replicas)) {
+                    cache.insert(std::move(*cache_key), *qr.query_result, generation, earliest_expiry(*qr.query_result, cmd->slice));
+                }
                 return this->process_results(std::move(qr.query_result), cmd, options, now);
             });
     }
 }
 
+std::optional<service::coordinator_result_cache::key>
+select_statement::result_cache_key(service::storage_proxy& proxy, const dht::partition_range_vector& partition_ranges, const query_options& options) const {
+    if (!_schema->caching_options().coordinator_results() || _parameters->bypass_cache() || raw_cql_statement.empty()
+            || partition_ranges.size() != 1 || !query::is_single_partition(partition_ranges.front())) {
+        return std::nullopt;
+    }
+    // This node invalidates its cached results when applying a write, but
+    // writes don't wait for that on the other replicas. So the results may
+    // only be cached for reads which a single replica satisfies, which
+    // return whatever this replica has.
+    auto cl = options.get_consistency();
+    if (cl != db::consistency_level::ONE && cl != db::consistency_level::LOCAL_ONE) {
+        return std::nullopt;
+    }
+    // The result of ttl() changes with time, and the expiry of the cells of
+    // collections and user types isn't part of the result.
+    if (_opts.contains<query::partition_slice::option::send_expiry>()
+            || boost::algorithm::any_of(_selection->get_columns(), [] (const column_definition* def) { return def->is_multi_cell(); })) {
+        return std::nullopt;
+    }
+    auto& token = partition_ranges.front().start()->value().token();
+    if (dht::shard_of(*_schema, token) != this_shard_id()) {
+        return std::nullopt;
+    }
+    // Writes only invalidate the cached results of the replicas of their
+    // partition, synchronously (see storage_proxy).
+    auto erm = proxy.get_db().local().find_keyspace(_schema->ks_name()).get_effective_replication_map();
+    auto replicas = erm->get_natural_endpoints_without_node_being_replaced(token);
+    if (std::find(replicas.begin(), replicas.end(), utils::fb_utilities::get_broadcast_address()) == replicas.end()) {
+        return std::nullopt;
+    }
+    // The statement and its bound values determine the slice and the limits,
+    // for a given version of the schema.
+    bytes_ostream query;
+    auto write = [&query] (const auto& v) {
+        query.write(bytes_view(reinterpret_cast<const int8_t*>(&v), sizeof(v)));
+    };
+    write(_schema->version());
+    write(cl);
+    write(int32_t(raw_cql_statement.size()));
+    query.write(bytes_view(reinterpret_cast<const int8_t*>(raw_cql_statement.data()), raw_cql_statement.size()));
+    for (size_t i = 0; i < options.get_values_count(); ++i) {
+        auto v = options.get_value_at(i);
+        if (!v.is_value()) {
+            write(int32_t(v.is_null() ? -1 : -2));
+            continue;
+        }
+        auto b = to_bytes(v);
+        write(int32_t(b.size()));
+        query.write(b);
+    }
+    return service::coordinator_result_cache::key{_schema->id(), token, bytes(query.linearize())};
+}
+
 future<shared_ptr<cql_transport::messages::result_message>>
 indexed_table_select_statement::process_base_query_results(
         foreign_ptr<lw_shared_ptr<query::result>> results,
@@ -840,6 +1023,92 @@ primary_key_select_statement::primary_key_select_statement(schema_ptr schema, ui
     }
 }
 
+parallelized_select_statement::parallelized_select_statement(schema_ptr schema, uint32_t bound_terms,
+                                                             lw_shared_ptr<const parameters> parameters,
+                                                             ::shared_ptr<selection::selection> selection,
+                                                             ::shared_ptr<restrictions::statement_restrictions> restrictions,
+                                                             ::shared_ptr<std::vector<size_t>> group_by_cell_indices,
+                                                             bool is_reversed,
+                                                             ordering_comparator_type ordering_comparator,
+                                                             std::optional<expr::expression> limit,
+                                                             std::optional<expr::expression> per_partition_limit,
+                                                             cql_stats &stats,
+                                                             std::unique_ptr<attributes> attrs,
+                                                             std::vector<query::forward_request::aggregation_info> aggregations)
+    : select_statement{schema, bound_terms, parameters, selection, restrictions, group_by_cell_indices, is_reversed, ordering_comparator, std::move(limit), std::move(per_partition_limit), stats, std::move(attrs)}
+    , _aggregations(std::move(aggregations))
+{
+    if (_ks_sel == ks_selector::NONSYSTEM) {
+        _range_scan = true;
+        _range_scan_no_bypass_cache = !_parameters->bypass_cache();
+    }
+}
+
+future<shared_ptr<cql_transport::messages::result_message>>
+parallelized_select_statement::execute(query_processor& qp,
+                                       service::query_state& state,
+                                       const query_options& options) const
+{
+    service::storage_proxy& proxy = qp.proxy();
+    auto key_ranges = _restrictions->get_partition_key_ranges(options);
+
+    // Fall back to the regular, coordinator-driven execution when some node
+    // does not understand FORWARD_REQUEST, or when the query is not a scan.
+    if (!proxy.features().cluster_supports_parallelized_aggregation()
+            || db::is_serial_consistency(options.get_consistency())
+            || !options.get_cql_serialization_format().collection_format_unchanged()
+            || boost::algorithm::all_of(key_ranges, query::is_single_partition)) {
+        return select_statement::execute(qp, state, options);
+    }
+
+    tracing::add_table_name(state.get_trace_state(), keyspace(), column_family());
+
+    auto cl = options.get_consistency();
+    validate_for_read(cl);
+
+    auto now = gc_clock::now();
+
+    const source_selector src_sel = state.get_client_state().is_internal()
+            ? source_selector::INTERNAL : source_selector::USER;
+    ++_stats.query_cnt(src_sel, _ks_sel, cond_selector::NO_CONDITIONS, statement_type::SELECT);
+
+    _stats.select_bypass_caches += _parameters->bypass_cache();
+    _stats.select_partition_range_scan += _range_scan;
+    _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
+    ++_stats.select_parallelized;
+
+    auto slice = make_partition_slice(options);
+    auto max_result_size = proxy.get_max_result_size(slice);
+    auto command = query::read_command(
+            _schema->id(),
+            _schema->version(),
+            std::move(slice),
+            max_result_size,
+            query::row_limit(query::max_rows),
+            query::partition_limit(query::max_partitions),
+            now,
+            tracing::make_trace_info(state.get_trace_state()),
+            utils::UUID(),
+            query::is_first_page::no,
+            options.get_timestamp(state));
+
+    auto timeout = db::timeout_clock::now() + get_timeout(state.get_client_state(), options);
+    query::forward_request req = {
+        .aggregations = _aggregations,
+        .cmd = std::move(command),
+        .pr = std::move(key_ranges),
+        .cl = cl,
+    };
+
+    return qp.forwarder().dispatch(std::move(req), state.get_trace_state(), timeout).then([this] (query::forward_result res) {
+        auto rs = std::make_unique<result_set>(::make_shared<metadata>(*_selection->get_result_metadata()));
+        rs->add_row(std::move(res.query_results));
+        update_stats_rows_read(rs->size());
+        auto msg = ::make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)));
+        return ::shared_ptr<cql_transport::messages::result_message>(std::move(msg));
+    });
+}
+
 ::shared_ptr<cql3::statements::select_statement>
 indexed_table_select_statement::prepare(database& db,
                                         schema_ptr schema,
@@ -1227,7 +1496,7 @@ indexed_table_select_statement::read_posting_list(service::storage_proxy& proxy,
 
     int32_t page_size = options.get_page_size();
     if (page_size <= 0 || !service::pager::query_pagers::may_need_paging(*_view_schema, page_size, *cmd, partition_ranges)) {
-        return proxy.query(_view_schema, cmd, std::move(partition_ranges), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()})
+        return proxy.query(_view_schema, cmd, std::move(partition_ranges), options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state(), {}, {}, state.get_latency_breakdown()})
         .then([this, now, &options, selection = std::move(selection), partition_slice = std::move(partition_slice)] (service::storage_proxy::coordinator_query_result qr) {
             cql3::selection::result_set_builder builder(*selection, now, options.get_cql_serialization_format());
             query::result_view::consume(*qr.query_result,
@@ -1439,6 +1708,21 @@ std::unique_ptr<prepared_statement> select_statement::prepare(database& db, cql_
                 prepare_limit(db, ctx, _per_partition_limit),
                 stats,
                 std::move(prepared_attrs));
+    } else if (auto aggregations = get_parallelizable_aggregations(*schema, *restrictions, for_view)) {
+        stmt = ::make_shared<cql3::statements::parallelized_select_statement>(
+                schema,
+                ctx.bound_variables_size(),
+                _parameters,
+                std::move(selection),
+                std::move(restrictions),
+                std::move(group_by_cell_indices),
+                is_reversed_,
+                std::move(ordering_comparator),
+                prepare_limit(db, ctx, _limit),
+                prepare_limit(db, ctx, _per_partition_limit),
+                stats,
+                std::move(prepared_attrs),
+                std::move(*aggregations));
     } else {
         stmt = ::make_shared<cql3::statements::primary_key_select_statement>(
                 schema,
@@ -1690,6 +1974,47 @@ void select_statement::ensure_filtering_columns_retrieval(database& db,
     }
 }
 
+std::optional<std::vector<query::forward_request::aggregation_info>>
+select_statement::get_parallelizable_aggregations(const schema& schema,
+        const restrictions::statement_restrictions& restrictions, bool for_view) const {
+    if (for_view || _select_clause.empty()
+            || _parameters->is_distinct() || _parameters->is_json() || !_parameters->orderings().empty()
+            || _limit || _per_partition_limit || !_group_by_columns.empty()
+            || restrictions.uses_secondary_indexing() || restrictions.need_filtering()) {
+        return std::nullopt;
+    }
+
+    std::vector<query::forward_request::aggregation_info> aggregations;
+    aggregations.reserve(_select_clause.size());
+    for (auto& raw : _select_clause) {
+        auto fc = expr::as_if<expr::function_call>(&raw->selectable_);
+        if (!fc) {
+            return std::nullopt;
+        }
+        auto name = std::get_if<functions::function_name>(&fc->func);
+        if (!name || (name->has_keyspace() && *name != functions::function_name::native_function(name->name))) {
+            return std::nullopt;
+        }
+        if (name->name == functions::aggregate_fcts::COUNT_ROWS_FUNCTION_NAME && fc->args.empty()) {
+            aggregations.push_back({name->name, {}});
+            continue;
+        }
+        if (fc->args.size() != 1) {
+            return std::nullopt;
+        }
+        auto id = expr::as_if<expr::unresolved_identifier>(&fc->args.front());
+        if (!id) {
+            return std::nullopt;
+        }
+        aggregations.push_back({name->name, {id->ident->prepare_column_identifier(schema)->text()}});
+    }
+
+    if (!service::forward_service::can_be_parallelized(schema, aggregations)) {
+        return std::nullopt;
+    }
+    return aggregations;
+}
+
 bool select_statement::contains_alias(const column_identifier& name) const {
     return std::any_of(_select_clause.begin(), _select_clause.end(), [&name] (auto raw) {
         return raw->alias && name == *raw->alias;
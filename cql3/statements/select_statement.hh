@@ -47,6 +47,8 @@
 #include <seastar/core/shared_ptr.hh>
 #include "transport/messages/result_message.hh"
 #include "index/secondary_index_manager.hh"
+#include "query-request.hh"
+#include "service/coordinator_result_cache.hh"
 
 namespace service {
     class client_state;
@@ -151,6 +153,11 @@ protected :
 
     query::partition_slice make_partition_slice(const query_options& options) const;
 
+    // Adds the restrictions on regular columns which the replicas can check
+    // to the row filters of the slice of a filtered query. Only called once
+    // the cluster supports them, see cluster_supports_partition_slice_row_filters().
+    void add_row_filters(query::partition_slice& slice, const query_options& options) const;
+
     ::shared_ptr<restrictions::statement_restrictions> get_restrictions() const;
 
     bool has_group_by() const { return _group_by_cell_indices && !_group_by_cell_indices->empty(); }
@@ -158,6 +165,10 @@ protected :
     db::timeout_clock::duration get_timeout(const service::client_state& state, const query_options& options) const;
 
 protected:
+    // Returns the key of the query in the coordinator result cache, if its
+    // result may be cached there.
+    std::optional<service::coordinator_result_cache::key> result_cache_key(service::storage_proxy& proxy,
+            const dht::partition_range_vector& partition_ranges, const query_options& options) const;
     uint64_t do_get_limit(const query_options& options, const std::optional<expr::expression>& limit, uint64_t default_limit) const;
     uint64_t get_limit(const query_options& options) const {
         return do_get_limit(options, _limit, query::max_rows);
@@ -187,6 +198,31 @@ class primary_key_select_statement : public select_statement {
                      std::unique_ptr<cql3::attributes> attrs);
 };
 
+// A full-scan aggregation (e.g. SELECT COUNT(*) FROM t) whose partial results
+// can be merged. Such a query is split into vnodes which are aggregated in
+// parallel by their replicas (see service::forward_service) instead of being
+// paged through by the coordinator alone.
+class parallelized_select_statement : public select_statement {
+    std::vector<query::forward_request::aggregation_info> _aggregations;
+public:
+    parallelized_select_statement(schema_ptr schema,
+                     uint32_t bound_terms,
+                     lw_shared_ptr<const parameters> parameters,
+                     ::shared_ptr<selection::selection> selection,
+                     ::shared_ptr<restrictions::statement_restrictions> restrictions,
+                     ::shared_ptr<std::vector<size_t>> group_by_cell_indices,
+                     bool is_reversed,
+                     ordering_comparator_type ordering_comparator,
+                     std::optional<expr::expression> limit,
+                     std::optional<expr::expression> per_partition_limit,
+                     cql_stats &stats,
+                     std::unique_ptr<cql3::attributes> attrs,
+                     std::vector<query::forward_request::aggregation_info> aggregations);
+
+    virtual future<::shared_ptr<cql_transport::messages::result_message>> execute(query_processor& qp,
+        service::query_state& state, const query_options& options) const override;
+};
+
 class indexed_table_select_statement : public select_statement {
     secondary_index::index _index;
     ::shared_ptr<restrictions::restrictions> _used_index_restrictions;
@@ -384,6 +384,7 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     assert(dbcfg.available_memory != 0); // Detect misconfigured unit tests, see #7544
 
     local_schema_registry().init(*this); // TODO: we're never unbound.
+    _read_concurrency_sem.set_fair_queuing(_cfg.read_admission_fair_queuing);
     setup_metrics();
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
@@ -468,6 +469,7 @@ void
 database::setup_metrics() {
     _dirty_memory_manager.setup_collectd("regular");
     _system_dirty_memory_manager.setup_collectd("system");
+    _read_concurrency_sem.register_metrics();
 
     namespace sm = seastar::metrics;
 
@@ -522,6 +524,9 @@ database::setup_metrics() {
                        sm::description("Counts sstables that survived the clustering key filtering. "
                                        "High value indicates that bloom filter is not very efficient and still have to access a lot of sstables to get data.")),
 
+        sm::make_derive("expired_sstables_skipped_by_reads", _cf_stats.expired_sstables_skipped_by_reads,
+                       sm::description("Counts sstables not read by single partition reads because all their data is expired and purgeable.")),
+
         sm::make_derive("dropped_view_updates", _cf_stats.dropped_view_updates,
                        sm::description("Counts the number of view updates that have been dropped due to cluster overload. ")),
 
@@ -1397,7 +1402,7 @@ compare_atomic_cell_for_merge(atomic_cell_view left, atomic_cell_view right) {
 
 future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>>
 database::query(schema_ptr s, const query::read_command& cmd, query::result_options opts, const dht::partition_range_vector& ranges,
-                tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+                tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout, tracing::latency_breakdown* latency_breakdown) {
     const auto reversed = cmd.slice.is_reversed();
     if (reversed) {
         s = s->make_reversed();
@@ -1409,18 +1414,32 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
 
     std::optional<query::data_querier> querier_opt;
     lw_shared_ptr<query::result> result;
+    tracing::latency_breakdown read_latency_breakdown;
     std::exception_ptr ex;
 
     if (cmd.query_uuid != utils::UUID{} && !cmd.is_first_page) {
         querier_opt = _querier_cache.lookup_data_querier(cmd.query_uuid, *s, ranges.front(), cmd.slice, trace_state, timeout);
     }
 
+    // The permit of a resumed read carries the breakdown of the previous pages.
+    const auto breakdown_before = querier_opt ? querier_opt->permit().latency_breakdown() : tracing::latency_breakdown();
+
     auto read_func = [&, this] (reader_permit permit) {
         reader_permit::used_guard ug{permit};
         permit.set_max_result_size(max_result_size);
-        return cf.query(std::move(s), std::move(permit), cmd, opts, ranges, trace_state, get_result_memory_limiter(),
-                timeout, &querier_opt).then([&result, ug = std::move(ug)] (lw_shared_ptr<query::result> res) {
+        if (latency_breakdown) {
+            permit.enable_latency_breakdown();
+        }
+        auto reclaim_time_before = logalloc::reclaim_time();
+        return cf.query(std::move(s), permit, cmd, opts, ranges, trace_state, get_result_memory_limiter(),
+                timeout, &querier_opt).then([&, permit, reclaim_time_before, ug = std::move(ug)] (lw_shared_ptr<query::result> res) {
             result = std::move(res);
+            auto& breakdown = permit.latency_breakdown();
+            read_latency_breakdown.admission_wait = breakdown.admission_wait - breakdown_before.admission_wait;
+            read_latency_breakdown.disk_wait = breakdown.disk_wait - breakdown_before.disk_wait;
+            read_latency_breakdown.disk_reads = breakdown.disk_reads - breakdown_before.disk_reads;
+            read_latency_breakdown.cache_misses = breakdown.cache_misses - breakdown_before.cache_misses;
+            read_latency_breakdown.lsa_reclaim = logalloc::reclaim_time() - reclaim_time_before;
         });
     };
 
@@ -1451,6 +1470,11 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
     auto hit_rate = cf.get_global_cache_hit_rate();
     ++semaphore.get_stats().total_successful_reads;
     _stats->short_data_queries += bool(result->is_short_read());
+    cf.get_stats().estimated_read_admission_wait.add(read_latency_breakdown.admission_wait);
+    if (latency_breakdown) {
+        cf.get_stats().estimated_read_disk_wait.add(read_latency_breakdown.disk_wait);
+        *latency_breakdown += read_latency_breakdown;
+    }
     co_return std::tuple(std::move(result), hit_rate);
 }
 
@@ -2363,7 +2387,7 @@ template <typename T>
 using foreign_unique_ptr = foreign_ptr<std::unique_ptr<T>>;
 
 flat_mutation_reader make_multishard_streaming_reader(distributed<database>& db, schema_ptr schema, reader_permit permit,
-        std::function<std::optional<dht::partition_range>()> range_generator) {
+        std::function<std::optional<dht::partition_range>()> range_generator, sstables::unrepaired_only unrepaired) {
     class streaming_reader_lifecycle_policy
             : public reader_lifecycle_policy
             , public enable_shared_from_this<streaming_reader_lifecycle_policy> {
@@ -2374,9 +2398,11 @@ flat_mutation_reader make_multishard_streaming_reader(distributed<database>& db,
         };
         distributed<database>& _db;
         utils::UUID _table_id;
+        sstables::unrepaired_only _unrepaired;
         std::vector<reader_context> _contexts;
     public:
-        streaming_reader_lifecycle_policy(distributed<database>& db, utils::UUID table_id) : _db(db), _table_id(table_id), _contexts(smp::count) {
+        streaming_reader_lifecycle_policy(distributed<database>& db, utils::UUID table_id, sstables::unrepaired_only unrepaired)
+                : _db(db), _table_id(table_id), _unrepaired(unrepaired), _contexts(smp::count) {
         }
         virtual flat_mutation_reader create_reader(
                 schema_ptr schema,
@@ -2393,7 +2419,7 @@ flat_mutation_reader make_multishard_streaming_reader(distributed<database>& db,
             _contexts[shard].read_operation = make_foreign(std::make_unique<utils::phased_barrier::operation>(cf.read_in_progress()));
             _contexts[shard].semaphore = &cf.streaming_read_concurrency_semaphore();
 
-            return cf.make_streaming_reader(std::move(schema), std::move(permit), *_contexts[shard].range, slice, fwd_mr);
+            return cf.make_streaming_reader(std::move(schema), std::move(permit), *_contexts[shard].range, slice, fwd_mr, _unrepaired);
         }
         virtual future<> destroy_reader(stopped_reader reader) noexcept override {
             auto ctx = std::move(_contexts[this_shard_id()]);
@@ -2416,7 +2442,7 @@ flat_mutation_reader make_multishard_streaming_reader(distributed<database>& db,
             return semaphore().obtain_permit(schema.get(), description, cf.estimate_read_memory_cost(), timeout);
         }
     };
-    auto ms = mutation_source([&db] (schema_ptr s,
+    auto ms = mutation_source([&db, unrepaired] (schema_ptr s,
             reader_permit permit,
             const dht::partition_range& pr,
             const query::partition_slice& ps,
@@ -2425,7 +2451,7 @@ flat_mutation_reader make_multishard_streaming_reader(distributed<database>& db,
             streamed_mutation::forwarding,
             mutation_reader::forwarding fwd_mr) {
         auto table_id = s->id();
-        return make_multishard_combining_reader(make_shared<streaming_reader_lifecycle_policy>(db, table_id), std::move(s), std::move(permit), pr, ps, pc,
+        return make_multishard_combining_reader(make_shared<streaming_reader_lifecycle_policy>(db, table_id, unrepaired), std::move(s), std::move(permit), pr, ps, pc,
                 std::move(trace_state), fwd_mr);
     });
     auto&& full_slice = schema->full_slice();
@@ -299,6 +299,8 @@ struct cf_stats {
     int64_t clustering_filter_fast_path_count = 0;
     // how many sstables survived the clustering key checks
     int64_t surviving_sstables_after_clustering_filter = 0;
+    // number of fully expired sstables single partition reads didn't read
+    int64_t expired_sstables_skipped_by_reads = 0;
 
     // How many view updates were dropped due to overload.
     int64_t dropped_view_updates = 0;
@@ -349,6 +351,9 @@ struct table_stats {
     utils::time_estimated_histogram estimated_cas_prepare;
     utils::time_estimated_histogram estimated_cas_accept;
     utils::time_estimated_histogram estimated_cas_learn;
+    // Parts of the read latency, see tracing::latency_breakdown.
+    utils::time_estimated_histogram estimated_read_admission_wait;
+    utils::time_estimated_histogram estimated_read_disk_wait;
     utils::estimated_histogram estimated_sstable_per_read{35};
     utils::timed_rate_moving_average_and_histogram tombstone_scanned;
     utils::timed_rate_moving_average_and_histogram live_scanned;
@@ -396,6 +401,17 @@ class table : public enable_lw_shared_from_this<table> {
         cache_temperature rate;
         lowres_clock::time_point last_updated;
     };
+    // Latency of the reads of this table which this node, as a coordinator,
+    // sent to a replica. See latency_read_balancing.
+    struct replica_read_latency {
+        utils::time_estimated_histogram histogram;
+        // Exponentially weighted moving average of the latency, in microseconds,
+        // disengaged until a read sent to the replica completes.
+        std::optional<double> average_us;
+        // Reads sent to the replica which have not completed yet.
+        uint32_t outstanding = 0;
+        lowres_clock::time_point last_decayed = lowres_clock::now();
+    };
 private:
     schema_ptr _schema;
     config _config;
@@ -467,6 +483,14 @@ class table : public enable_lw_shared_from_this<table> {
     // in dynamically
     std::unordered_map<gms::inet_address, cache_hit_rate> _cluster_cache_hit_rates;
 
+    // holds latencies of reads sent to each node in a cluster, only filled
+    // when latency_read_balancing is enabled
+    std::unordered_map<gms::inet_address, replica_read_latency> _replica_read_latencies;
+    // The sum of the engaged averages of _replica_read_latencies, and their number.
+    double _replica_read_average_sum = 0;
+    size_t _replica_read_average_count = 0;
+    void update_replica_read_average(replica_read_latency& e, std::chrono::microseconds latency);
+
     // Operations like truncate, flush, query, etc, may depend on a column family being alive to
     // complete.  Some of them have their own gate already (like flush), used in specialized wait
     // logic. That is particularly useful if there is a particular
@@ -693,9 +717,12 @@ class table : public enable_lw_shared_from_this<table> {
             const dht::partition_range_vector& ranges) const;
 
     // Single range overload.
+    // With unrepaired_only, the sstables which were repaired are left out,
+    // as they are by incremental repair.
     flat_mutation_reader make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
             const query::partition_slice& slice,
-            mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no) const;
+            mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+            sstables::unrepaired_only unrepaired = sstables::unrepaired_only::no) const;
 
     flat_mutation_reader make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range) {
         return make_streaming_reader(std::move(schema), std::move(permit), range, schema->full_slice());
@@ -882,6 +909,10 @@ class table : public enable_lw_shared_from_this<table> {
     future<std::unordered_set<sstring>> get_sstables_by_partition_key(const sstring& key) const;
 
     const sstables::sstable_set& get_sstable_set() const;
+    // Sorted generations of the sstables which may hold data of the range,
+    // or std::nullopt if the memtables hold some of it. The data of the
+    // range didn't change as long as they stay the same.
+    std::optional<std::vector<int64_t>> sstable_generations_of(const dht::partition_range& range) const;
     lw_shared_ptr<const sstable_list> get_sstables() const;
     lw_shared_ptr<const sstable_list> get_sstables_including_compacted_undeleted() const;
     const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const;
@@ -946,6 +977,20 @@ class table : public enable_lw_shared_from_this<table> {
     cache_hit_rate get_hit_rate(gms::inet_address addr);
     void drop_hit_rate(gms::inet_address addr);
 
+    void replica_read_started(gms::inet_address addr);
+    void replica_read_finished(gms::inet_address addr, utils::time_estimated_histogram::duration latency);
+    // A failed read counts towards the ranking of the replica as taking the
+    // time until it failed, and at least a penalty, but not towards its
+    // latency quantiles.
+    void replica_read_failed(gms::inet_address addr, utils::time_estimated_histogram::duration elapsed);
+    // Expected cost of sending one more read to the replica, lower is better.
+    // Replicas we know nothing about cost as much as the mean of the others.
+    double replica_read_score(gms::inet_address addr);
+    // Returns the given quantile of the latency of reads sent to the replica,
+    // or nothing if there were too few of them to tell.
+    std::optional<std::chrono::microseconds> get_replica_read_latency_quantile(gms::inet_address addr, double quantile);
+    void drop_replica_read_latency(gms::inet_address addr);
+
     void enable_auto_compaction();
     future<> disable_auto_compaction();
     bool is_auto_compaction_disabled_by_user() const {
@@ -1550,9 +1595,10 @@ class database {
 
     unsigned shard_of(const mutation& m);
     unsigned shard_of(const frozen_mutation& m);
+    // The latency breakdown of the read is added to latency_breakdown, if given.
     future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>> query(schema_ptr, const query::read_command& cmd, query::result_options opts,
                                                                   const dht::partition_range_vector& ranges, tracing::trace_state_ptr trace_state,
-                                                                  db::timeout_clock::time_point timeout);
+                                                                  db::timeout_clock::time_point timeout, tracing::latency_breakdown* latency_breakdown = nullptr);
     future<std::tuple<reconcilable_result, cache_temperature>> query_mutations(schema_ptr, const query::read_command& cmd, const dht::partition_range& range,
                                                 tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout);
     // Apply the mutation atomically.
@@ -1694,6 +1740,7 @@ future<> start_large_data_handler(sharded<database>& db);
 // Shard readers are created via `table::make_streaming_reader()`.
 // Range generator must generate disjoint, monotonically increasing ranges.
 flat_mutation_reader make_multishard_streaming_reader(distributed<database>& db, schema_ptr schema, reader_permit permit,
-        std::function<std::optional<dht::partition_range>()> range_generator);
+        std::function<std::optional<dht::partition_range>()> range_generator,
+        sstables::unrepaired_only unrepaired = sstables::unrepaired_only::no);
 
 bool is_internal_keyspace(std::string_view name);
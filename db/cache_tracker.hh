@@ -23,12 +23,14 @@
 
 #include "utils/lru.hh"
 #include "utils/logalloc.hh"
+#include "dht/i_partitioner.hh"
 #include "partition_version.hh"
 #include "mutation_cleaner.hh"
 
 #include <seastar/core/metrics_registration.hh>
 
 #include <stdint.h>
+#include <vector>
 
 class cache_entry;
 
@@ -91,8 +93,16 @@ class cache_tracker final {
     lru _lru;
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
+    logalloc::allocating_section _walk_section;
 private:
     void setup_metrics();
+public:
+    // Keys of the partitions owning the rows visited by a walk of the LRU,
+    // see walk_recent_partitions().
+    struct recent_partitions {
+        std::vector<std::pair<schema_ptr, dht::decorated_key>> keys;
+        stop_iteration done;
+    };
 public:
     using register_metrics = bool_class<class register_metrics_tag>;
     cache_tracker(mutation_application_stats&, register_metrics);
@@ -132,6 +142,11 @@ class cache_tracker final {
     const stats& get_stats() const noexcept { return _stats; }
     void set_compaction_scheduling_group(seastar::scheduling_group);
     lru& get_lru() { return _lru; }
+    // Returns the keys of the partitions of up to max_rows rows, visited from the
+    // most recently used one, resuming the walk at the marker (see lru::walk_from_most_recent()).
+    // A partition is returned once per run of consecutive rows of it, so callers
+    // looking for distinct partitions need to deduplicate the keys.
+    recent_partitions walk_recent_partitions(lru_marker&, size_t max_rows);
 };
 
 inline
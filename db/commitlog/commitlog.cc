@@ -65,6 +65,7 @@
 #include <seastar/core/sleep.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/net/byteorder.hh>
+#include <seastar/core/byteorder.hh>
 #include <seastar/util/defer.hh>
 
 #include "seastarx.hh"
@@ -82,6 +83,7 @@
 #include "commitlog_extensions.hh"
 #include "service/priority_manager.hh"
 #include "serializer.hh"
+#include "compress.hh"
 
 #include <boost/range/numeric.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -119,6 +121,26 @@ class crc32_nbo {
     }
 };
 
+// Returns the compressor for entries of segments written with the given codec.
+// max_entry_size is only used to size compression contexts, and can be 0 when
+// only decompressing.
+static compressor_ptr make_entry_compressor(db::commitlog::compression_type type, size_t max_entry_size) {
+    switch (type) {
+    case db::commitlog::compression_type::none:
+        return nullptr;
+    case db::commitlog::compression_type::lz4:
+        return compressor::lz4;
+    case db::commitlog::compression_type::zstd:
+        return compressor::create("ZstdCompressor", [max_entry_size] (const sstring& key) -> compressor::opt_string {
+            if (key == compression_parameters::CHUNK_LENGTH_KB && max_entry_size) {
+                return to_sstring(align_up(max_entry_size, size_t(1024)) / 1024);
+            }
+            return std::nullopt;
+        });
+    }
+    throw db::commitlog::invalid_segment_format();
+}
+
 class db::cf_holder {
 public:
     virtual ~cf_holder() {};
@@ -139,6 +161,15 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
 
+    auto compression = cfg.commitlog_compression();
+    if (compression == "lz4") {
+        c.compression = compression_type::lz4;
+    } else if (compression == "zstd") {
+        c.compression = compression_type::zstd;
+    } else if (compression != "none") {
+        throw std::invalid_argument(format("Invalid commitlog_compression: {}. Expected none, lz4 or zstd", compression));
+    }
+
     return c;
 }
 
@@ -258,6 +289,8 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     // we distribute stuff more or less equally across shards.
     const uint64_t max_disk_size; // per-shard
     const uint64_t disk_usage_threshold;
+    // Compresses the entries of new segments. Null if compression is disabled.
+    const compressor_ptr compressor;
 
     bool _shutdown = false;
     std::optional<shared_promise<>> _shutdown_promise = {};
@@ -323,6 +356,10 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         // size allocated on disk - i.e. files created (new, reserve, recycled)
         uint64_t total_size_on_disk = 0;
         uint64_t requests_blocked_memory = 0;
+        // entry bytes before and after compression, in compressed segments
+        uint64_t compression_input_bytes = 0;
+        uint64_t compression_output_bytes = 0;
+        uint64_t compression_time_ns = 0;
     };
 
     stats totals;
@@ -572,6 +609,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     static constexpr size_t multi_entry_overhead_size = entry_overhead_size + sizeof(uint32_t);
     static constexpr size_t segment_overhead_size = 2 * sizeof(uint32_t);
     static constexpr size_t descriptor_header_size = 5 * sizeof(uint32_t);
+    // segment_version_3 adds the compression codec
+    static constexpr size_t descriptor_header_size_v3 = descriptor_header_size + sizeof(uint32_t);
     static constexpr uint32_t segment_magic = ('S'<<24) |('C'<< 16) | ('L' << 8) | 'C';
     static constexpr uint32_t multi_entry_size_magic = 0xffffffff;
 
@@ -619,6 +658,45 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         _known_schema_versions.clear();
     }
 
+    size_t header_size() const {
+        return _desc.ver >= descriptor::segment_version_3 ? descriptor_header_size_v3 : descriptor_header_size;
+    }
+    bool is_compressed() const {
+        return _desc.ver >= descriptor::segment_version_3 && _segment_manager->compressor;
+    }
+
+    /**
+     * Entries up to this size are compressed. Larger ones are written as is,
+     * directly into the segment buffer, so that compressing never needs a
+     * large contiguous buffer nor holds the reactor for long.
+     */
+    static constexpr size_t max_compressed_entry_size = 128 * 1024;
+
+    /**
+     * Serializes an entry and compresses it. The result is prefixed with the
+     * uncompressed size, and holds the entry as is if it does not compress.
+     */
+    temporary_buffer<char> compress_entry(entry_writer& writer, size_t entry, size_t entry_size) {
+        temporary_buffer<char> raw(entry_size);
+        auto raw_out = output::simple(raw.get_write(), raw.size());
+        writer.write(*this, raw_out, entry);
+
+        auto& c = *_segment_manager->compressor;
+        auto start = std::chrono::steady_clock::now();
+        temporary_buffer<char> buf(sizeof(uint32_t) + c.compress_max_size(entry_size));
+        auto len = c.compress(raw.get(), raw.size(), buf.get_write() + sizeof(uint32_t), buf.size() - sizeof(uint32_t));
+        _segment_manager->totals.compression_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        if (len >= entry_size) {
+            std::copy_n(raw.get(), entry_size, buf.get_write() + sizeof(uint32_t));
+            len = entry_size;
+        }
+        write_be<uint32_t>(buf.get_write(), entry_size);
+        buf.trim(sizeof(uint32_t) + len);
+        _segment_manager->totals.compression_input_bytes += entry_size;
+        _segment_manager->totals.compression_output_bytes += len;
+        return buf;
+    }
+
     void release_cf_count(const cf_id_type& cf) override {
         mark_clean(cf, 1);
         if (can_delete()) {
@@ -769,7 +847,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
         auto overhead = segment_overhead_size;
         if (_file_pos == 0) {
-            overhead += descriptor_header_size;
+            overhead += header_size();
         }
 
         auto a = align_up(s + overhead, _alignment);
@@ -784,7 +862,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
     bool buffer_is_empty() const {
         return buffer_position() <= segment_overhead_size
-                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
+                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + header_size()));
     }
     /**
      * Send any buffer contents to disk and get a new tmp buffer
@@ -825,8 +903,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             crc.process(_desc.ver);
             crc.process<int32_t>(_desc.id & 0xffffffff);
             crc.process<int32_t>(_desc.id >> 32);
+            if (_desc.ver >= descriptor::segment_version_3) {
+                auto codec = uint32_t(_segment_manager->cfg.compression);
+                write(out, codec);
+                crc.process(codec);
+            }
             write(out, crc.checksum());
-            header_size = descriptor_header_size;
+            header_size = this->header_size();
         }
 
         if (!termination) {
@@ -976,7 +1059,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }
 
         const auto size = writer.size(*this);
-        const auto s = size + writer.num_entries * entry_overhead_size + (writer.num_entries > 1 ? multi_entry_overhead_size : 0u); // total size
+        // compressed entries are prefixed with their uncompressed size
+        const auto compression_overhead = is_compressed() ? writer.num_entries * sizeof(uint32_t) : 0u;
+        auto s = size + compression_overhead + writer.num_entries * entry_overhead_size + (writer.num_entries > 1 ? multi_entry_overhead_size : 0u); // total size (upper bound if compressed)
 
         _segment_manager->sanity_check_size(s);
 
@@ -1003,6 +1088,25 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             throw std::runtime_error("commitlog: Cannot add data to a closed segment");
         }
 
+        // Compress up front, since the multi-entry header needs the actual size.
+        // Entries too large to be compressed are left empty, and written in place.
+        std::vector<temporary_buffer<char>> compressed_entries;
+        if (is_compressed()) {
+            compressed_entries.reserve(writer.num_entries);
+            size_t saved = 0;
+            for (size_t entry = 0; entry < writer.num_entries; ++entry) {
+                auto entry_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
+                if (entry_size > max_compressed_entry_size) {
+                    compressed_entries.emplace_back();
+                    continue;
+                }
+                compressed_entries.push_back(compress_entry(writer, entry, entry_size));
+                saved += entry_size + sizeof(uint32_t) - compressed_entries.back().size();
+            }
+            s -= saved;
+            buf_memory -= saved;
+        }
+
         buf_memory -= permit.release();
         _segment_manager->account_memory_usage(buf_memory);
 
@@ -1031,7 +1135,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         for (size_t entry = 0; entry < writer.num_entries; ++entry) {
             replay_position rp(_desc.id, position());
             auto id = writer.id(entry);
-            auto entry_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
+            auto raw_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
+            bool compressed = !compressed_entries.empty() && !compressed_entries[entry].empty();
+            auto entry_size = compressed ? compressed_entries[entry].size()
+                    : raw_size + (is_compressed() ? sizeof(uint32_t) : 0u);
             auto es = entry_size + entry_overhead_size;
 
             _cf_dirty[id]++; // increase use count for cf.
@@ -1045,12 +1152,23 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             write<uint32_t>(out, crc.checksum());
 
             // actual data
-            auto entry_out = out.write_substream(entry_size);
-            auto entry_data = entry_out.to_input_stream();
-            writer.write(*this, entry_out, entry);
-            entry_data.with_stream([&] (auto data_str) {
-                crc.process_fragmented(ser::buffer_view<typename std::vector<temporary_buffer<char>>::iterator>(data_str));
-            });
+            if (compressed) {
+                auto& data = compressed_entries[entry];
+                out.write(data.get(), data.size());
+                crc.process_bytes(data.get(), data.size());
+            } else {
+                if (is_compressed()) {
+                    // Same framing as compress_entry() for an entry which does not compress.
+                    write<uint32_t>(out, raw_size);
+                    crc.process(uint32_t(raw_size));
+                }
+                auto entry_out = out.write_substream(raw_size);
+                auto entry_data = entry_out.to_input_stream();
+                writer.write(*this, entry_out, entry);
+                entry_data.with_stream([&] (auto data_str) {
+                    crc.process_fragmented(ser::buffer_view<typename std::vector<temporary_buffer<char>>::iterator>(data_str));
+                });
+            }
 
             auto checksum = crc.checksum();
             write<uint32_t>(out, checksum);
@@ -1218,6 +1336,7 @@ db::commitlog::segment_manager::segment_manager(config c)
         : (max_disk_size -
             (max_disk_size >= (max_size*2) ? max_size
                 : (max_disk_size > (max_size/2) ? (max_size/2) : max_disk_size/3))))
+    , compressor(make_entry_compressor(cfg.compression, segment::max_compressed_entry_size))
     , _flush_semaphore(cfg.max_active_flushes)
     // That is enough concurrency to allow for our largest mutation (max_mutation_size), plus
     // an existing in-flight buffer. Since we'll force the cycling() of any buffer that is bigger
@@ -1395,6 +1514,18 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
 
         sm::make_gauge("memory_buffer_bytes", totals.buffer_list_bytes,
                        sm::description("Holds the total number of bytes in internal memory buffers.")),
+
+        sm::make_derive("compression_input_bytes", totals.compression_input_bytes,
+                       sm::description("Counts a number of bytes of entries passed to compression (see commitlog_compression).")),
+
+        sm::make_derive("compression_output_bytes", totals.compression_output_bytes,
+                       sm::description("Counts a number of bytes of entries written after compression, including the ones stored uncompressed because they did not compress.")),
+
+        sm::make_gauge("compression_ratio", [this] { return totals.compression_input_bytes ? double(totals.compression_output_bytes) / totals.compression_input_bytes : 1.0; },
+                       sm::description("Holds the ratio of compressed to uncompressed entry bytes. A value close to 1 indicates that compression is not worth its CPU cost.")),
+
+        sm::make_derive("compression_time_ns", totals.compression_time_ns,
+                       sm::description("Counts the time spent compressing entries, in nanoseconds.")),
     });
 }
 
@@ -1569,7 +1700,9 @@ future<> db::commitlog::segment_manager::rename_file(sstring from, sstring to) c
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
     for (;;) {
-        descriptor d(next_id(), cfg.fname_prefix);
+        // Compressed segments use the extended header, so that older versions
+        // don't mistake them for segments they can replay.
+        descriptor d(next_id(), cfg.fname_prefix, compressor ? descriptor::segment_version_3 : descriptor::segment_version_2);
         auto dst = filename(d);
         auto flags = open_flags::wo;
         if (cfg.use_o_dsync) {
@@ -2397,6 +2530,8 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
         bool header = true;
         bool failed = false;
         fragmented_temporary_buffer::reader frag_reader;
+        // Set if the segment has compressed entries
+        compressor_ptr decompressor;
 
         work(file f, descriptor din, commit_load_reader_func fn, seastar::io_priority_class read_io_prio_class, position_type o = 0)
                 : f(f), d(din), func(std::move(fn)), fin(make_file_input_stream(f, 0, make_file_input_stream_options(read_io_prio_class))), start_off(o) {
@@ -2432,7 +2567,8 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
             stop();
         }
         future<> read_header() {
-            fragmented_temporary_buffer buf = co_await frag_reader.read_exactly(fin, segment::descriptor_header_size);
+            auto v3 = d.ver >= descriptor::segment_version_3;
+            fragmented_temporary_buffer buf = co_await frag_reader.read_exactly(fin, v3 ? segment::descriptor_header_size_v3 : segment::descriptor_header_size);
             if (!advance(buf)) {
                 // zero length file. accept it just to be nice.
                 co_return;
@@ -2442,9 +2578,10 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
             auto magic = read<uint32_t>(in);
             auto ver = read<uint32_t>(in);
             auto id = read<uint64_t>(in);
+            auto codec = v3 ? read<uint32_t>(in) : uint32_t(0);
             auto checksum = read<uint32_t>(in);
 
-            if (magic == 0 && ver == 0 && id == 0 && checksum == 0) {
+            if (magic == 0 && ver == 0 && id == 0 && codec == 0 && checksum == 0) {
                 // let's assume this was an empty (pre-allocated)
                 // file. just skip it.
                 co_return stop();
@@ -2463,11 +2600,15 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
             crc.process(ver);
             crc.process<int32_t>(id & 0xffffffff);
             crc.process<int32_t>(id >> 32);
+            if (v3) {
+                crc.process(codec);
+            }
 
             auto cs = crc.checksum();
             if (cs != checksum) {
                 throw header_checksum_error();
             }
+            decompressor = make_entry_compressor(compression_type(codec), 0);
 
             this->id = id;
             this->next = 0;
@@ -2530,6 +2671,32 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
             return do_read_entry(std::bind(&work::produce, this, std::placeholders::_1));
         }
 
+        // See segment::compress_entry()
+        fragmented_temporary_buffer uncompress_entry(fragmented_temporary_buffer buf) {
+            auto in = buf.get_istream();
+            auto raw_size = read<uint32_t>(in);
+            if (buf.size_bytes() - sizeof(uint32_t) == raw_size) {
+                // Stored as is, possibly large: don't linearize it.
+                buf.remove_prefix(sizeof(uint32_t));
+                return buf;
+            }
+            bytes_ostream linearization_buffer;
+            auto data = in.read_bytes_view(buf.size_bytes() - sizeof(uint32_t), linearization_buffer);
+            auto res = fragmented_temporary_buffer::allocate_to_fit(raw_size);
+            auto out = res.get_ostream();
+            if (data.size() == raw_size) {
+                out.write(reinterpret_cast<const char*>(data.data()), data.size());
+                return res;
+            }
+            temporary_buffer<char> raw(raw_size);
+            auto len = decompressor->uncompress(reinterpret_cast<const char*>(data.data()), data.size(), raw.get_write(), raw.size());
+            if (len != raw_size) {
+                throw std::runtime_error(format("commitlog: entry uncompressed to {} bytes, expected {}", len, raw_size));
+            }
+            out.write(raw.get(), raw.size());
+            return res;
+        }
+
         future<> do_read_entry(produce_func pf) {
             static constexpr size_t entry_header_size = segment::entry_overhead_size - sizeof(uint32_t);
 
@@ -2649,6 +2816,9 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return;
             }
 
+            if (decompressor) {
+                buf = uncompress_entry(std::move(buf));
+            }
             co_await pf({std::move(buf), rp}, checksum);
         }
 
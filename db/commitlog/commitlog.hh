@@ -114,6 +114,14 @@ class commitlog {
     enum class sync_mode {
         PERIODIC, BATCH
     };
+    // Compression of entry data in new segments. The codec is recorded in
+    // the segment header, so segments written with different settings can
+    // be replayed alike.
+    enum class compression_type : uint32_t {
+        none = 0,
+        lz4 = 1,
+        zstd = 2,
+    };
     using force_sync = commitlog_entry_writer::force_sync;
     struct config {
         config() = default;
@@ -135,6 +143,7 @@ class commitlog {
         uint64_t max_active_flushes = 0;
 
         sync_mode mode = sync_mode::PERIODIC;
+        compression_type compression = compression_type::none;
         std::string fname_prefix = descriptor::FILENAME_PREFIX;
 
         bool reuse_segments = true;
@@ -165,6 +174,8 @@ class commitlog {
 
         static inline constexpr uint32_t segment_version_1 = 1u;
         static inline constexpr uint32_t segment_version_2 = 2u;
+        // Adds the compression codec to the segment header.
+        static inline constexpr uint32_t segment_version_3 = 3u;
 
         descriptor(descriptor&&) noexcept = default;
         descriptor(const descriptor&) = default;
@@ -300,7 +300,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
         "The directory location where table key and row caches are stored.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
@@ -422,6 +422,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_hard_size_limit(this, "commitlog_use_hard_size_limit", value_status::Used, false,
         "Whether or not to use a hard size limit for commitlog disk usage. Default is false. Enabling this can cause latency spikes, whereas the default can lead to occasional disk usage peaks.\n")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "none",
+        "Compression of commitlog entries: none, lz4 or zstd. Can reduce commitlog disk bandwidth for compressible data, at some CPU cost. Segments written with compression cannot be replayed by versions which do not support it.\n")
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -517,12 +519,13 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
-    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the row cache to save.")
+    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Used, 0,
+        "Number of keys from the row cache to save, per shard, the most recently used first. (0: all)")
     , row_cache_size_in_mb(this, "row_cache_size_in_mb", value_status::Unused, 0,
         "Maximum size of the row cache in memory. Row cache can save more time than key_cache_size_in_mb, but is space-intensive because it contains the entire row. Use the row cache only for hot rows or static rows. If you reduce the size, you may not get you hottest keys loaded on start up.")
-    , row_cache_save_period(this, "row_cache_save_period", value_status::Unused, 0,
-        "Duration in seconds that rows are saved in cache. Caches are saved to saved_caches_directory.")
+    , row_cache_save_period(this, "row_cache_save_period", value_status::Used, 0,
+        "Interval in seconds between saves of the keys of the partitions in the row cache to saved_caches_directory. "
+        "The saved keys are read back into the row cache on start. 0 disables both saving and warm-up.")
     , memory_allocator(this, "memory_allocator", value_status::Invalid, "NativeAllocator",
         "The off-heap memory allocator. In addition to caches, this property affects storage engine meta data. Supported values:\n"
         "\tNativeAllocator\n"
@@ -583,6 +586,15 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tall: All traffic is compressed.\n"
         "\tdc : Traffic between data centers is compressed.\n"
         "\tnone : No compression.")
+    , internode_compression_algorithm(this, "internode_compression_algorithm", value_status::Used, "lz4",
+        "Compression algorithm for traffic compressed according to internode_compression: lz4 or zstd, or none. Can be set per connection group, "
+        "as a comma-separated list of [group:]algorithm, where group is one of gossip, streaming and statement. For instance, \"lz4,streaming:zstd\" "
+        "uses zstd for streaming and repair, and lz4 for everything else. Nodes which don't support zstd fall back to lz4.")
+    , internode_compression_zstd_level(this, "internode_compression_zstd_level", value_status::Used, 1,
+        "Compression level of zstd internode compression. Higher levels compress better, at a higher CPU cost.")
+    , internode_compression_zstd_dictionary(this, "internode_compression_zstd_dictionary", value_status::Used, "",
+        "Path to a zstd dictionary used by zstd internode compression, e.g. trained with 'zstd --train' from samples of internode messages. "
+        "The dictionary is only used between nodes which have the same one.")
     , inter_dc_tcp_nodelay(this, "inter_dc_tcp_nodelay", value_status::Used, false,
         "Enable or disable tcp_nodelay for inter-data center communication. When disabled larger, but fewer, network packets are sent. This reduces overhead from the TCP protocol itself. However, if cross data-center responses are blocked, it will increase latency.")
     , streaming_socket_timeout_in_ms(this, "streaming_socket_timeout_in_ms", value_status::Unused, 0,
@@ -636,6 +648,22 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tYour own RPC server: You must provide a fully-qualified class name of an o.a.c.t.TServerFactory that can create a server instance.")
     , cache_hit_rate_read_balancing(this, "cache_hit_rate_read_balancing", value_status::Used, true,
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
+    , latency_read_balancing(this, "latency_read_balancing", liveness::LiveUpdate, value_status::Used, false,
+        "Choose the replicas of a read by the latency the coordinator observed from them for the table: replicas of the local data center are"
+        " ordered by a moving average of their latency, weighted by the number of reads in flight to them. When set, the cache hit ratio is not"
+        " used for balancing, and the speculative retry of tables with a percentile policy waits for that percentile of the latency of the"
+        " replicas read from, rather than of the whole table.")
+    , coordinator_result_cache_size_in_mb(this, "coordinator_result_cache_size_in_mb", value_status::Used, 64,
+        "Memory, per shard, for the results of single partition reads at consistency level ONE or LOCAL_ONE of the tables with the"
+        " coordinator_results caching option.")
+    , coordinator_result_cache_ttl_in_ms(this, "coordinator_result_cache_ttl_in_ms", liveness::LiveUpdate, value_status::Used, 1000,
+        "Time for which a replica may serve a read result it cached as a coordinator. Writes, streaming and repair invalidate the cached results"
+        " of their partitions when applied to the replica, so this only bounds how long results cached before loading sstables with refresh"
+        " may be served.")
+    , read_admission_fair_queuing(this, "read_admission_fair_queuing", liveness::LiveUpdate, value_status::Used, false,
+        "Admit the user reads waiting for a replica's concurrency limit fairly among keyspaces, rather than in arrival order: the keyspace whose reads"
+        " consumed the least memory is admitted from first, and paused reads of the keyspace which consumed the most are evicted first. The wait time"
+        " of each keyspace is exported in the reader_concurrency_semaphore_wait_latency metric.")
     /* Advanced fault detection settings */
     /* Settings to handle poorly performing or failing nodes. */
     , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", value_status::Unused, 0,
@@ -656,6 +684,13 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Related information: Failure detection and recovery")
     , max_hints_delivery_threads(this, "max_hints_delivery_threads", value_status::Invalid, 2,
         "Number of threads with which to deliver hints. In multiple data-center deployments, consider increasing this number because cross data-center handoff is generally slower.")
+    , hints_replay_batch_size_in_kb(this, "hints_replay_batch_size_in_kb", liveness::LiveUpdate, value_status::Used, 0,
+        "When not 0, hints are replayed in batches of up to this many KiB, with the hints to the same partition merged into a single mutation, instead of one at a time."
+        " Only takes effect once all the nodes in the cluster support batches.")
+    , hints_log_per_destination(this, "hints_log_per_destination", liveness::LiveUpdate, value_status::Used, false,
+        "Store all the hints to an end point in a single hints log for the node, owned by one shard, instead of one log per shard."
+        " This reduces the number of hints files and of fsyncs when a node is down, at the cost of handing hints over between shards,"
+        " and of writing and replaying all the hints to an end point on a single shard.")
     , batchlog_replay_throttle_in_kb(this, "batchlog_replay_throttle_in_kb", value_status::Unused, 1024,
         "Total maximum throttle. Throttling is reduced proportionally to the number of nodes in the cluster.")
     /* Request scheduler properties */
@@ -799,8 +834,22 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+    , enable_blocked_bloom_filter(this, "enable_blocked_bloom_filter", value_status::Used, false, "Write sstable bloom filters in the split block format, which checks a key within a single cache line."
+        " Such filters are slightly larger for the same false positive chance. Only takes effect once all the nodes in the cluster support the format.")
+    , sstable_compression_dictionary_sample_size_in_kb(this, "sstable_compression_dictionary_sample_size_in_kb", value_status::Used, 0,
+        "When not 0, sstables compressed with ZstdCompressor are compressed with a dictionary trained from their first this many KiB of data, which improves the compression ratio of small chunks."
+        " The data is held in memory until the dictionary is trained. Only takes effect once all the nodes in the cluster support such sstables.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_building_concurrency(this, "view_building_concurrency", liveness::LiveUpdate, value_status::Used, 4,
+        "The number of batches of base rows whose view updates each shard generates and applies concurrently while building views, as it keeps reading the base table.")
+    , view_building_shares(this, "view_building_shares", value_status::Used, 200,
+        "The CPU shares of the scheduling group in which views are built.")
+    , view_update_batch_window_in_ms(this, "view_update_batch_window_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "When not 0, the view updates a base replica sends to each paired view replica are gathered for up to this many milliseconds, with the updates to the same view partition merged into a single mutation, and sent in batches."
+        " Only takes effect once all the nodes in the cluster support batches.")
+    , view_update_batch_size_in_kb(this, "view_update_batch_size_in_kb", liveness::LiveUpdate, value_status::Used, 128,
+        "A batch of view updates is sent as soon as it reaches this many KiB. See view_update_batch_window_in_ms.")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format")
     , enable_sstables_md_format(this, "enable_sstables_md_format", value_status::Used, true, "Enable SSTables 'md' format to be used as the default file format")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
@@ -822,6 +871,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "This is the hard limit, queries violating this limit will be aborted.")
     , initial_sstable_loading_concurrency(this, "initial_sstable_loading_concurrency", value_status::Used, 4u,
             "Maximum amount of sstables to load in parallel during initialization. A higher number can lead to more memory consumption. You should not need to touch this")
+    , row_cache_warmup_concurrency(this, "row_cache_warmup_concurrency", value_status::Used, 4u,
+            "Maximum amount of saved partitions read in parallel, per shard, when warming up the row cache on start. See row_cache_save_period.")
     , enable_3_1_0_compatibility_mode(this, "enable_3_1_0_compatibility_mode", value_status::Used, false,
         "Set to true if the cluster was initially installed from 3.1.0. If it was upgraded from an earlier version,"
         " or installed from a later version, leave this set to false. This adjusts the communication protocol to"
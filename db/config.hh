@@ -184,6 +184,7 @@ class config : public utils::config_file {
     named_value<bool> commitlog_reuse_segments;
     named_value<bool> commitlog_use_o_dsync;
     named_value<bool> commitlog_use_hard_size_limit;
+    named_value<sstring> commitlog_compression;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -239,6 +240,9 @@ class config : public utils::config_file {
     named_value<uint32_t> internode_send_buff_size_in_bytes;
     named_value<uint32_t> internode_recv_buff_size_in_bytes;
     named_value<sstring> internode_compression;
+    named_value<sstring> internode_compression_algorithm;
+    named_value<int32_t> internode_compression_zstd_level;
+    named_value<sstring> internode_compression_zstd_dictionary;
     named_value<bool> inter_dc_tcp_nodelay;
     named_value<uint32_t> streaming_socket_timeout_in_ms;
     named_value<bool> start_native_transport;
@@ -258,6 +262,10 @@ class config : public utils::config_file {
     named_value<uint32_t> rpc_send_buff_size_in_bytes;
     named_value<sstring> rpc_server_type;
     named_value<bool> cache_hit_rate_read_balancing;
+    named_value<bool> latency_read_balancing;
+    named_value<uint32_t> coordinator_result_cache_size_in_mb;
+    named_value<uint32_t> coordinator_result_cache_ttl_in_ms;
+    named_value<bool> read_admission_fair_queuing;
     named_value<double> dynamic_snitch_badness_threshold;
     named_value<uint32_t> dynamic_snitch_reset_interval_in_ms;
     named_value<uint32_t> dynamic_snitch_update_interval_in_ms;
@@ -266,6 +274,8 @@ class config : public utils::config_file {
     named_value<uint32_t> hinted_handoff_throttle_in_kb;
     named_value<uint32_t> max_hint_window_in_ms;
     named_value<uint32_t> max_hints_delivery_threads;
+    named_value<uint32_t> hints_replay_batch_size_in_kb;
+    named_value<bool> hints_log_per_destination;
     named_value<uint32_t> batchlog_replay_throttle_in_kb;
     named_value<sstring> request_scheduler;
     named_value<sstring> request_scheduler_id;
@@ -323,8 +333,14 @@ class config : public utils::config_file {
     named_value<bool> enable_keyspace_column_family_metrics;
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> enable_sstable_key_validation;
+    named_value<bool> enable_blocked_bloom_filter;
+    named_value<uint32_t> sstable_compression_dictionary_sample_size_in_kb;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<uint32_t> view_building_concurrency;
+    named_value<uint32_t> view_building_shares;
+    named_value<uint32_t> view_update_batch_window_in_ms;
+    named_value<uint32_t> view_update_batch_size_in_kb;
     named_value<bool> enable_sstables_mc_format;
     named_value<bool> enable_sstables_md_format;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
@@ -336,6 +352,7 @@ class config : public utils::config_file {
     named_value<uint64_t> max_memory_for_unlimited_query_soft_limit;
     named_value<uint64_t> max_memory_for_unlimited_query_hard_limit;
     named_value<unsigned> initial_sstable_loading_concurrency;
+    named_value<unsigned> row_cache_warmup_concurrency;
     named_value<bool> enable_3_1_0_compatibility_mode;
     named_value<bool> enable_user_defined_functions;
     named_value<unsigned> user_defined_function_time_limit_ms;
@@ -40,12 +40,15 @@
 #include "db/timeout_clock.hh"
 #include "service/priority_manager.hh"
 #include "database.hh"
+#include "db/config.hh"
+#include "gms/feature_service.hh"
 #include "service_permit.hh"
 #include "utils/directories.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "mutation_partition_view.hh"
 #include "utils/runtime.hh"
 #include "utils/error_injection.hh"
+#include "schema_registry.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -56,6 +59,13 @@ static logging::logger manager_logger("hints_manager");
 const std::string manager::FILENAME_PREFIX("HintsLog" + commitlog::descriptor::SEPARATOR);
 
 const std::chrono::seconds manager::hint_file_write_timeout = std::chrono::seconds(2);
+
+// The managers of the current shard, by root hints directory, so that a manager
+// can reach its counterpart on another shard (see manager::forward_hint()).
+static std::unordered_map<sstring, manager*>& local_managers() {
+    static thread_local std::unordered_map<sstring, manager*> managers;
+    return managers;
+}
 const std::chrono::seconds manager::hints_flush_period = std::chrono::seconds(10);
 
 manager::manager(sstring hints_directory, host_filter filter, int64_t max_hint_window_ms, resource_manager& res_manager, distributed<database>& db)
@@ -64,11 +74,17 @@ manager::manager(sstring hints_directory, host_filter filter, int64_t max_hint_w
     , _local_snitch_ptr(locator::i_endpoint_snitch::get_local_snitch_ptr())
     , _max_hint_window_us(max_hint_window_ms * 1000)
     , _local_db(db.local())
+    , _log_per_destination_observer(_local_db.get_config().hints_log_per_destination.observe([this] (const bool&) {
+        on_log_per_destination_change();
+    }))
     , _resource_manager(res_manager)
-{}
+{
+    local_managers().emplace(_hints_dir.parent_path().native(), this);
+}
 
 manager::~manager() {
     assert(_ep_managers.empty());
+    local_managers().erase(_hints_dir.parent_path().native());
 }
 
 void manager::register_metrics(const sstring& group_name) {
@@ -90,12 +106,21 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_derive("sent", _stats.sent,
                         sm::description("Number of sent hints.")),
 
+        sm::make_derive("sent_bytes", _stats.sent_bytes,
+                        sm::description("Total size of the sent hints, as stored in the hints files.")),
+
+        sm::make_derive("sent_batches", _stats.sent_batches,
+                        sm::description("Number of batches of hints sent, see hints_replay_batch_size_in_kb.")),
+
         sm::make_derive("discarded", _stats.discarded,
                         sm::description("Number of hints that were discarded during sending (too old, schema changed, etc.).")),
 
         sm::make_derive("corrupted_files", _stats.corrupted_files,
                         sm::description("Number of hints files that were discarded during sending because the file was corrupted.")),
 
+        sm::make_derive("forwarded", _stats.forwarded,
+                        sm::description("Number of hints handed over to the shard which stores the hints to their end point, see hints_log_per_destination.")),
+
         sm::make_gauge("pending_drains", 
                         sm::description("Number of tasks waiting in the queue for draining hints"),
                         [this] { return _drain_lock.waiters(); }),
@@ -130,7 +155,7 @@ future<> manager::stop() {
   return f.finally([this] {
     set_stopping();
 
-    return _draining_eps_gate.close().finally([this] {
+    return when_all(_draining_eps_gate.close(), _forward_gate.close()).discard_result().finally([this] {
         return parallel_for_each(_ep_managers, [] (auto& pair) {
             return pair.second.stop();
         }).finally([this] {
@@ -228,38 +253,48 @@ future<> manager::wait_for_sync_point(abort_source& as, const sync_point::shard_
     co_return;
 }
 
+future<> manager::end_point_hints_manager::do_store_hint(schema_ptr s, lw_shared_ptr<const frozen_mutation> fm, tracing::trace_state_ptr tr_state) {
+    ++_hints_in_progress;
+    size_t mut_size = fm->representation().size();
+    shard_stats().size_of_hints_in_progress += mut_size;
+
+    return with_shared(file_update_mutex(), [this, fm, s, tr_state] () mutable -> future<> {
+        return get_or_load().then([this, fm = std::move(fm), s = std::move(s), tr_state] (hints_store_ptr log_ptr) mutable {
+            commitlog_entry_writer cew(s, *fm, db::commitlog::force_sync::no);
+            return log_ptr->add_entry(s->id(), cew, db::timeout_clock::now() + _shard_manager.hint_file_write_timeout);
+        }).then([this, tr_state] (db::rp_handle rh) {
+            auto rp = rh.release();
+            if (_last_written_rp < rp) {
+                _last_written_rp = rp;
+                manager_logger.debug("[{}] Updated last written replay position to {}", end_point_key(), rp);
+            }
+            ++shard_stats().written;
+
+            manager_logger.trace("Hint to {} was stored", end_point_key());
+            tracing::trace(tr_state, "Hint to {} was stored", end_point_key());
+        }).handle_exception([this, tr_state] (std::exception_ptr eptr) {
+            ++shard_stats().errors;
+
+            manager_logger.debug("store_hint(): got the exception when storing a hint to {}: {}", end_point_key(), eptr);
+            tracing::trace(tr_state, "Failed to store a hint to {}: {}", end_point_key(), eptr);
+        });
+    }).finally([this, mut_size, fm, s] {
+        --_hints_in_progress;
+        shard_stats().size_of_hints_in_progress -= mut_size;
+    });
+}
+
+future<> manager::end_point_hints_manager::store_forwarded_hint(schema_ptr s, lw_shared_ptr<const frozen_mutation> fm) {
+    return with_gate(_store_gate, [this, s = std::move(s), fm = std::move(fm)] () mutable {
+        return do_store_hint(std::move(s), std::move(fm), nullptr);
+    });
+}
+
 bool manager::end_point_hints_manager::store_hint(schema_ptr s, lw_shared_ptr<const frozen_mutation> fm, tracing::trace_state_ptr tr_state) noexcept {
     try {
         // Future is waited on indirectly in `stop()` (via `_store_gate`).
         (void)with_gate(_store_gate, [this, s = std::move(s), fm = std::move(fm), tr_state] () mutable {
-            ++_hints_in_progress;
-            size_t mut_size = fm->representation().size();
-            shard_stats().size_of_hints_in_progress += mut_size;
-
-            return with_shared(file_update_mutex(), [this, fm, s, tr_state] () mutable -> future<> {
-                return get_or_load().then([this, fm = std::move(fm), s = std::move(s), tr_state] (hints_store_ptr log_ptr) mutable {
-                    commitlog_entry_writer cew(s, *fm, db::commitlog::force_sync::no);
-                    return log_ptr->add_entry(s->id(), cew, db::timeout_clock::now() + _shard_manager.hint_file_write_timeout);
-                }).then([this, tr_state] (db::rp_handle rh) {
-                    auto rp = rh.release();
-                    if (_last_written_rp < rp) {
-                        _last_written_rp = rp;
-                        manager_logger.debug("[{}] Updated last written replay position to {}", end_point_key(), rp);
-                    }
-                    ++shard_stats().written;
-
-                    manager_logger.trace("Hint to {} was stored", end_point_key());
-                    tracing::trace(tr_state, "Hint to {} was stored", end_point_key());
-                }).handle_exception([this, tr_state] (std::exception_ptr eptr) {
-                    ++shard_stats().errors;
-
-                    manager_logger.debug("store_hint(): got the exception when storing a hint to {}: {}", end_point_key(), eptr);
-                    tracing::trace(tr_state, "Failed to store a hint to {}: {}", end_point_key(), eptr);
-                });
-            }).finally([this, mut_size, fm, s] {
-                --_hints_in_progress;
-                shard_stats().size_of_hints_in_progress -= mut_size;
-            });;
+            return do_store_hint(std::move(s), std::move(fm), std::move(tr_state));
         });
     } catch (...) {
         manager_logger.trace("Failed to store a hint to {}: {}", end_point_key(), std::current_exception());
@@ -379,6 +414,10 @@ bool manager::store_hint(ep_key_type ep, schema_ptr s, lw_shared_ptr<const froze
     }
 
     try {
+        if (auto shard = owner_shard_for(ep); shard != this_shard_id()) {
+            return forward_hint(shard, ep, std::move(s), std::move(fm), std::move(tr_state));
+        }
+
         manager_logger.trace("Going to store a hint to {}", ep);
         tracing::trace(tr_state, "Going to store a hint to {}", ep);
 
@@ -392,6 +431,111 @@ bool manager::store_hint(ep_key_type ep, schema_ptr s, lw_shared_ptr<const froze
     }
 }
 
+bool manager::log_per_destination() const noexcept {
+    return _local_db.get_config().hints_log_per_destination();
+}
+
+unsigned manager::owner_shard_for(ep_key_type ep) const noexcept {
+    if (!log_per_destination()) {
+        return this_shard_id();
+    }
+    return std::hash<ep_key_type>()(ep) % smp::count;
+}
+
+future<> manager::update_node_disk_usage() {
+    auto dir = _hints_dir.parent_path().native();
+    return smp::map_reduce0([dir] {
+        auto it = local_managers().find(dir);
+        if (it == local_managers().end()) {
+            return disk_usage{};
+        }
+        return disk_usage{
+            .used = it->second->_disk_usage,
+            .reserved = it->second->ep_managers_size() * resource_manager::hint_segment_size_in_mb * 1024 * 1024,
+        };
+    }, disk_usage{}, [] (disk_usage a, disk_usage b) {
+        return disk_usage{a.used + b.used, a.reserved + b.reserved};
+    }).then([dir] (disk_usage usage) {
+        return smp::invoke_on_all([dir, usage] {
+            if (auto it = local_managers().find(dir); it != local_managers().end()) {
+                it->second->_node_disk_usage = usage;
+            }
+        });
+    });
+}
+
+bool manager::forward_hint(unsigned shard, ep_key_type ep, schema_ptr s, lw_shared_ptr<const frozen_mutation> fm, tracing::trace_state_ptr tr_state) noexcept {
+    try {
+        manager_logger.trace("Going to forward a hint to {} to shard {}", ep, shard);
+        tracing::trace(tr_state, "Going to store a hint to {} on shard {}", ep, shard);
+
+        // Future is waited on indirectly in `stop()` (via `_forward_gate`).
+        (void)with_gate(_forward_gate, [this, shard, ep, gs = global_schema_ptr(s), fm = std::move(fm)] () mutable {
+            size_t mut_size = fm->representation().size();
+            ++_forwarded_hints_in_progress[ep];
+            _stats.size_of_hints_in_progress += mut_size;
+
+            // The mutation is copied on the owner shard, so that each shard frees the memory it allocated.
+            return smp::submit_to(shard, [dir = _hints_dir.parent_path().native(), ep, gs = std::move(gs), fm = make_foreign(std::move(fm))] () mutable {
+                auto it = local_managers().find(dir);
+                if (it == local_managers().end()) {
+                    return make_ready_future<bool>(false);
+                }
+                return it->second->store_forwarded_hint(ep, gs.get(), make_lw_shared<const frozen_mutation>(*fm));
+            }).then_wrapped([this, ep, mut_size] (future<bool> f) {
+                if (f.failed() || !f.get0()) {
+                    manager_logger.trace("Failed to forward a hint to {}: {}", ep, f.failed() ? f.get_exception() : nullptr);
+                    ++_stats.dropped;
+                } else {
+                    ++_stats.forwarded;
+                }
+                if (!--_forwarded_hints_in_progress[ep]) {
+                    _forwarded_hints_in_progress.erase(ep);
+                }
+                _stats.size_of_hints_in_progress -= mut_size;
+            });
+        });
+    } catch (...) {
+        manager_logger.trace("Failed to forward a hint to {}: {}", ep, std::current_exception());
+        tracing::trace(tr_state, "Failed to store a hint to {}: {}", ep, std::current_exception());
+
+        ++_stats.dropped;
+        return false;
+    }
+    return true;
+}
+
+future<bool> manager::store_forwarded_hint(ep_key_type ep, schema_ptr s, lw_shared_ptr<const frozen_mutation> fm) {
+    // The hints of all the shards to the end point go through this one, so the in-flight limit of this shard
+    // applies to them as well.
+    if (stopping() || draining_all() || !started() || !can_hint_for(ep)) {
+        manager_logger.trace("Can't store a forwarded hint to {}", ep);
+        ++_stats.dropped;
+        return make_ready_future<bool>(false);
+    }
+
+    manager_logger.trace("Going to store a forwarded hint to {}", ep);
+    return get_ep_manager(ep).store_forwarded_hint(std::move(s), std::move(fm)).then([] {
+        return true;
+    });
+}
+
+void manager::on_log_per_destination_change() {
+    if (stopping() || !started()) {
+        return;
+    }
+    // Future is waited on indirectly in `stop()` (via `_draining_eps_gate`).
+    (void)with_gate(_draining_eps_gate, [this] {
+        return with_semaphore(drain_lock(), 1, [this] {
+            return parallel_for_each(_ep_managers | boost::adaptors::map_values, [] (end_point_hints_manager& ep_man) {
+                return ep_man.flush_current_hints();
+            });
+        });
+    }).handle_exception([] (std::exception_ptr eptr) {
+        manager_logger.warn("Failed to re-create the hints stores after a change of hints_log_per_destination: {}", eptr);
+    });
+}
+
 future<db::commitlog> manager::end_point_hints_manager::add_store() noexcept {
     manager_logger.trace("Going to add a store to {}", _hints_dir.c_str());
 
@@ -401,7 +545,9 @@ future<db::commitlog> manager::end_point_hints_manager::add_store() noexcept {
 
             cfg.commit_log_location = _hints_dir.c_str();
             cfg.commitlog_segment_size_in_mb = resource_manager::hint_segment_size_in_mb;
-            cfg.commitlog_total_space_in_mb = resource_manager::max_hints_per_ep_size_mb;
+            // A shard which stores all the hints to the end point gets the space of all the shards.
+            cfg.commitlog_total_space_in_mb = resource_manager::max_hints_per_ep_size_mb
+                    * (_shard_manager.log_per_destination() ? smp::count : 1);
             cfg.fname_prefix = manager::FILENAME_PREFIX;
             cfg.extensions = &_shard_manager.local_db().extensions();
 
@@ -872,11 +1018,12 @@ future<> manager::end_point_hints_manager::sender::send_one_mutation(frozen_muta
 }
 
 future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
+    const auto size = buf.size_bytes();
+    return _resource_manager.get_send_units_for(size).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr, size] (auto units) mutable {
         ctx_ptr->mark_hint_as_in_progress(rp);
 
         // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
-        (void)with_gate(ctx_ptr->file_send_gate, [this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
+        (void)with_gate(ctx_ptr->file_send_gate, [this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr, size] () mutable {
             try {
                 auto m = this->get_mutation(ctx_ptr, buf);
                 gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
@@ -889,8 +1036,9 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
                     return make_ready_future<>();
                 }
 
-                return this->send_one_mutation(std::move(m)).then([this, rp, ctx_ptr] {
+                return this->send_one_mutation(std::move(m)).then([this, rp, ctx_ptr, size] {
                     ++this->shard_stats().sent;
+                    this->shard_stats().sent_bytes += size;
                 }).handle_exception([this, ctx_ptr, rp] (auto eptr) {
                     manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
                     return make_exception_future<>(std::move(eptr));
@@ -917,13 +1065,7 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
             // We just need to account in the ctx that sending of this hint has failed.
             if (!f.failed()) {
                 ctx_ptr->on_hint_send_success(rp);
-                auto new_bound = ctx_ptr->get_replayed_bound();
-                // Segments from other shards are replayed first and are considered to be "before" replay position 0.
-                // Update the sent upper bound only if it is a local segment.
-                if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
-                    _sent_upper_bound_rp = new_bound;
-                    notify_replay_waiters();
-                }
+                update_sent_upper_bound(*ctx_ptr);
             } else {
                 ctx_ptr->on_hint_send_failure(rp);
             }
@@ -935,6 +1077,118 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
     });
 }
 
+size_t manager::end_point_hints_manager::sender::replay_batch_size() const {
+    if (!_proxy.features().cluster_supports_hint_mutation_batch()) {
+        return 0;
+    }
+    return size_t(_db.get_config().hints_replay_batch_size_in_kb()) * 1024;
+}
+
+void manager::end_point_hints_manager::sender::batch_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    auto& batch = ctx_ptr->batch;
+    const auto size = buf.size_bytes();
+    try {
+        auto m = this->get_mutation(ctx_ptr, buf);
+        gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
+
+        // The hint is too old - drop it. See send_one_hint().
+        if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
+            batch.rps.push_back(rp);
+            return;
+        }
+
+        keyspace& ks = _db.find_keyspace(m.s->ks_name());
+        auto token = dht::get_token(*m.s, m.fm.key());
+        auto natural_endpoints = ks.get_effective_replication_map()->get_natural_endpoints(std::move(token));
+        if (boost::range::find(natural_endpoints, end_point_key()) == natural_endpoints.end()) {
+            batch.rerouted.push_back(std::move(m));
+        } else {
+            batch.add_direct(std::move(m));
+        }
+        batch.rps.push_back(rp);
+        ++batch.hints;
+        batch.size += size;
+
+    // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+    } catch (no_such_column_family& e) {
+        manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+        ++this->shard_stats().discarded;
+        batch.rps.push_back(rp);
+    } catch (no_such_keyspace& e) {
+        manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+        ++this->shard_stats().discarded;
+        batch.rps.push_back(rp);
+    } catch (no_column_mapping& e) {
+        manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
+        ++this->shard_stats().discarded;
+        batch.rps.push_back(rp);
+    } catch (...) {
+        manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+        // The hints batched so far won't be sent, the replay will resume from the first of them.
+        ctx_ptr->on_hints_send_failure(batch.rps);
+        batch = hint_batch{};
+        ctx_ptr->on_hint_send_failure(rp);
+    }
+}
+
+future<> manager::end_point_hints_manager::sender::do_send_one_batch(hint_batch batch) {
+    auto fms = batch.release_direct();
+    auto direct = fms.empty() ? make_ready_future<>() : _proxy.send_hint_batch_to_endpoint(std::move(fms), end_point_key());
+    auto rerouted = parallel_for_each(batch.rerouted, [this] (frozen_mutation_and_schema& m) {
+        return _proxy.send_hint_to_all_replicas(std::move(m));
+    });
+    co_await when_all_succeed(std::move(direct), std::move(rerouted)).discard_result();
+}
+
+future<> manager::end_point_hints_manager::sender::send_one_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr) {
+    if (ctx_ptr->batch.rps.empty()) {
+        co_return;
+    }
+    auto batch = std::exchange(ctx_ptr->batch, hint_batch{});
+    auto rps = batch.rps;
+    try {
+        auto units = co_await _resource_manager.get_send_units_for(batch.size);
+        ctx_ptr->mark_hints_as_in_progress(rps);
+        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+        (void)with_gate(ctx_ptr->file_send_gate, [this, batch = std::move(batch)] () mutable {
+            auto hints = batch.hints;
+            auto size = batch.size;
+            auto batches = !batch.direct.empty();
+            return do_send_one_batch(std::move(batch)).then([this, hints, size, batches] {
+                this->shard_stats().sent += hints;
+                this->shard_stats().sent_bytes += size;
+                this->shard_stats().sent_batches += batches;
+            }).handle_exception([this] (auto eptr) {
+                manager_logger.trace("send_one_batch(): failed to send to {}: {}", end_point_key(), eptr);
+                return make_exception_future<>(std::move(eptr));
+            });
+        }).then_wrapped([this, units = std::move(units), rps = std::move(rps), ctx_ptr] (future<>&& f) {
+            // Information about the error was already printed somewhere higher.
+            // We just need to account in the ctx that sending of these hints has failed.
+            if (!f.failed()) {
+                ctx_ptr->on_hints_send_success(rps);
+                update_sent_upper_bound(*ctx_ptr);
+            } else {
+                ctx_ptr->on_hints_send_failure(rps);
+            }
+            f.ignore_ready_future();
+        });
+    } catch (...) {
+        manager_logger.trace("send_one_batch(): Hmmm. Something bad had happend: {}", std::current_exception());
+        ctx_ptr->on_hints_send_failure(rps);
+    }
+}
+
+void manager::end_point_hints_manager::sender::update_sent_upper_bound(const send_one_file_ctx& ctx) noexcept {
+    auto new_bound = ctx.get_replayed_bound();
+    // Segments from other shards are replayed first and are considered to be "before" replay position 0.
+    // Update the sent upper bound only if it is a local segment.
+    if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
+        _sent_upper_bound_rp = new_bound;
+        notify_replay_waiters();
+    }
+}
+
 void manager::end_point_hints_manager::sender::notify_replay_waiters() noexcept {
     if (!_foreign_segments_to_replay.empty()) {
         manager_logger.trace("[{}] notify_replay_waiters(): not notifying because there are still {} foreign segments to replay", end_point_key(), _foreign_segments_to_replay.size());
@@ -1012,6 +1266,46 @@ void manager::end_point_hints_manager::sender::send_one_file_ctx::on_hint_send_f
     }
 }
 
+void manager::end_point_hints_manager::sender::send_one_file_ctx::mark_hints_as_in_progress(const std::vector<db::replay_position>& rps) {
+    in_progress_rps.insert(rps.begin(), rps.end());
+}
+
+void manager::end_point_hints_manager::sender::send_one_file_ctx::on_hints_send_success(const std::vector<db::replay_position>& rps) noexcept {
+    for (auto& rp : rps) {
+        on_hint_send_success(rp);
+    }
+}
+
+void manager::end_point_hints_manager::sender::send_one_file_ctx::on_hints_send_failure(const std::vector<db::replay_position>& rps) noexcept {
+    for (auto& rp : rps) {
+        on_hint_send_failure(rp);
+    }
+}
+
+void manager::end_point_hints_manager::sender::hint_batch::add_direct(frozen_mutation_and_schema m) {
+    auto [it, inserted] = direct_index.emplace(std::make_pair(m.s->version(), to_bytes(m.fm.key().representation())), direct.size());
+    if (inserted) {
+        direct.push_back(entry{std::move(m)});
+        return;
+    }
+    auto& e = direct[it->second];
+    if (!e.merged) {
+        e.merged = e.m.fm.unfreeze(e.m.s);
+    }
+    e.merged->apply(m.fm.unfreeze(m.s));
+}
+
+std::vector<frozen_mutation> manager::end_point_hints_manager::sender::hint_batch::release_direct() {
+    std::vector<frozen_mutation> fms;
+    fms.reserve(direct.size());
+    for (auto& e : direct) {
+        fms.push_back(e.merged ? freeze(*e.merged) : std::move(e.m.fm));
+    }
+    direct.clear();
+    direct_index.clear();
+    return fms;
+}
+
 db::replay_position manager::end_point_hints_manager::sender::send_one_file_ctx::get_replayed_bound() const noexcept {
     // We are sure that all hints were sent _below_ the position which is the minimum of the following:
     // - Position of the first hint that failed to be sent in this replay (first_failed_rp),
@@ -1045,9 +1339,10 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
     timespec last_mod = get_last_file_modification(fname).get0();
     gc_clock::duration secs_since_file_mod = std::chrono::seconds(last_mod.tv_sec);
     lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(_last_schema_ver_to_column_mapping);
+    const size_t batch_size = replay_batch_size();
 
     try {
-        commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
+        commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [this, secs_since_file_mod, &fname, ctx_ptr, batch_size] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
             auto& buf = buf_rp.buffer;
             auto& rp = buf_rp.position;
 
@@ -1078,6 +1373,12 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
                     //   hints in a segment".
                     co_await sleep(std::chrono::milliseconds(100));
                     continue;
+                } else if (batch_size) {
+                    batch_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
+                    if (ctx_ptr->batch.size >= batch_size) {
+                        co_await send_one_batch(ctx_ptr);
+                    }
+                    break;
                 } else {
                     co_await send_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
                     break;
@@ -1093,6 +1394,11 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // Send what is left of the last batch.
+    if ((draining() || !ctx_ptr->segment_replay_failed) && can_send()) {
+        send_one_batch(ctx_ptr).get();
+    }
+
     // wait till all background hints sending is complete
     ctx_ptr->file_send_gate.close().get();
 
@@ -34,6 +34,7 @@
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/core/shared_mutex.hh>
 #include <seastar/core/abort_source.hh>
+#include "utils/observable.hh"
 #include "locator/snitch_base.hh"
 #include "inet_address_vectors.hh"
 #include "db/commitlog/commitlog.hh"
@@ -41,6 +42,7 @@
 #include "db/hints/resource_manager.hh"
 #include "db/hints/host_filter.hh"
 #include "db/hints/sync_point.hh"
+#include "mutation.hh"
 
 class fragmented_temporary_buffer;
 
@@ -87,8 +89,11 @@ class manager {
         uint64_t errors = 0;
         uint64_t dropped = 0;
         uint64_t sent = 0;
+        uint64_t sent_bytes = 0;
+        uint64_t sent_batches = 0;
         uint64_t discarded = 0;
         uint64_t corrupted_files = 0;
+        uint64_t forwarded = 0;
     };
 
     // map: shard -> segments
@@ -122,6 +127,30 @@ class manager {
                 state::ep_state_left_the_ring,
                 state::draining>>;
 
+            // Hints read from a segment which are going to be sent together, see send_one_batch().
+            struct hint_batch {
+                struct entry {
+                    frozen_mutation_and_schema m;
+                    // Engaged once another hint to the same partition was merged into it.
+                    mutation_opt merged;
+                };
+                // Hints for which the end point is still a replica, one per partition.
+                std::vector<entry> direct;
+                std::map<std::pair<table_schema_version, bytes>, size_t> direct_index;
+                // Hints for which the end point is no longer a replica, sent to all replicas.
+                std::vector<frozen_mutation_and_schema> rerouted;
+                // Positions of all the hints in the batch, including the discarded ones.
+                std::vector<db::replay_position> rps;
+                size_t hints = 0;
+                size_t size = 0;
+
+                // Adds a hint for which the end point is still a replica, merged
+                // into the hint to the same partition if the batch has one.
+                void add_direct(frozen_mutation_and_schema m);
+                // Returns the mutations to send to the end point, one per partition.
+                std::vector<frozen_mutation> release_direct();
+            };
+
             struct send_one_file_ctx {
                 send_one_file_ctx(std::unordered_map<table_schema_version, column_mapping>& last_schema_ver_to_column_mapping)
                     : schema_ver_to_column_mapping(last_schema_ver_to_column_mapping)
@@ -132,10 +161,14 @@ class manager {
                 std::optional<db::replay_position> last_succeeded_rp;
                 std::set<db::replay_position> in_progress_rps;
                 bool segment_replay_failed = false;
+                hint_batch batch;
 
                 void mark_hint_as_in_progress(db::replay_position rp);
                 void on_hint_send_success(db::replay_position rp) noexcept;
                 void on_hint_send_failure(db::replay_position rp) noexcept;
+                void mark_hints_as_in_progress(const std::vector<db::replay_position>& rps);
+                void on_hints_send_success(const std::vector<db::replay_position>& rps) noexcept;
+                void on_hints_send_failure(const std::vector<db::replay_position>& rps) noexcept;
 
                 // Returns a position below which hints were successfully replayed.
                 db::replay_position get_replayed_bound() const noexcept;
@@ -258,6 +291,36 @@ class manager {
             /// \return future that resolves when next hint may be sent
             future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
 
+            /// \brief Add one hint read from the file to the batch of the file sending context.
+            ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
+            ///  - Merge the hints to the same partition into a single mutation.
+            ///
+            /// \param ctx_ptr shared pointer to the file sending context
+            /// \param buf buffer representing the hint
+            /// \param rp replay position of this hint in the file
+            /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
+            /// \param fname name of the hints file this hint was read from
+            void batch_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+            /// \brief Send the batch of the file sending context in the background.
+            ///
+            /// Hints for which the end point is still a replica are sent in a single HINT_MUTATION_BATCH message.
+            /// Like for single hints, the memory size of the batches "in the air" is limited by the resource_manager,
+            /// and the outcome is accounted for all the replay positions of the batch.
+            ///
+            /// \param ctx_ptr shared pointer to the file sending context
+            /// \return future that resolves when the next batch may be sent
+            future<> send_one_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr);
+
+            /// \brief Send out the hints of a batch.
+            future<> do_send_one_batch(hint_batch batch);
+
+            /// \brief Returns the size of hint batches in bytes, or 0 if hints are sent one at a time.
+            size_t replay_batch_size() const;
+
+            /// \brief Advances _sent_upper_bound_rp to the position below which the hints of the file were replayed.
+            void update_sent_upper_bound(const send_one_file_ctx& ctx) noexcept;
+
             /// \brief Send all hint from a single file and delete it after it has been successfully sent.
             /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
             /// iteration from where we left in this one.
@@ -373,6 +436,13 @@ class manager {
         /// \return FALSE if hint is definitely not going to be stored
         bool store_hint(schema_ptr s, lw_shared_ptr<const frozen_mutation> fm, tracing::trace_state_ptr tr_state) noexcept;
 
+        /// \brief Write a single mutation hint to the store, accounting it as in-flight until it is written.
+        future<> do_store_hint(schema_ptr s, lw_shared_ptr<const frozen_mutation> fm, tracing::trace_state_ptr tr_state);
+
+        /// \brief Store a single mutation hint handed over by another shard, see manager::forward_hint().
+        /// \return Ready future when the hint is written (or failed to be written).
+        future<> store_forwarded_hint(schema_ptr s, lw_shared_ptr<const frozen_mutation> fm);
+
         /// \brief Populates the _segments_to_replay list.
         ///  Populates the _segments_to_replay list with the names of the files in the <manager hints files directory> directory
         ///  in the order they should be sent out.
@@ -518,6 +588,12 @@ class manager {
     static const std::chrono::seconds hints_flush_period;
     static const std::chrono::seconds hint_file_write_timeout;
 
+    struct disk_usage {
+        size_t used = 0;
+        // The space guaranteed to the end point managers.
+        size_t reserved = 0;
+    };
+
 private:
     static constexpr uint64_t max_size_of_hints_in_progress = 10 * 1024 * 1024; // 10MB
     state_set _state;
@@ -534,12 +610,22 @@ class manager {
 
     seastar::gate _draining_eps_gate; // gate used to control the progress of ep_managers stopping not in the context of manager::stop() call
 
+    // Hints being handed over to the shard which stores the hints to their end point, see forward_hint().
+    std::unordered_map<ep_key_type, uint64_t> _forwarded_hints_in_progress;
+    seastar::gate _forward_gate;
+    // Re-creates the stores when hints_log_per_destination changes, so that they are sized for the new setting.
+    utils::observer<bool> _log_per_destination_observer;
+
     resource_manager& _resource_manager;
 
     ep_managers_map_type _ep_managers;
     stats _stats;
     seastar::metrics::metric_groups _metrics;
     std::unordered_set<ep_key_type> _eps_with_pending_hints;
+    // The size of the hints files of this manager, as of the last scan of the space_watchdog.
+    size_t _disk_usage = 0;
+    // The disk usage of this manager and of its counterparts on all the other shards, see node_disk_usage().
+    disk_usage _node_disk_usage;
     seastar::named_semaphore _drain_lock = {1, named_semaphore_exception_factory{"drain lock"}};
 
 public:
@@ -602,13 +688,26 @@ class manager {
     /// \param ep End point identificator
     /// \return Number of hints in-flight to \param ep.
     uint64_t hints_in_progress_for(ep_key_type ep) const noexcept {
+        uint64_t forwarded = 0;
+        if (auto fit = _forwarded_hints_in_progress.find(ep); fit != _forwarded_hints_in_progress.end()) {
+            forwarded = fit->second;
+        }
         auto it = find_ep_manager(ep);
         if (it == ep_managers_end()) {
-            return 0;
+            return forwarded;
         }
-        return it->second.hints_in_progress();
+        return forwarded + it->second.hints_in_progress();
     }
 
+    /// \brief Get the shard which stores the hints to a given end point.
+    ///
+    /// With hints_log_per_destination, the hints to an end point are all stored by the same shard, in a single
+    /// hints log for the whole node. Otherwise each shard stores the hints it generates.
+    ///
+    /// \param ep End point identificator
+    /// \return The id of the shard which stores the hints to \param ep.
+    unsigned owner_shard_for(ep_key_type ep) const noexcept;
+
     void add_ep_with_pending_hints(ep_key_type key) {
         _eps_with_pending_hints.insert(key);
     }
@@ -626,6 +725,27 @@ class manager {
         return _ep_managers.size();
     }
 
+    /// \brief Check whether the hints to an end point are all stored by one shard, see owner_shard_for().
+    bool log_per_destination() const noexcept;
+
+    void set_disk_usage(size_t size) noexcept {
+        _disk_usage = size;
+    }
+
+    /// \brief Compute the disk usage of this manager and of its counterparts on all the other shards, and hand it
+    /// over to all of them, see node_disk_usage().
+    ///
+    /// Called by the space_watchdog of shard 0 only, so that the figure is gathered once per scan for the whole node.
+    future<> update_node_disk_usage();
+
+    /// \brief Get the disk usage of this manager and of its counterparts on all the other shards.
+    ///
+    /// The usage of each shard is as of the last scan of the space_watchdog of that shard, and the figure is as of
+    /// the last update_node_disk_usage().
+    disk_usage node_disk_usage() const noexcept {
+        return _node_disk_usage;
+    }
+
     const fs::path& hints_dir() const {
         return _hints_dir;
     }
@@ -753,6 +873,25 @@ class manager {
     end_point_hints_manager& get_ep_manager(ep_key_type ep);
     bool have_ep_manager(ep_key_type ep) const noexcept;
 
+    /// \brief Hands a hint over to the manager of another shard, which stores it in its log for the end point.
+    ///
+    /// The hint is accounted as in-flight on the current shard until the other shard has written it, so that
+    /// too_many_in_flight_hints_for() throttles the writes which generate hints to a slow owner.
+    ///
+    /// \param shard the shard which stores the hints to \param ep
+    /// \return FALSE if the hint was dropped.
+    bool forward_hint(unsigned shard, ep_key_type ep, schema_ptr s, lw_shared_ptr<const frozen_mutation> fm, tracing::trace_state_ptr tr_state) noexcept;
+
+    /// \brief Store a hint handed over by another shard, see forward_hint().
+    ///
+    /// The hints in flight on this shard are limited the same way as those generated on it, see can_hint_for().
+    ///
+    /// \return Ready future with FALSE if the hint was dropped, TRUE once it is written.
+    future<bool> store_forwarded_hint(ep_key_type ep, schema_ptr s, lw_shared_ptr<const frozen_mutation> fm);
+
+    /// \brief Flush the stores of all end points, so that they are re-created with the current configuration.
+    void on_log_per_destination_change();
+
 public:
     /// \brief Initiate the draining when we detect that the node has left the cluster.
     ///
@@ -149,6 +149,7 @@ void space_watchdog::on_timer() {
     for (auto& per_device_limits : _per_device_limits_map | boost::adaptors::map_values) {
         _total_size = 0;
         for (manager& shard_manager : per_device_limits.managers) {
+            const size_t scanned_size = _total_size;
             shard_manager.clear_eps_with_pending_hints();
             lister::scan_dir(shard_manager.hints_dir(), {directory_entry_type::directory}, [this, &shard_manager] (fs::path dir, directory_entry de) {
                 _files_count = 0;
@@ -167,15 +168,33 @@ void space_watchdog::on_timer() {
                     return scan_one_ep_dir(dir / de.name, shard_manager, ep_key_type(de.name));
                 }
             }).get();
+            shard_manager.set_disk_usage(_total_size - scanned_size);
         }
 
         // Adjust the quota to take into account the space we guarantee to every end point manager
         size_t adjusted_quota = 0;
+        size_t quota = per_device_limits.max_shard_disk_space_size;
         size_t delta = boost::accumulate(per_device_limits.managers, 0, [] (size_t sum, manager& shard_manager) {
             return sum + shard_manager.ep_managers_size() * resource_manager::hint_segment_size_in_mb * 1024 * 1024;
         });
-        if (per_device_limits.max_shard_disk_space_size > delta) {
-            adjusted_quota = per_device_limits.max_shard_disk_space_size - delta;
+        // When the hints to an end point are all stored by one shard, a share of the space per shard would
+        // limit the hints to that end point to a fraction of the space. Account for the space of the whole
+        // node instead, against the usage of all the shards.
+        if (per_device_limits.managers.front().get().log_per_destination()) {
+            _total_size = 0;
+            delta = 0;
+            for (manager& shard_manager : per_device_limits.managers) {
+                if (this_shard_id() == 0) {
+                    shard_manager.update_node_disk_usage().get();
+                }
+                auto usage = shard_manager.node_disk_usage();
+                _total_size += usage.used;
+                delta += usage.reserved;
+            }
+            quota *= smp::count;
+        }
+        if (quota > delta) {
+            adjusted_quota = quota - delta;
         }
 
         resource_manager_logger.trace("space_watchdog: consuming {}/{} bytes", _total_size, adjusted_quota);
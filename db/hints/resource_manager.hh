@@ -110,6 +110,9 @@ class space_watchdog {
     /// participants.
     ///
     /// This implementation guarantees at least a single hint share for all end point managers.
+    ///
+    /// With hints_log_per_destination, the usage and the quota are those of the whole node, see
+    /// \ref manager::node_disk_usage().
     void on_timer();
 
     /// \brief Scan files in a single end point directory.
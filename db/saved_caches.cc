@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <unordered_set>
+
+#include "db/saved_caches.hh"
+#include "database.hh"
+#include "db/system_keyspace.hh"
+#include "row_cache.hh"
+#include "lister.hh"
+#include "log.hh"
+#include "serializer.hh"
+#include "serializer_impl.hh"
+#include "service/priority_manager.hh"
+#include "utils/crc.hh"
+
+static logging::logger sclogger("saved_caches");
+
+namespace db {
+
+static constexpr uint32_t saved_caches_magic = 0x53434b31; // "SCK1"
+static constexpr uint32_t saved_caches_version = 1;
+static constexpr size_t cached_rows_batch_size = 1024;
+
+static const sstring row_cache_file_prefix = "row_cache-";
+static const sstring row_cache_file_suffix = ".db";
+
+saved_caches_manager::saved_caches_manager(seastar::sharded<database>& db, config cfg)
+        : _db(db)
+        , _cfg(std::move(cfg))
+        , _timer([this] {
+            // The gate keeps the manager alive until the save completes.
+            (void)with_gate(_gate, [this] {
+                return with_scheduling_group(_db.local().get_streaming_scheduling_group(), [this] {
+                    return save();
+                });
+            }).finally([this] {
+                arm_timer();
+            });
+        }) {
+    register_metrics();
+}
+
+void saved_caches_manager::register_metrics() {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("saved_caches", {
+        sm::make_derive("saves", _stats.saves,
+                sm::description("Counts the number of times the row cache keys were saved to disk.")),
+        sm::make_derive("save_errors", _stats.save_errors,
+                sm::description("Counts the number of failed attempts to save the row cache keys.")),
+        sm::make_gauge("saved_keys", _stats.saved_keys,
+                sm::description("Number of row cache keys written by the last save.")),
+        sm::make_gauge("warmup_keys", _stats.warmup_keys,
+                sm::description("Number of saved keys owned by this shard to be loaded into the row cache on start.")),
+        sm::make_derive("warmup_keys_loaded", _stats.warmup_keys_loaded,
+                sm::description("Counts the number of saved partitions read into the row cache during warm-up.")),
+        sm::make_derive("warmup_keys_failed", _stats.warmup_keys_failed,
+                sm::description("Counts the number of saved partitions which could not be read during warm-up.")),
+        sm::make_gauge("warmup_in_progress", [this] { return _stats.warmup_in_progress ? 1 : 0; },
+                sm::description("Set to 1 while the row cache is being warmed up from the saved keys.")),
+        sm::make_gauge("hit_rate_after_warmup", [this] { return hit_rate_after_warmup(); },
+                sm::description("Row cache partition hit rate of the reads executed since the warm-up completed.")),
+    });
+}
+
+double saved_caches_manager::hit_rate_after_warmup() const {
+    if (!_stats.warmup_done) {
+        return 0;
+    }
+    auto& st = _db.local().row_cache_tracker().get_stats();
+    auto hits = st.partition_hits - _stats.partition_hits_after_warmup;
+    auto misses = st.partition_misses - _stats.partition_misses_after_warmup;
+    return hits + misses ? double(hits) / (hits + misses) : 0;
+}
+
+sstring saved_caches_manager::file_name(const sstring& directory, unsigned shard) {
+    return format("{}/{}{}{}", directory, row_cache_file_prefix, shard, row_cache_file_suffix);
+}
+
+// Fragments of the file are written out once they reach this size.
+static constexpr size_t write_buffer_size = 128 * 1024;
+// Larger than any valid partition key, to reject corrupted lengths before allocating.
+static constexpr uint32_t max_key_size = 1 << 20;
+
+future<> saved_caches_manager::write(output_stream<char>& out, const saved_keys& keys) {
+    utils::crc32 crc;
+    bytes_ostream buf;
+    auto flush = [&] () -> future<> {
+        for (bytes_view fragment : buf) {
+            crc.process(reinterpret_cast<const uint8_t*>(fragment.data()), fragment.size());
+            co_await out.write(reinterpret_cast<const char*>(fragment.data()), fragment.size());
+        }
+        buf.clear();
+    };
+    ser::serialize(buf, saved_caches_magic);
+    ser::serialize(buf, saved_caches_version);
+    ser::serialize(buf, uint32_t(keys.size()));
+    for (auto& [id, table_keys] : keys) {
+        ser::serialize(buf, id.get_most_significant_bits());
+        ser::serialize(buf, id.get_least_significant_bits());
+        ser::serialize(buf, uint32_t(table_keys.size()));
+        for (auto& key : table_keys) {
+            ser::serialize(buf, key);
+            if (buf.size() >= write_buffer_size) {
+                co_await flush();
+            }
+        }
+    }
+    co_await flush();
+    ser::serialize(buf, crc.get());
+    for (bytes_view fragment : buf) {
+        co_await out.write(reinterpret_cast<const char*>(fragment.data()), fragment.size());
+    }
+}
+
+future<saved_caches_manager::saved_keys> saved_caches_manager::read(input_stream<char>& in) {
+    utils::crc32 crc;
+    auto read_exactly = [&] (size_t n) -> future<temporary_buffer<char>> {
+        auto buf = co_await in.read_exactly(n);
+        if (buf.size() != n) {
+            throw std::runtime_error(format("saved cache truncated: expected {} bytes, got {}", n, buf.size()));
+        }
+        co_return buf;
+    };
+    auto read_u32 = [&] () -> future<uint32_t> {
+        auto buf = co_await read_exactly(sizeof(uint32_t));
+        crc.process(reinterpret_cast<const uint8_t*>(buf.get()), buf.size());
+        auto v = ser::as_input_stream(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+        co_return ser::deserialize(v, boost::type<uint32_t>());
+    };
+    auto read_i64 = [&] () -> future<int64_t> {
+        auto buf = co_await read_exactly(sizeof(int64_t));
+        crc.process(reinterpret_cast<const uint8_t*>(buf.get()), buf.size());
+        auto v = ser::as_input_stream(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+        co_return ser::deserialize(v, boost::type<int64_t>());
+    };
+
+    auto magic = co_await read_u32();
+    auto version = co_await read_u32();
+    if (magic != saved_caches_magic || version != saved_caches_version) {
+        throw std::runtime_error(format("unsupported saved cache format: magic {:#x}, version {}", magic, version));
+    }
+    saved_keys keys;
+    auto tables = co_await read_u32();
+    for (uint32_t i = 0; i < tables; ++i) {
+        auto msb = co_await read_i64();
+        auto lsb = co_await read_i64();
+        auto& table_keys = keys[utils::UUID(msb, lsb)];
+        auto count = co_await read_u32();
+        for (uint32_t j = 0; j < count; ++j) {
+            auto size = co_await read_u32();
+            if (size > max_key_size) {
+                throw std::runtime_error(format("saved cache corrupted: key of {} bytes", size));
+            }
+            auto buf = co_await read_exactly(size);
+            crc.process(reinterpret_cast<const uint8_t*>(buf.get()), buf.size());
+            table_keys.emplace_back(reinterpret_cast<const int8_t*>(buf.get()), buf.size());
+        }
+    }
+    auto expected = crc.get();
+    if (expected != co_await read_u32()) {
+        throw std::runtime_error("saved cache checksum mismatch");
+    }
+    co_return keys;
+}
+
+future<saved_caches_manager::saved_keys> saved_caches_manager::collect_keys() {
+    saved_keys keys;
+    // A partition is met once per run of its rows in the LRU.
+    std::unordered_map<utils::UUID, std::unordered_set<bytes>> seen;
+    size_t total = 0;
+    size_t limit = _cfg.keys_to_save ? _cfg.keys_to_save : std::numeric_limits<size_t>::max();
+    auto& tracker = _db.local().row_cache_tracker();
+    // Walk the LRU from the most recently used end, so that when the number
+    // of keys is limited, the hottest partitions are the ones saved.
+    lru_marker marker;
+    auto done = stop_iteration::no;
+    while (!done && total < limit && !_as.abort_requested()) {
+        auto batch = tracker.walk_recent_partitions(marker, cached_rows_batch_size);
+        done = batch.done;
+        for (auto& [s, dk] : batch.keys) {
+            if (total == limit) {
+                break;
+            }
+            if (is_system_keyspace(s->ks_name())) {
+                continue;
+            }
+            auto key = to_bytes(dk.key().representation());
+            if (!seen[s->id()].insert(key).second) {
+                continue;
+            }
+            keys[s->id()].push_back(std::move(key));
+            ++total;
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return keys;
+}
+
+future<> saved_caches_manager::save() {
+    try {
+        auto keys = co_await collect_keys();
+        size_t count = 0;
+        for (auto& [id, table_keys] : keys) {
+            count += table_keys.size();
+        }
+
+        auto path = file_name(_cfg.directory, this_shard_id());
+        auto tmp_path = path + ".tmp";
+        auto f = co_await open_file_dma(tmp_path, open_flags::wo | open_flags::create | open_flags::truncate);
+        auto out = co_await make_file_output_stream(std::move(f));
+        std::exception_ptr ex;
+        try {
+            co_await write(out, keys);
+            co_await out.flush();
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await out.close();
+        if (ex) {
+            std::rethrow_exception(ex);
+        }
+        // Replace the previous file atomically, so that a crash in the middle
+        // of a save never leaves a truncated file behind.
+        co_await rename_file(tmp_path, path);
+        co_await sync_directory(_cfg.directory);
+
+        _stats.saves++;
+        _stats.saved_keys = count;
+        sclogger.debug("Saved {} row cache keys to {}", count, path);
+    } catch (...) {
+        _stats.save_errors++;
+        sclogger.warn("Failed to save row cache keys: {}", std::current_exception());
+    }
+}
+
+future<saved_caches_manager::saved_keys> saved_caches_manager::load_saved_keys() {
+    std::vector<sstring> files;
+    co_await lister::scan_dir(fs::path(_cfg.directory), { directory_entry_type::regular }, [&files] (fs::path dir, directory_entry de) {
+        if (de.name.starts_with(row_cache_file_prefix) && de.name.ends_with(row_cache_file_suffix)) {
+            files.push_back((dir / de.name.c_str()).native());
+        }
+        return make_ready_future<>();
+    });
+
+    saved_keys keys;
+    for (auto& path : files) {
+        try {
+            auto f = co_await open_file_dma(path, open_flags::ro);
+            auto in = make_file_input_stream(std::move(f));
+            saved_keys file_keys;
+            std::exception_ptr ex;
+            try {
+                file_keys = co_await read(in);
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            co_await in.close();
+            if (ex) {
+                std::rethrow_exception(ex);
+            }
+            for (auto& [id, table_keys] : file_keys) {
+                auto& dst = keys[id];
+                std::move(table_keys.begin(), table_keys.end(), std::back_inserter(dst));
+            }
+        } catch (...) {
+            sclogger.warn("Ignoring saved cache {}: {}", path, std::current_exception());
+        }
+    }
+    co_return keys;
+}
+
+future<> saved_caches_manager::warm_up_partition(const utils::UUID& table_id, const bytes& key) {
+    auto& local_db = _db.local();
+    if (!local_db.column_family_exists(table_id)) {
+        co_return;
+    }
+    auto& t = local_db.find_column_family(table_id);
+    auto s = t.schema();
+    auto dk = dht::decorate_key(*s, partition_key::from_bytes(key));
+    if (dht::shard_of(*s, dk.token()) != this_shard_id()) {
+        co_return;
+    }
+    auto permit = co_await local_db.obtain_reader_permit(t, "cache-warmup", db::no_timeout);
+    auto range = dht::partition_range::make_singular(dk);
+    auto reader = t.make_reader(s, std::move(permit), range, s->full_slice(), service::get_local_streaming_priority());
+    std::exception_ptr ex;
+    try {
+        co_await reader.consume_pausable([] (mutation_fragment) {
+            return stop_iteration::no;
+        });
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+}
+
+future<> saved_caches_manager::warm_up() {
+    auto keys = co_await load_saved_keys();
+
+    struct entry {
+        utils::UUID table_id;
+        const bytes* key;
+    };
+    std::vector<entry> owned;
+    for (auto& [id, table_keys] : keys) {
+        if (!_db.local().column_family_exists(id)) {
+            continue;
+        }
+        auto s = _db.local().find_schema(id);
+        for (auto& key : table_keys) {
+            auto token = dht::decorate_key(*s, partition_key::from_bytes(key)).token();
+            if (dht::shard_of(*s, token) == this_shard_id()) {
+                owned.push_back({id, &key});
+            }
+        }
+        co_await coroutine::maybe_yield();
+    }
+    if (owned.empty()) {
+        co_return;
+    }
+
+    sclogger.info("Warming up row cache with {} saved partitions", owned.size());
+    _stats.warmup_keys = owned.size();
+    _stats.warmup_in_progress = true;
+    co_await max_concurrent_for_each(owned, std::max(_cfg.warmup_concurrency, 1u), [this] (const entry& e) -> future<> {
+        if (_as.abort_requested()) {
+            co_return;
+        }
+        try {
+            co_await warm_up_partition(e.table_id, *e.key);
+            _stats.warmup_keys_loaded++;
+        } catch (...) {
+            _stats.warmup_keys_failed++;
+            sclogger.debug("Failed to warm up partition of table {}: {}", e.table_id, std::current_exception());
+        }
+    });
+    _stats.warmup_in_progress = false;
+
+    auto& st = _db.local().row_cache_tracker().get_stats();
+    _stats.partition_hits_after_warmup = st.partition_hits;
+    _stats.partition_misses_after_warmup = st.partition_misses;
+    _stats.warmup_done = true;
+    sclogger.info("Row cache warm-up done: {} partitions loaded, {} failed", _stats.warmup_keys_loaded, _stats.warmup_keys_failed);
+}
+
+void saved_caches_manager::arm_timer() {
+    if (!_as.abort_requested() && _cfg.save_period.count()) {
+        _timer.arm(_cfg.save_period);
+    }
+}
+
+future<> saved_caches_manager::start() {
+    if (!_cfg.save_period.count()) {
+        return make_ready_future<>();
+    }
+    // Run in the background: the node serves requests while warming up.
+    (void)with_gate(_gate, [this] {
+        return with_scheduling_group(_db.local().get_streaming_scheduling_group(), [this] {
+            return warm_up();
+        }).handle_exception([] (std::exception_ptr ep) {
+            sclogger.warn("Row cache warm-up failed: {}", ep);
+        }).finally([this] {
+            arm_timer();
+        });
+    });
+    return make_ready_future<>();
+}
+
+future<> saved_caches_manager::stop() {
+    _as.request_abort();
+    _timer.cancel();
+    return _gate.close();
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/timer.hh>
+
+#include "bytes.hh"
+#include "database_fwd.hh"
+#include "seastarx.hh"
+#include "utils/UUID.hh"
+
+namespace db {
+
+// Keeps the row cache warm across restarts.
+//
+// Every save_period each shard writes the keys of the partitions present in
+// its row cache to <directory>/row_cache-<shard>.db, the most recently used
+// first. Since cold entries get evicted, the cached partitions are a good
+// approximation of the hot set.
+//
+// On start, every shard reads back all the saved files (the shard count may
+// have changed since they were written), picks the keys it owns and reads the
+// corresponding partitions in the background, in the streaming scheduling
+// group and with bounded concurrency. The reads populate the row cache and,
+// as a side effect, the partition index and cached_file page caches of the
+// sstables holding the partitions.
+//
+// File format, all integers in the serializer's (little endian) encoding:
+//
+//   magic (u32) version (u32)
+//   table count (u32)
+//   for each table:
+//       table id (i64 msb, i64 lsb), key count (u32), keys (bytes)...
+//   crc32 of all the preceding bytes (u32)
+class saved_caches_manager : public seastar::peering_sharded_service<saved_caches_manager> {
+public:
+    struct config {
+        sstring directory;
+        // 0 disables both saving and the warm-up.
+        std::chrono::seconds save_period;
+        // Per shard, the most recently used first. 0 means all the cached partitions.
+        uint32_t keys_to_save;
+        uint32_t warmup_concurrency;
+    };
+
+    // Keys of cached partitions, grouped by table.
+    using saved_keys = std::unordered_map<utils::UUID, std::vector<bytes>>;
+private:
+    seastar::sharded<database>& _db;
+    config _cfg;
+    seastar::timer<lowres_clock> _timer;
+    seastar::abort_source _as;
+    seastar::gate _gate;
+
+    struct stats {
+        uint64_t saves = 0;
+        uint64_t save_errors = 0;
+        uint64_t saved_keys = 0;
+        uint64_t warmup_keys = 0;
+        uint64_t warmup_keys_loaded = 0;
+        uint64_t warmup_keys_failed = 0;
+        bool warmup_in_progress = false;
+        // Row cache partition hits and misses when the warm-up finished.
+        uint64_t partition_hits_after_warmup = 0;
+        uint64_t partition_misses_after_warmup = 0;
+        bool warmup_done = false;
+    } _stats;
+    seastar::metrics::metric_groups _metrics;
+public:
+    saved_caches_manager(seastar::sharded<database>& db, config cfg);
+
+    // Starts the warm-up in the background and arms the periodic save.
+    future<> start();
+    future<> stop();
+
+    // Writes the keys currently cached on this shard to disk.
+    future<> save();
+
+    static sstring file_name(const sstring& directory, unsigned shard);
+    static future<> write(output_stream<char>& out, const saved_keys& keys);
+    // Fails with std::runtime_error if the data is corrupted.
+    static future<saved_keys> read(input_stream<char>& in);
+private:
+    void register_metrics();
+    double hit_rate_after_warmup() const;
+    void arm_timer();
+    future<saved_keys> collect_keys();
+    future<saved_keys> load_saved_keys();
+    future<> warm_up();
+    future<> warm_up_partition(const utils::UUID& table_id, const bytes& key);
+};
+
+}
@@ -1253,6 +1253,14 @@ static future<> apply_to_remote_endpoints(gms::inet_address target, inet_address
 
     tracing::trace(tr_state, "Sending view update for {}.{} to {}, with pending endpoints = {}; base token = {}; view token = {}",
             mut.s->ks_name(), mut.s->cf_name(), target, pending_endpoints, base_token, view_token);
+    if (pending_endpoints.empty()) {
+        // May be sent in a batch with other updates to the same paired replica.
+        return service::get_local_storage_proxy().send_view_update_to_endpoint(
+                std::move(mut),
+                target,
+                std::move(tr_state),
+                allow_hints);
+    }
     return service::get_local_storage_proxy().send_to_endpoint(
             std::move(mut),
             target,
@@ -1386,10 +1394,12 @@ future<> mutate_MV(
     });
 }
 
-view_builder::view_builder(database& db, db::system_distributed_keyspace& sys_dist_ks, service::migration_notifier& mn)
+view_builder::view_builder(database& db, db::system_distributed_keyspace& sys_dist_ks, service::migration_notifier& mn,
+        seastar::scheduling_group sg)
         : _db(db)
         , _sys_dist_ks(sys_dist_ks)
         , _mnotifier(mn)
+        , _scheduling_group(sg)
         , _permit(_db.get_reader_concurrency_semaphore().make_tracking_only_permit(nullptr, "view_builder", db::no_timeout)) {
     setup_metrics();
 }
@@ -1841,6 +1851,7 @@ void view_builder::on_drop_view(const sstring& ks_name, const sstring& view_name
 }
 
 future<> view_builder::do_build_step() {
+  return with_scheduling_group(_scheduling_group, [this] {
     return seastar::async([this] {
         exponential_backoff_retry r(1s, 1min);
         while (!_base_to_build_step.empty() && !_as.abort_requested()) {
@@ -1872,8 +1883,52 @@ future<> view_builder::do_build_step() {
             }
         }
     });
+  });
 }
 
+// The batches of base rows of a build step whose view updates are being
+// generated and applied, while the step keeps reading the base table.
+class view_builder::populating_batches {
+    seastar::semaphore _sem;
+    std::vector<future<>> _batches;
+public:
+    explicit populating_batches(size_t concurrency)
+            : _sem(concurrency) {
+    }
+
+    // Must be called in a seastar thread. Blocks while as many batches as the
+    // concurrency are in flight.
+    semaphore_units<> wait_for_room() {
+        return get_units(_sem, 1).get0();
+    }
+
+    void add(semaphore_units<> units, lw_shared_ptr<column_family> base, std::vector<view_and_base> views,
+            dht::token token, flat_mutation_reader reader, gc_clock::time_point now) {
+        _batches.push_back(do_with(std::move(reader), [base = std::move(base), views = std::move(views), token, now] (flat_mutation_reader& reader) mutable {
+            return base->populate_views(std::move(views), token, std::move(reader), now).finally([&reader] {
+                return reader.close();
+            });
+        }).finally([units = std::move(units)] { }));
+    }
+
+    // Must be called in a seastar thread. Waits for all the batches, and
+    // returns the first failure, if any.
+    std::exception_ptr wait() {
+        auto batches = seastar::when_all(_batches.begin(), _batches.end()).get0();
+        _batches.clear();
+        std::exception_ptr ep;
+        for (auto& f : batches) {
+            if (f.failed()) {
+                auto e = f.get_exception();
+                if (!ep) {
+                    ep = std::move(e);
+                }
+            }
+        }
+        return ep;
+    }
+};
+
 // Called in the context of a seastar::thread.
 class view_builder::consumer {
 public:
@@ -1905,12 +1960,14 @@ class view_builder::consumer {
 private:
     view_builder& _builder;
     build_step& _step;
+    populating_batches& _populating;
     built_views _built_views;
     gc_clock::time_point _now;
     std::vector<view_ptr> _views_to_build;
     std::deque<mutation_fragment> _fragments;
     // The compact_for_query<> that feeds this consumer is already configured
-    // to feed us up to view_builder::batchsize (128) rows and not an entire
+    // to feed us up to view_builder::batch_size (128) rows per batch populated
+    // concurrently (see view_building_concurrency) and not an entire
     // partition. Still, if rows contain large blobs, saving 128 of them in
     // _fragments may be too much. So we want to track _fragment's memory
     // usage, and flush the _fragments if it has grown too large.
@@ -1920,9 +1977,10 @@ class view_builder::consumer {
     // beyond our limit on mutation size (by default 32 MB).
     size_t _fragments_memory_usage = 0;
 public:
-    consumer(view_builder& builder, build_step& step, gc_clock::time_point now)
+    consumer(view_builder& builder, build_step& step, populating_batches& populating, gc_clock::time_point now)
             : _builder(builder)
             , _step(step)
+            , _populating(populating)
             , _built_views{step}
             , _now(now) {
         if (!step.current_key.key().is_empty(*_step.reader.schema())) {
@@ -2009,18 +2067,15 @@ class view_builder::consumer {
         inject_failure("view_builder_flush_fragments");
         _builder._as.check();
         if (!_fragments.empty()) {
+            auto units = _populating.wait_for_room();
             _fragments.emplace_front(*_step.reader.schema(), _builder._permit, partition_start(_step.current_key, tombstone()));
             auto base_schema = _step.base->schema();
             auto views = with_base_info_snapshot(_views_to_build);
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
             auto close_reader = defer([&reader] { reader.close().get(); });
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
-                    std::move(views),
-                    _step.current_token(),
-                    std::move(reader),
-                    _now).get();
             close_reader.cancel();
+            _populating.add(std::move(units), _step.base, std::move(views), _step.current_token(), std::move(reader), _now);
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -2058,15 +2113,34 @@ class view_builder::consumer {
 // Called in the context of a seastar::thread.
 void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     gc_clock::time_point now = gc_clock::now();
-    auto consumer = compact_for_query<emit_only_live_rows::yes, view_builder::consumer>(
-            *step.reader.schema(),
-            now,
-            step.pslice,
-            batch_size,
-            query::max_partitions,
-            view_builder::consumer{*this, step, now});
-    consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
-    auto built = step.reader.consume_in_thread(std::move(consumer));
+    auto concurrency = std::max(_db.get_config().view_building_concurrency(), 1u);
+    // The reader moves past the batches before their view updates are applied,
+    // so should any of them fail, the step is resumed from where it started.
+    auto start_key = step.current_key;
+    auto start_status = step.build_status;
+    populating_batches populating(concurrency);
+    auto built = [&] {
+        try {
+            auto consumer = compact_for_query<emit_only_live_rows::yes, view_builder::consumer>(
+                    *step.reader.schema(),
+                    now,
+                    step.pslice,
+                    batch_size * concurrency,
+                    query::max_partitions,
+                    view_builder::consumer{*this, step, populating, now});
+            consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
+            auto built = step.reader.consume_in_thread(std::move(consumer));
+            if (auto ep = populating.wait()) {
+                std::rethrow_exception(std::move(ep));
+            }
+            return built;
+        } catch (...) {
+            populating.wait();
+            step.current_key = std::move(start_key);
+            step.build_status = std::move(start_status);
+            throw;
+        }
+    }();
 
     _as.check();
 
@@ -2160,7 +2234,7 @@ future<bool> check_needs_view_update_path(db::system_distributed_keyspace& sys_d
     if (is_internal_keyspace(t.schema()->ks_name())) {
         return make_ready_future<bool>(false);
     }
-    if (reason == streaming::stream_reason::repair && !t.views().empty()) {
+    if ((reason == streaming::stream_reason::repair || reason == streaming::stream_reason::load_and_stream) && !t.views().empty()) {
         return make_ready_future<bool>(true);
     }
     return do_with(t.views(), [&sys_dist_ks] (auto& views) {
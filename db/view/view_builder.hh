@@ -31,6 +31,7 @@
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/lowres_clock.hh>
+#include <seastar/core/scheduling.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/shared_future.hh>
@@ -138,6 +139,11 @@ class view_builder final : public service::migration_listener::only_view_notific
      * new set will potentially contain new data already in v'', written as part of the write
      * path. We assume this case is rare and optimize for fewer disk space in detriment of
      * network bandwidth.
+     *
+     * The base rows are read once for all the views, while the view updates of several
+     * consecutive batches of rows are generated and applied concurrently, up to the
+     * view_building_concurrency option. The progress of a step is only recorded once
+     * all of its batches are applied.
      */
     struct build_step final {
         // Ensure we pin the column_family. It may happen that all views are removed,
@@ -159,6 +165,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     database& _db;
     db::system_distributed_keyspace& _sys_dist_ks;
     service::migration_notifier& _mnotifier;
+    seastar::scheduling_group _scheduling_group;
     reader_permit _permit;
     base_to_build_step_type _base_to_build_step;
     base_to_build_step_type::iterator _current_step = _base_to_build_step.end();
@@ -195,7 +202,8 @@ class view_builder final : public service::migration_listener::only_view_notific
     static constexpr size_t batch_memory_max = 1024*1024;
 
 public:
-    view_builder(database&, db::system_distributed_keyspace&, service::migration_notifier&);
+    view_builder(database&, db::system_distributed_keyspace&, service::migration_notifier&,
+            seastar::scheduling_group = seastar::default_scheduling_group());
     view_builder(view_builder&&) = delete;
 
     /**
@@ -237,6 +245,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     future<> maybe_mark_view_as_built(view_ptr, dht::token);
     void setup_metrics();
 
+    class populating_batches;
     struct consumer;
 };
 
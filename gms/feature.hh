@@ -148,6 +148,16 @@ extern const std::string_view ALTERNATOR_TTL;
 extern const std::string_view RANGE_SCAN_DATA_VARIANT;
 extern const std::string_view CDC_GENERATIONS_V2;
 extern const std::string_view UDA;
+extern const std::string_view PARALLELIZED_AGGREGATION;
+extern const std::string_view BLOCKED_BLOOM_FILTER;
+extern const std::string_view SSTABLE_COMPRESSION_DICTIONARIES;
+extern const std::string_view LOAD_AND_STREAM_OFFSTRATEGY;
+extern const std::string_view HINT_MUTATION_BATCH;
+extern const std::string_view COORDINATOR_RESULT_CACHE;
+extern const std::string_view INCREMENTAL_REPAIR;
+extern const std::string_view REPAIR_RANGE_DIGEST;
+extern const std::string_view VIEW_UPDATE_BATCH;
+extern const std::string_view PARTITION_SLICE_ROW_FILTERS;
 
 }
 
@@ -73,6 +73,16 @@ constexpr std::string_view features::ALTERNATOR_TTL = "ALTERNATOR_TTL";
 constexpr std::string_view features::RANGE_SCAN_DATA_VARIANT = "RANGE_SCAN_DATA_VARIANT";
 constexpr std::string_view features::CDC_GENERATIONS_V2 = "CDC_GENERATIONS_V2";
 constexpr std::string_view features::UDA = "UDA";
+constexpr std::string_view features::PARALLELIZED_AGGREGATION = "PARALLELIZED_AGGREGATION";
+constexpr std::string_view features::BLOCKED_BLOOM_FILTER = "BLOCKED_BLOOM_FILTER";
+constexpr std::string_view features::SSTABLE_COMPRESSION_DICTIONARIES = "SSTABLE_COMPRESSION_DICTIONARIES";
+constexpr std::string_view features::LOAD_AND_STREAM_OFFSTRATEGY = "LOAD_AND_STREAM_OFFSTRATEGY";
+constexpr std::string_view features::HINT_MUTATION_BATCH = "HINT_MUTATION_BATCH";
+constexpr std::string_view features::COORDINATOR_RESULT_CACHE = "COORDINATOR_RESULT_CACHE";
+constexpr std::string_view features::INCREMENTAL_REPAIR = "INCREMENTAL_REPAIR";
+constexpr std::string_view features::REPAIR_RANGE_DIGEST = "REPAIR_RANGE_DIGEST";
+constexpr std::string_view features::VIEW_UPDATE_BATCH = "VIEW_UPDATE_BATCH";
+constexpr std::string_view features::PARTITION_SLICE_ROW_FILTERS = "PARTITION_SLICE_ROW_FILTERS";
 
 static logging::logger logger("features");
 
@@ -98,6 +108,16 @@ feature_service::feature_service(feature_config cfg) : _config(cfg)
         , _range_scan_data_variant(*this, features::RANGE_SCAN_DATA_VARIANT)
         , _cdc_generations_v2(*this, features::CDC_GENERATIONS_V2)
         , _uda(*this, features::UDA)
+        , _parallelized_aggregation(*this, features::PARALLELIZED_AGGREGATION)
+        , _blocked_bloom_filter(*this, features::BLOCKED_BLOOM_FILTER)
+        , _sstable_compression_dictionaries(*this, features::SSTABLE_COMPRESSION_DICTIONARIES)
+        , _load_and_stream_offstrategy(*this, features::LOAD_AND_STREAM_OFFSTRATEGY)
+        , _hint_mutation_batch(*this, features::HINT_MUTATION_BATCH)
+        , _coordinator_result_cache(*this, features::COORDINATOR_RESULT_CACHE)
+        , _incremental_repair(*this, features::INCREMENTAL_REPAIR)
+        , _repair_range_digest(*this, features::REPAIR_RANGE_DIGEST)
+        , _view_update_batch(*this, features::VIEW_UPDATE_BATCH)
+        , _partition_slice_row_filters(*this, features::PARTITION_SLICE_ROW_FILTERS)
 {}
 
 feature_config feature_config_from_db_config(db::config& cfg, std::set<sstring> disabled) {
@@ -202,6 +222,16 @@ std::set<std::string_view> feature_service::known_feature_set() {
         gms::features::RANGE_SCAN_DATA_VARIANT,
         gms::features::CDC_GENERATIONS_V2,
         gms::features::UDA,
+        gms::features::PARALLELIZED_AGGREGATION,
+        gms::features::BLOCKED_BLOOM_FILTER,
+        gms::features::SSTABLE_COMPRESSION_DICTIONARIES,
+        gms::features::LOAD_AND_STREAM_OFFSTRATEGY,
+        gms::features::HINT_MUTATION_BATCH,
+        gms::features::COORDINATOR_RESULT_CACHE,
+        gms::features::INCREMENTAL_REPAIR,
+        gms::features::REPAIR_RANGE_DIGEST,
+        gms::features::VIEW_UPDATE_BATCH,
+        gms::features::PARTITION_SLICE_ROW_FILTERS,
     };
 
     for (const sstring& s : _config._disabled_features) {
@@ -307,6 +337,16 @@ void feature_service::enable(const std::set<std::string_view>& list) {
         std::ref(_range_scan_data_variant),
         std::ref(_cdc_generations_v2),
         std::ref(_uda),
+        std::ref(_parallelized_aggregation),
+        std::ref(_blocked_bloom_filter),
+        std::ref(_sstable_compression_dictionaries),
+        std::ref(_load_and_stream_offstrategy),
+        std::ref(_hint_mutation_batch),
+        std::ref(_coordinator_result_cache),
+        std::ref(_incremental_repair),
+        std::ref(_repair_range_digest),
+        std::ref(_view_update_batch),
+        std::ref(_partition_slice_row_filters),
     })
     {
         if (list.contains(f.name())) {
@@ -100,6 +100,16 @@ class feature_service final {
     gms::feature _range_scan_data_variant;
     gms::feature _cdc_generations_v2;
     gms::feature _uda;
+    gms::feature _parallelized_aggregation;
+    gms::feature _blocked_bloom_filter;
+    gms::feature _sstable_compression_dictionaries;
+    gms::feature _load_and_stream_offstrategy;
+    gms::feature _hint_mutation_batch;
+    gms::feature _coordinator_result_cache;
+    gms::feature _incremental_repair;
+    gms::feature _repair_range_digest;
+    gms::feature _view_update_batch;
+    gms::feature _partition_slice_row_filters;
 
 public:
 
@@ -178,6 +188,47 @@ class feature_service final {
         return bool(_uda);
     }
 
+    bool cluster_supports_parallelized_aggregation() const {
+        return bool(_parallelized_aggregation);
+    }
+
+    bool cluster_supports_blocked_bloom_filter() const {
+        return bool(_blocked_bloom_filter);
+    }
+
+    bool cluster_supports_sstable_compression_dictionaries() const {
+        return bool(_sstable_compression_dictionaries);
+    }
+
+    bool cluster_supports_load_and_stream_offstrategy() const {
+        return bool(_load_and_stream_offstrategy);
+    }
+
+    bool cluster_supports_hint_mutation_batch() const {
+        return bool(_hint_mutation_batch);
+    }
+
+    bool cluster_supports_coordinator_result_cache() const {
+        return bool(_coordinator_result_cache);
+    }
+
+    bool cluster_supports_incremental_repair() const {
+        return bool(_incremental_repair);
+    }
+
+    bool cluster_supports_repair_range_digest() const {
+        return bool(_repair_range_digest);
+    }
+
+    bool cluster_supports_view_update_batch() const {
+        return bool(_view_update_batch);
+    }
+
+    // Replicas apply the row filters of query::partition_slice.
+    bool cluster_supports_partition_slice_row_filters() const {
+        return bool(_partition_slice_row_filters);
+    }
+
     static std::set<sstring> to_feature_set(sstring features_string);
     // Persist enabled feature in the `system.scylla_local` table under the "enabled_features" key.
     // The key itself is maintained as an `unordered_set<string>` and serialized via `to_string`
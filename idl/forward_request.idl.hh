@@ -0,0 +1,40 @@
+/*
+ * Copyright 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace query {
+
+struct forward_request {
+    struct aggregation_info {
+        sstring name;
+        std::vector<sstring> column_names;
+    };
+
+    std::vector<query::forward_request::aggregation_info> aggregations;
+    query::read_command cmd;
+    std::vector<nonwrapping_range<dht::ring_position>> pr;
+    db::consistency_level cl;
+};
+
+struct forward_result {
+    std::vector<std::optional<bytes>> query_results;
+};
+
+}
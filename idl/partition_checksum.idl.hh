@@ -63,6 +63,18 @@ struct get_sync_boundary_response {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    send_sketch_rpc_stream,
+};
+
+struct repair_hash_sketch_cell {
+    int32_t count;
+    uint64_t hash_sum;
+    uint64_t check_sum;
+};
+
+struct repair_range_digest {
+    uint64_t seed;
+    repair_hash digest;
 };
 
 enum class repair_stream_cmd : uint8_t {
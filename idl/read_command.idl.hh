@@ -30,6 +30,20 @@ class specific_ranges {
     std::vector<nonwrapping_range<clustering_key_prefix>> ranges();
 };
 
+enum class row_filter_op : uint8_t {
+    eq = 0,
+    lt = 1,
+    lte = 2,
+    gt = 3,
+    gte = 4,
+};
+
+struct row_filter {
+    uint32_t column;
+    query::row_filter_op op;
+    bytes value;
+};
+
 // COMPATIBILITY NOTE: the partition-slice for reverse queries has two different
 // format:
 // * legacy format
@@ -45,6 +59,7 @@ class partition_slice {
     cql_serialization_format cql_format();
     uint32_t partition_row_limit_low_bits() [[version 1.3]] = std::numeric_limits<uint32_t>::max();
     uint32_t partition_row_limit_high_bits() [[version 4.3]] = 0;
+    std::vector<query::row_filter> row_filters [[version 4.7]];
 };
 
 struct max_result_size {
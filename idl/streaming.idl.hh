@@ -50,6 +50,7 @@ enum class stream_reason : uint8_t {
     rebuild,
     repair,
     replace,
+    load_and_stream,
 };
 
 enum class stream_mutation_fragments_cmd : uint8_t {
@@ -73,6 +73,7 @@
 
 #include "db/view/view_update_generator.hh"
 #include "service/cache_hitrate_calculator.hh"
+#include "db/saved_caches.hh"
 #include "compaction/compaction_manager.hh"
 #include "sstables/sstables.hh"
 #include "gms/feature_service.hh"
@@ -94,6 +95,7 @@
 #include "db/paxos_grace_seconds_extension.hh"
 #include "service/qos/standard_service_level_distributed_data_accessor.hh"
 #include "service/storage_proxy.hh"
+#include "service/forward_service.hh"
 #include "alternator/controller.hh"
 #include "alternator/ttl.hh"
 
@@ -477,6 +479,7 @@ int main(int ac, char** av) {
     auto& proxy = service::get_storage_proxy();
     sharded<service::storage_service> ss;
     sharded<service::migration_manager> mm;
+    sharded<service::forward_service> forward_service;
     api::http_context ctx(db, proxy, load_meter, token_metadata);
     httpd::http_server_control prometheus_server;
     std::optional<utils::directories> dirs = {};
@@ -862,6 +865,9 @@ int main(int ac, char** av) {
             utils::directories::set dir_set;
             dir_set.add(cfg->data_file_directories());
             dir_set.add(cfg->commitlog_directory());
+            if (cfg->row_cache_save_period()) {
+                dir_set.add(cfg->saved_caches_directory());
+            }
             dirs.emplace(cfg->developer_mode());
             dirs->create_and_verify(std::move(dir_set)).get();
 
@@ -934,10 +940,15 @@ int main(int ac, char** av) {
             auto stop_migration_manager = defer_verbose_shutdown("migration manager", [&mm] {
                 mm.stop().get();
             });
+            supervisor::notify("starting forward service");
+            forward_service.start(std::ref(messaging), std::ref(proxy)).get();
+            auto stop_forward_service = defer_verbose_shutdown("forward service", [&forward_service] {
+                forward_service.stop().get();
+            });
             supervisor::notify("starting query processor");
             cql3::query_processor::memory_config qp_mcfg = {memory::stats().total_memory() / 256, memory::stats().total_memory() / 2560};
             debug::the_query_processor = &qp;
-            qp.start(std::ref(proxy), std::ref(db), std::ref(mm_notifier), std::ref(mm), qp_mcfg, std::ref(cql_config)).get();
+            qp.start(std::ref(proxy), std::ref(forward_service), std::ref(db), std::ref(mm_notifier), std::ref(mm), qp_mcfg, std::ref(cql_config)).get();
             // #293 - do not stop anything
             // engine().at_exit([&qp] { return qp.stop(); });
             supervisor::notify("initializing batchlog manager");
@@ -1043,6 +1054,13 @@ int main(int ac, char** av) {
             auto stop_proxy_handlers = defer_verbose_shutdown("storage proxy RPC verbs", [&proxy] {
                 proxy.invoke_on_all(&service::storage_proxy::uninit_messaging_service).get();
             });
+            supervisor::notify("initializing forward service RPC verbs");
+            forward_service.invoke_on_all([&mm] (service::forward_service& fs) {
+                fs.init_messaging_service(mm.local().shared_from_this());
+            }).get();
+            auto stop_forward_service_handlers = defer_verbose_shutdown("forward service RPC verbs", [&forward_service] {
+                forward_service.invoke_on_all(&service::forward_service::uninit_messaging_service).get();
+            });
 
             debug::the_stream_manager = &stream_manager;
             supervisor::notify("starting streaming service");
@@ -1270,6 +1288,20 @@ int main(int ac, char** av) {
             );
             cf_cache_hitrate_calculator.local().run_on(this_shard_id());
 
+            supervisor::notify("starting saved caches manager");
+            static sharded<db::saved_caches_manager> saved_caches;
+            db::saved_caches_manager::config saved_caches_cfg {
+                .directory = cfg->saved_caches_directory(),
+                .save_period = std::chrono::seconds(cfg->row_cache_save_period()),
+                .keys_to_save = cfg->row_cache_keys_to_save(),
+                .warmup_concurrency = cfg->row_cache_warmup_concurrency(),
+            };
+            saved_caches.start(std::ref(db), saved_caches_cfg).get();
+            saved_caches.invoke_on_all(&db::saved_caches_manager::start).get();
+            auto stop_saved_caches = defer_verbose_shutdown("saved caches manager", [] {
+                saved_caches.stop().get();
+            });
+
             supervisor::notify("starting view update backlog broker");
             static sharded<service::view_update_backlog_broker> view_backlog_broker;
             view_backlog_broker.start(std::ref(proxy), std::ref(gms::get_gossiper())).get();
@@ -1302,7 +1334,8 @@ int main(int ac, char** av) {
             static sharded<db::view::view_builder> view_builder;
             if (cfg->view_building()) {
                 supervisor::notify("starting the view builder");
-                view_builder.start(std::ref(db), std::ref(sys_dist_ks), std::ref(mm_notifier)).get();
+                auto view_building_scheduling_group = make_sched_group("view_building", cfg->view_building_shares());
+                view_builder.start(std::ref(db), std::ref(sys_dist_ks), std::ref(mm_notifier), view_building_scheduling_group).get();
                 view_builder.invoke_on_all([&mm] (db::view::view_builder& vb) { 
                     return vb.start(mm.local());
                 }).get();
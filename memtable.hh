@@ -266,6 +266,10 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
     mutation_source as_data_source();
 
     bool empty() const { return partitions.empty(); }
+    // Whether no partition of the range is in the memtable
+    bool empty(const dht::partition_range& range) const {
+        return slice(range).empty();
+    }
     void mark_flushed(mutation_source) noexcept;
     bool is_flushed() const;
     void on_detach_from_region_group() noexcept;
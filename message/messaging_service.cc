@@ -65,6 +65,7 @@
 #include "idl/paxos.dist.hh"
 #include "idl/raft.dist.hh"
 #include "idl/group0.dist.hh"
+#include "idl/forward_request.dist.hh"
 #include "serializer_impl.hh"
 #include "serialization_visitors.hh"
 #include "idl/consistency_level.dist.impl.hh"
@@ -89,9 +90,7 @@
 #include "idl/paxos.dist.impl.hh"
 #include "idl/raft.dist.impl.hh"
 #include "idl/group0.dist.impl.hh"
-#include <seastar/rpc/lz4_compressor.hh>
-#include <seastar/rpc/lz4_fragmented_compressor.hh>
-#include <seastar/rpc/multi_algo_compressor_factory.hh>
+#include "idl/forward_request.dist.impl.hh"
 #include "idl/view.dist.impl.hh"
 #include "partition_range_compat.hh"
 #include <boost/range/adaptor/filtered.hpp>
@@ -119,13 +118,6 @@ using gossip_digest_ack = gms::gossip_digest_ack;
 using gossip_digest_ack2 = gms::gossip_digest_ack2;
 using namespace std::chrono_literals;
 
-static rpc::lz4_fragmented_compressor::factory lz4_fragmented_compressor_factory;
-static rpc::lz4_compressor::factory lz4_compressor_factory;
-static rpc::multi_algo_compressor_factory compressor_factory {
-    &lz4_fragmented_compressor_factory,
-    &lz4_compressor_factory,
-};
-
 struct messaging_service::rpc_protocol_server_wrapper : public rpc_protocol::server { using rpc_protocol::server::server; };
 
 constexpr int32_t messaging_service::current_version;
@@ -240,7 +232,7 @@ void messaging_service::do_start_listen() {
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != utils::fb_utilities::get_broadcast_address();
     rpc::server_options so;
     if (_cfg.compress != compress_what::none) {
-        so.compressor_factory = &compressor_factory;
+        so.compressor_factory = &_compression->server_factory();
     }
     so.load_balancing_algorithm = server_socket::load_balancing_algorithm::port;
 
@@ -330,6 +322,7 @@ void messaging_service::do_start_listen() {
 
 messaging_service::messaging_service(config cfg, scheduling_config scfg, std::shared_ptr<seastar::tls::credentials_builder> credentials)
     : _cfg(std::move(cfg))
+    , _compression(std::make_unique<rpc_compression>(_cfg.compression))
     , _rpc(new rpc_protocol_wrapper(serializer { }))
     , _credentials_builder(credentials ? std::make_unique<seastar::tls::credentials_builder>(*credentials) : nullptr)
     , _clients(2 + scfg.statement_tenants.size() * 2)
@@ -469,8 +462,11 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
+    case messaging_verb::REPAIR_GET_ROW_HASH_SKETCH:
+    case messaging_verb::REPAIR_GET_RANGE_DIGEST:
     case messaging_verb::NODE_OPS_CMD:
     case messaging_verb::HINT_MUTATION:
+    case messaging_verb::HINT_MUTATION_BATCH:
         return 1;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
@@ -482,6 +478,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::MIGRATION_REQUEST:
     case messaging_verb::SCHEMA_CHECK:
     case messaging_verb::COUNTER_MUTATION:
+    case messaging_verb::VIEW_UPDATE_BATCH:
     // Use the same RPC client for light weight transaction
     // protocol steps as for standard mutations and read requests.
     case messaging_verb::PAXOS_PREPARE:
@@ -499,6 +496,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::RAFT_EXECUTE_READ_BARRIER_ON_LEADER:
     case messaging_verb::RAFT_ADD_ENTRY:
     case messaging_verb::RAFT_MODIFY_CONFIG:
+    case messaging_verb::FORWARD_REQUEST:
         return 2;
     case messaging_verb::MUTATION_DONE:
     case messaging_verb::MUTATION_FAILED:
@@ -692,7 +690,10 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     // send keepalive messages each minute if connection is idle, drop connection after 10 failures
     opts.keepalive = std::optional<net::tcp_keepalive_params>({60s, 60s, 10});
     if (must_compress) {
-        opts.compressor_factory = &compressor_factory;
+        auto group = idx == 0 ? rpc_connection_group::gossip
+                : idx == 1 ? rpc_connection_group::streaming
+                : rpc_connection_group::statement;
+        opts.compressor_factory = _compression->client_factory(group);
     }
     opts.tcp_nodelay = must_tcp_nodelay;
     opts.reuseaddr = true;
@@ -1147,6 +1148,28 @@ future<repair_hash_set> messaging_service::send_repair_get_full_row_hashes(msg_a
     return send_message<future<repair_hash_set>>(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES, std::move(id), repair_meta_id);
 }
 
+// Wrapper for REPAIR_GET_ROW_HASH_SKETCH
+void messaging_service::register_repair_get_row_hash_sketch(std::function<future<std::vector<repair_hash_sketch_cell>> (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint64_t cells)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_GET_ROW_HASH_SKETCH, std::move(func));
+}
+future<> messaging_service::unregister_repair_get_row_hash_sketch() {
+    return unregister_handler(messaging_verb::REPAIR_GET_ROW_HASH_SKETCH);
+}
+future<std::vector<repair_hash_sketch_cell>> messaging_service::send_repair_get_row_hash_sketch(msg_addr id, uint32_t repair_meta_id, uint64_t cells) {
+    return send_message<future<std::vector<repair_hash_sketch_cell>>>(this, messaging_verb::REPAIR_GET_ROW_HASH_SKETCH, std::move(id), repair_meta_id, cells);
+}
+
+// Wrapper for REPAIR_GET_RANGE_DIGEST
+void messaging_service::register_repair_get_range_digest(std::function<future<std::optional<repair_range_digest>> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_GET_RANGE_DIGEST, std::move(func));
+}
+future<> messaging_service::unregister_repair_get_range_digest() {
+    return unregister_handler(messaging_verb::REPAIR_GET_RANGE_DIGEST);
+}
+future<std::optional<repair_range_digest>> messaging_service::send_repair_get_range_digest(msg_addr id, uint32_t repair_meta_id) {
+    return send_message<future<std::optional<repair_range_digest>>>(this, messaging_verb::REPAIR_GET_RANGE_DIGEST, std::move(id), repair_meta_id);
+}
+
 // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
 void messaging_service::register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func) {
     register_handler(this, messaging_verb::REPAIR_GET_COMBINED_ROW_HASH, std::move(func));
@@ -1191,14 +1214,14 @@ future<> messaging_service::send_repair_put_row_diff(msg_addr id, uint32_t repai
 }
 
 // Wrapper for REPAIR_ROW_LEVEL_START
-void messaging_service::register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason)>&& func) {
+void messaging_service::register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason, rpc::optional<bool> unrepaired_only)>&& func) {
     register_handler(this, messaging_verb::REPAIR_ROW_LEVEL_START, std::move(func));
 }
 future<> messaging_service::unregister_repair_row_level_start() {
     return unregister_handler(messaging_verb::REPAIR_ROW_LEVEL_START);
 }
-future<rpc::optional<repair_row_level_start_response>> messaging_service::send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason) {
-    return send_message<rpc::optional<repair_row_level_start_response>>(this, messaging_verb::REPAIR_ROW_LEVEL_START, std::move(id), repair_meta_id, std::move(keyspace_name), std::move(cf_name), std::move(range), algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, std::move(remote_partitioner_name), std::move(schema_version), reason);
+future<rpc::optional<repair_row_level_start_response>> messaging_service::send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason, bool unrepaired_only) {
+    return send_message<rpc::optional<repair_row_level_start_response>>(this, messaging_verb::REPAIR_ROW_LEVEL_START, std::move(id), repair_meta_id, std::move(keyspace_name), std::move(cf_name), std::move(range), algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, std::move(remote_partitioner_name), std::move(schema_version), reason, unrepaired_only);
 }
 
 // Wrapper for REPAIR_ROW_LEVEL_STOP
@@ -1330,6 +1353,28 @@ future<> messaging_service::send_hint_mutation(msg_addr id, clock_type::time_poi
         std::move(reply_to), shard, std::move(response_id), std::move(trace_info));
 }
 
+void messaging_service::register_hint_mutation_batch(std::function<future<> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms,
+        rpc::optional<std::optional<tracing::trace_info>> trace_info)>&& func) {
+    register_handler(this, netw::messaging_verb::HINT_MUTATION_BATCH, std::move(func));
+}
+future<> messaging_service::unregister_hint_mutation_batch() {
+    return unregister_handler(netw::messaging_verb::HINT_MUTATION_BATCH);
+}
+future<> messaging_service::send_hint_mutation_batch(msg_addr id, clock_type::time_point timeout, const std::vector<frozen_mutation>& fms,
+        std::optional<tracing::trace_info> trace_info) {
+    return send_message_timeout<void>(this, messaging_verb::HINT_MUTATION_BATCH, std::move(id), timeout, fms, std::move(trace_info));
+}
+
+void messaging_service::register_view_update_batch(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms)>&& func) {
+    register_handler(this, netw::messaging_verb::VIEW_UPDATE_BATCH, std::move(func));
+}
+future<> messaging_service::unregister_view_update_batch() {
+    return unregister_handler(netw::messaging_verb::VIEW_UPDATE_BATCH);
+}
+future<db::view::update_backlog> messaging_service::send_view_update_batch(msg_addr id, clock_type::time_point timeout, const std::vector<frozen_mutation>& fms) {
+    return send_message_timeout<db::view::update_backlog>(this, messaging_verb::VIEW_UPDATE_BATCH, std::move(id), timeout, fms);
+}
+
 void messaging_service::register_raft_send_snapshot(std::function<future<raft::snapshot_reply> (const rpc::client_info&, rpc::opt_time_point, raft::group_id gid, raft::server_id from_id, raft::server_id dst_id, raft::install_snapshot)>&& func) {
    register_handler(this, netw::messaging_verb::RAFT_SEND_SNAPSHOT, std::move(func));
 }
@@ -1464,6 +1509,18 @@ future<> messaging_service::send_group0_modify_config(msg_addr id, clock_type::t
    return send_message_timeout<void>(this, messaging_verb::GROUP0_MODIFY_CONFIG, std::move(id), timeout, std::move(gid), add, del);
 }
 
+void messaging_service::register_forward_request(std::function<future<query::forward_result> (const rpc::client_info&, rpc::opt_time_point, query::forward_request, std::optional<tracing::trace_info>)>&& func) {
+    register_handler(this, netw::messaging_verb::FORWARD_REQUEST, std::move(func));
+}
+
+future<> messaging_service::unregister_forward_request() {
+    return unregister_handler(netw::messaging_verb::FORWARD_REQUEST);
+}
+
+future<query::forward_result> messaging_service::send_forward_request(msg_addr id, clock_type::time_point timeout, const query::forward_request& req, std::optional<tracing::trace_info> trace_info) {
+    return send_message_timeout<future<query::forward_result>>(this, messaging_verb::FORWARD_REQUEST, std::move(id), timeout, req, std::move(trace_info));
+}
+
 void init_messaging_service(sharded<messaging_service>& ms,
                 messaging_service::config mscfg, netw::messaging_service::scheduling_config scfg, const db::config& db_config) {
     using encrypt_what = messaging_service::encrypt_what;
@@ -1480,6 +1537,15 @@ void init_messaging_service(sharded<messaging_service>& ms,
         mscfg.encrypt = encrypt_what::rack;
     }
 
+    if (mscfg.compress != messaging_service::compress_what::none) {
+        mscfg.compression = rpc_compression_config::parse(db_config.internode_compression_algorithm());
+        mscfg.compression.zstd_level = db_config.internode_compression_zstd_level();
+        auto dictionary = db_config.internode_compression_zstd_dictionary();
+        if (!dictionary.empty()) {
+            mscfg.compression.zstd_dictionary = read_rpc_compression_dictionary(dictionary).get0();
+        }
+    }
+
     std::shared_ptr<credentials_builder> creds;
 
     if (mscfg.encrypt != encrypt_what::none) {
@@ -23,6 +23,7 @@
 
 #include "messaging_service_fwd.hh"
 #include "msg_addr.hh"
+#include "rpc_compression.hh"
 #include <seastar/core/seastar.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/sstring.hh>
@@ -86,6 +87,8 @@ namespace query {
     using partition_range = dht::partition_range;
     class read_command;
     class result;
+    struct forward_request;
+    struct forward_result;
 }
 
 namespace compat {
@@ -161,7 +164,12 @@ enum class messaging_verb : int32_t {
     RAFT_MODIFY_CONFIG = 56,
     GROUP0_PEER_EXCHANGE = 57,
     GROUP0_MODIFY_CONFIG = 58,
-    LAST = 59,
+    FORWARD_REQUEST = 59,
+    HINT_MUTATION_BATCH = 60,
+    REPAIR_GET_ROW_HASH_SKETCH = 61,
+    REPAIR_GET_RANGE_DIGEST = 62,
+    VIEW_UPDATE_BATCH = 63,
+    LAST = 64,
 };
 
 } // namespace netw
@@ -241,6 +249,8 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         uint16_t ssl_port = 0;
         encrypt_what encrypt = encrypt_what::none;
         compress_what compress = compress_what::none;
+        // Used where compress says to
+        rpc_compression_config compression;
         tcp_nodelay_what tcp_nodelay = tcp_nodelay_what::all;
         bool listen_on_broadcast_address = false;
         size_t rpc_memory_limit = 1'000'000;
@@ -273,6 +283,8 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     };
 private:
     config _cfg;
+    // Declared early, so that it outlives the connections using its compressors
+    std::unique_ptr<rpc_compression> _compression;
     // map: Node broadcast address -> Node internal IP for communication within the same data center
     std::unordered_map<gms::inet_address, gms::inet_address> _preferred_ip_cache;
     std::unique_ptr<rpc_protocol_wrapper> _rpc;
@@ -362,6 +374,16 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_repair_get_full_row_hashes();
     future<repair_hash_set> send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id);
 
+    // Wrapper for REPAIR_GET_ROW_HASH_SKETCH
+    void register_repair_get_row_hash_sketch(std::function<future<std::vector<repair_hash_sketch_cell>> (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint64_t cells)>&& func);
+    future<> unregister_repair_get_row_hash_sketch();
+    future<std::vector<repair_hash_sketch_cell>> send_repair_get_row_hash_sketch(msg_addr id, uint32_t repair_meta_id, uint64_t cells);
+
+    // Wrapper for REPAIR_GET_RANGE_DIGEST
+    void register_repair_get_range_digest(std::function<future<std::optional<repair_range_digest>> (const rpc::client_info& cinfo, uint32_t repair_meta_id)>&& func);
+    future<> unregister_repair_get_range_digest();
+    future<std::optional<repair_range_digest>> send_repair_get_range_digest(msg_addr id, uint32_t repair_meta_id);
+
     // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
     void register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func);
     future<> unregister_repair_get_combined_row_hash();
@@ -383,9 +405,9 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> send_repair_put_row_diff(msg_addr id, uint32_t repair_meta_id, repair_rows_on_wire row_diff);
 
     // Wrapper for REPAIR_ROW_LEVEL_START
-    void register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason)>&& func);
+    void register_repair_row_level_start(std::function<future<repair_row_level_start_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason, rpc::optional<bool> unrepaired_only)>&& func);
     future<> unregister_repair_row_level_start();
-    future<rpc::optional<repair_row_level_start_response>> send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason);
+    future<rpc::optional<repair_row_level_start_response>> send_repair_row_level_start(msg_addr id, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed, unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, streaming::stream_reason reason, bool unrepaired_only);
 
     // Wrapper for REPAIR_ROW_LEVEL_STOP
     void register_repair_row_level_stop(std::function<future<> (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring keyspace_name, sstring cf_name, dht::token_range range)>&& func);
@@ -559,6 +581,19 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> send_hint_mutation(msg_addr id, clock_type::time_point timeout, const frozen_mutation& fm, inet_address_vector_replica_set forward,
         inet_address reply_to, unsigned shard, response_id_type response_id, std::optional<tracing::trace_info> trace_info = std::nullopt);
 
+    // Replays a batch of hints. The reply is sent once all of them were applied.
+    void register_hint_mutation_batch(std::function<future<> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms,
+        rpc::optional<std::optional<tracing::trace_info>> trace_info)>&& func);
+    future<> unregister_hint_mutation_batch();
+    future<> send_hint_mutation_batch(msg_addr id, clock_type::time_point timeout, const std::vector<frozen_mutation>& fms,
+        std::optional<tracing::trace_info> trace_info = std::nullopt);
+
+    // Applies a batch of view updates. The reply, with the view update backlog
+    // of the replica, is sent once all of them were applied.
+    void register_view_update_batch(std::function<future<db::view::update_backlog> (const rpc::client_info&, rpc::opt_time_point, std::vector<frozen_mutation> fms)>&& func);
+    future<> unregister_view_update_batch();
+    future<db::view::update_backlog> send_view_update_batch(msg_addr id, clock_type::time_point timeout, const std::vector<frozen_mutation>& fms);
+
     // RAFT verbs
     void register_raft_send_snapshot(std::function<future<raft::snapshot_reply> (const rpc::client_info&, rpc::opt_time_point, raft::group_id, raft::server_id from_id, raft::server_id dst_id, raft::install_snapshot)>&& func);
     future<> unregister_raft_send_snapshot();
@@ -612,6 +647,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_group0_modify_config();
     future<> send_group0_modify_config(msg_addr id, clock_type::time_point timeout, raft::group_id gid, const std::vector<raft::server_address>& add, const std::vector<raft::server_id>& del);
 
+    // Wrapper for FORWARD_REQUEST
+    void register_forward_request(std::function<future<query::forward_result> (const rpc::client_info&, rpc::opt_time_point, query::forward_request, std::optional<tracing::trace_info>)>&& func);
+    future<> unregister_forward_request();
+    future<query::forward_result> send_forward_request(msg_addr id, clock_type::time_point timeout, const query::forward_request& req, std::optional<tracing::trace_info> trace_info);
+
     void foreach_server_connection_stats(std::function<void(const rpc::client_info&, const rpc::stats&)>&& f) const;
 private:
     bool remove_rpc_client_one(clients_map& clients, msg_addr id, bool dead_only);
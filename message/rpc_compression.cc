@@ -0,0 +1,473 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zstd.h>
+
+#include <array>
+
+#include <boost/algorithm/string.hpp>
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/rpc/lz4_compressor.hh>
+#include <seastar/rpc/lz4_fragmented_compressor.hh>
+#include <seastar/rpc/multi_algo_compressor_factory.hh>
+#include <seastar/util/variant_utils.hh>
+
+#include "message/rpc_compression.hh"
+#include "bytes_ostream.hh"
+
+namespace netw {
+
+static rpc_compression_algorithm parse_algorithm(std::string_view name) {
+    if (name == "none") {
+        return rpc_compression_algorithm::none;
+    } else if (name == "lz4") {
+        return rpc_compression_algorithm::lz4;
+    } else if (name == "zstd") {
+        return rpc_compression_algorithm::zstd;
+    }
+    throw std::invalid_argument(format("Unknown internode compression algorithm: {}", name));
+}
+
+static rpc_connection_group parse_group(std::string_view name) {
+    if (name == "gossip") {
+        return rpc_connection_group::gossip;
+    } else if (name == "streaming") {
+        return rpc_connection_group::streaming;
+    } else if (name == "statement") {
+        return rpc_connection_group::statement;
+    }
+    throw std::invalid_argument(format("Unknown internode connection group: {}", name));
+}
+
+rpc_compression_config rpc_compression_config::parse(std::string_view algorithms) {
+    rpc_compression_config cfg;
+    std::vector<std::string> items;
+    boost::split(items, algorithms, boost::is_any_of(","));
+    for (auto& item : items) {
+        boost::trim(item);
+        if (item.empty()) {
+            continue;
+        }
+        auto colon = item.find(':');
+        if (colon == std::string::npos) {
+            cfg.algorithms.fill(parse_algorithm(item));
+        } else {
+            auto algorithm = parse_algorithm(boost::trim_copy(item.substr(colon + 1)));
+            cfg.algorithms[size_t(parse_group(boost::trim_copy(item.substr(0, colon))))] = algorithm;
+        }
+    }
+    return cfg;
+}
+
+future<bytes> read_rpc_compression_dictionary(sstring path) {
+    auto f = co_await open_file_dma(path, open_flags::ro);
+    auto in = make_file_input_stream(std::move(f));
+    bytes_ostream data;
+    std::exception_ptr ex;
+    try {
+        for (auto buf = co_await in.read(); !buf.empty(); buf = co_await in.read()) {
+            data.write(buf.get(), buf.size());
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await in.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_return bytes(data.linearize());
+}
+
+class zstd_dictionary {
+    bytes _data;
+    unsigned _id;
+    ZSTD_CDict* _cdict;
+    ZSTD_DDict* _ddict;
+public:
+    zstd_dictionary(bytes data, int level)
+        : _data(std::move(data))
+        , _id(ZSTD_getDictID_fromDict(_data.data(), _data.size()))
+    {
+        // Raw content dictionaries have no id, so we couldn't tell whether
+        // the other end has the same one.
+        if (!_id) {
+            throw std::invalid_argument("Internode compression dictionary is not a zstd dictionary");
+        }
+        _cdict = ZSTD_createCDict(_data.data(), _data.size(), level);
+        _ddict = ZSTD_createDDict(_data.data(), _data.size());
+        if (!_cdict || !_ddict) {
+            ZSTD_freeCDict(_cdict);
+            ZSTD_freeDDict(_ddict);
+            throw std::bad_alloc();
+        }
+    }
+    ~zstd_dictionary() {
+        ZSTD_freeCDict(_cdict);
+        ZSTD_freeDDict(_ddict);
+    }
+    zstd_dictionary(const zstd_dictionary&) = delete;
+
+    unsigned id() const {
+        return _id;
+    }
+    const ZSTD_CDict* cdict() const {
+        return _cdict;
+    }
+    const ZSTD_DDict* ddict() const {
+        return _ddict;
+    }
+};
+
+// Calls func on the fragments of an rpc buffer, up to its size.
+template<typename Buffer, typename Func>
+static void for_each_fragment(Buffer& data, Func&& func) {
+    std::visit(make_visitor(
+        [&func] (temporary_buffer<char>& buf) {
+            func(buf.get(), buf.size());
+        },
+        [&data, &func] (std::vector<temporary_buffer<char>>& bufs) {
+            size_t left = data.size;
+            for (auto& b : bufs) {
+                auto n = std::min(b.size(), left);
+                func(b.get(), n);
+                left -= n;
+            }
+        }), data.bufs);
+}
+
+static size_t check_zstd(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("zstd {} failed: {}", what, ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+// Frame format, as for lz4_compressor: the uncompressed size (le32),
+// followed by the compressed data.
+//
+// Like lz4_fragmented_compressor, messages are compressed and decompressed
+// by streaming over their fragments, into fragments of at most chunk_size,
+// so that large messages never need large contiguous buffers.
+class zstd_compressor final : public rpc::compressor {
+    static constexpr size_t chunk_size = 32 * 1024;
+
+    struct cctx_deleter {
+        void operator()(ZSTD_CCtx* ctx) const noexcept { ZSTD_freeCCtx(ctx); }
+    };
+    struct dctx_deleter {
+        void operator()(ZSTD_DCtx* ctx) const noexcept { ZSTD_freeDCtx(ctx); }
+    };
+    std::unique_ptr<ZSTD_CCtx, cctx_deleter> _cctx;
+    std::unique_ptr<ZSTD_DCtx, dctx_deleter> _dctx;
+    lw_shared_ptr<const zstd_dictionary> _dictionary;
+    sstring _name;
+public:
+    zstd_compressor(int level, lw_shared_ptr<const zstd_dictionary> dictionary, sstring name)
+        : _cctx(ZSTD_createCCtx())
+        , _dctx(ZSTD_createDCtx())
+        , _dictionary(std::move(dictionary))
+        , _name(std::move(name))
+    {
+        if (!_cctx || !_dctx) {
+            throw std::bad_alloc();
+        }
+        // Both stick to the contexts across messages.
+        if (_dictionary) {
+            check_zstd(ZSTD_CCtx_refCDict(_cctx.get(), _dictionary->cdict()), "setting the dictionary");
+            check_zstd(ZSTD_DCtx_refDDict(_dctx.get(), _dictionary->ddict()), "setting the dictionary");
+        } else {
+            check_zstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_compressionLevel, level), "setting the level");
+        }
+    }
+
+    virtual rpc::snd_buf compress(size_t head_space, rpc::snd_buf data) override {
+        check_zstd(ZSTD_CCtx_reset(_cctx.get(), ZSTD_reset_session_only), "reset");
+        check_zstd(ZSTD_CCtx_setPledgedSrcSize(_cctx.get(), data.size), "setting the source size");
+
+        std::vector<temporary_buffer<char>> dst;
+        size_t dst_size = 0;
+        temporary_buffer<char> chunk(head_space + sizeof(uint32_t) + chunk_size);
+        write_le<uint32_t>(chunk.get_write() + head_space, data.size);
+        ZSTD_outBuffer out{chunk.get_write(), chunk.size(), head_space + sizeof(uint32_t)};
+        auto next_chunk = [&] {
+            chunk.trim(out.pos);
+            dst_size += chunk.size();
+            dst.push_back(std::move(chunk));
+            chunk = temporary_buffer<char>(chunk_size);
+            out = ZSTD_outBuffer{chunk.get_write(), chunk.size(), 0};
+        };
+        auto compress_fragment = [&] (const char* src, size_t size, ZSTD_EndDirective mode) {
+            ZSTD_inBuffer in{src, size, 0};
+            size_t pending;
+            do {
+                pending = check_zstd(ZSTD_compressStream2(_cctx.get(), &out, &in, mode), "compression");
+                if (out.pos == out.size) {
+                    next_chunk();
+                }
+            } while (in.pos < in.size || (mode == ZSTD_e_end && pending));
+        };
+        for_each_fragment(data, [&] (const char* src, size_t size) {
+            compress_fragment(src, size, ZSTD_e_continue);
+        });
+        compress_fragment(nullptr, 0, ZSTD_e_end);
+        if (out.pos) {
+            chunk.trim(out.pos);
+            dst_size += chunk.size();
+            dst.push_back(std::move(chunk));
+        }
+
+        if (dst.size() == 1) {
+            return rpc::snd_buf(std::move(dst.front()));
+        }
+        return rpc::snd_buf(std::move(dst), dst_size);
+    }
+
+    virtual rpc::rcv_buf decompress(rpc::rcv_buf data) override {
+        if (data.size < sizeof(uint32_t)) {
+            return rpc::rcv_buf();
+        }
+        check_zstd(ZSTD_DCtx_reset(_dctx.get(), ZSTD_reset_session_only), "reset");
+
+        // The size may span fragments.
+        std::array<char, sizeof(uint32_t)> header;
+        size_t header_pos = 0;
+        uint32_t size = 0;
+        std::vector<temporary_buffer<char>> dst;
+        size_t dst_size = 0;
+        temporary_buffer<char> chunk;
+        ZSTD_outBuffer out{nullptr, 0, 0};
+        // Non-zero until the end of the frame.
+        size_t pending = 1;
+        auto next_chunk = [&] {
+            if (out.pos) {
+                chunk.trim(out.pos);
+                dst_size += chunk.size();
+                dst.push_back(std::move(chunk));
+            }
+            // Empty once the expected size is reached, which still lets
+            // zstd consume the end of the frame.
+            chunk = temporary_buffer<char>(std::min<size_t>(size - dst_size, chunk_size));
+            out = ZSTD_outBuffer{chunk.get_write(), chunk.size(), 0};
+        };
+        auto decompress_some = [&] (ZSTD_inBuffer& in) {
+            if (out.pos == out.size) {
+                next_chunk();
+            }
+            auto in_pos = in.pos;
+            auto out_pos = out.pos;
+            pending = check_zstd(ZSTD_decompressStream(_dctx.get(), &out, &in), "decompression");
+            if (in.pos == in_pos && out.pos == out_pos) {
+                throw std::runtime_error(format("zstd decompression: malformed frame for {} bytes", size));
+            }
+        };
+        for_each_fragment(data, [&] (const char* src, size_t len) {
+            if (header_pos < header.size()) {
+                auto n = std::min(len, header.size() - header_pos);
+                std::copy_n(src, n, header.data() + header_pos);
+                header_pos += n;
+                src += n;
+                len -= n;
+                if (header_pos < header.size()) {
+                    return;
+                }
+                size = read_le<uint32_t>(header.data());
+            }
+            ZSTD_inBuffer in{src, len, 0};
+            while (in.pos < in.size) {
+                if (!pending) {
+                    throw std::runtime_error("zstd decompression: data past the end of the frame");
+                }
+                decompress_some(in);
+            }
+        });
+        // The end of the frame may still be buffered once all the input was consumed.
+        while (pending) {
+            ZSTD_inBuffer in{nullptr, 0, 0};
+            decompress_some(in);
+        }
+        if (out.pos) {
+            chunk.trim(out.pos);
+            dst_size += chunk.size();
+            dst.push_back(std::move(chunk));
+        }
+        if (pending || dst_size != size) {
+            throw std::runtime_error(format("zstd decompression produced {} bytes, expected {}", dst_size, size));
+        }
+
+        if (dst.empty()) {
+            return rpc::rcv_buf();
+        }
+        if (dst.size() == 1) {
+            return rpc::rcv_buf(std::move(dst.front()));
+        }
+        return rpc::rcv_buf(std::move(dst), dst_size);
+    }
+
+    virtual sstring name() const override {
+        return _name;
+    }
+};
+
+class zstd_compressor_factory final : public rpc::compressor::factory {
+    int _level;
+    lw_shared_ptr<const zstd_dictionary> _dictionary;
+    sstring _feature;
+public:
+    zstd_compressor_factory(int level, lw_shared_ptr<const zstd_dictionary> dictionary)
+        : _level(level)
+        , _dictionary(std::move(dictionary))
+        // The dictionary id is part of the feature, so that it is only
+        // negotiated between nodes which have the same dictionary.
+        , _feature(_dictionary ? format("ZSTD-DICT-{}", _dictionary->id()) : sstring("ZSTD"))
+    { }
+
+    virtual const sstring& supported() const override {
+        return _feature;
+    }
+
+    virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server) const override {
+        if (feature != _feature) {
+            return nullptr;
+        }
+        return std::make_unique<zstd_compressor>(_level, _dictionary, _feature);
+    }
+};
+
+struct rpc_compression_stats {
+    uint64_t uncompressed_bytes_sent = 0;
+    uint64_t compressed_bytes_sent = 0;
+    uint64_t compressed_bytes_received = 0;
+    uint64_t uncompressed_bytes_received = 0;
+};
+
+class counting_compressor final : public rpc::compressor {
+    std::unique_ptr<rpc::compressor> _compressor;
+    rpc_compression_stats& _stats;
+public:
+    counting_compressor(std::unique_ptr<rpc::compressor> compressor, rpc_compression_stats& stats)
+        : _compressor(std::move(compressor))
+        , _stats(stats)
+    { }
+
+    virtual rpc::snd_buf compress(size_t head_space, rpc::snd_buf data) override {
+        _stats.uncompressed_bytes_sent += data.size;
+        auto ret = _compressor->compress(head_space, std::move(data));
+        _stats.compressed_bytes_sent += ret.size - head_space;
+        return ret;
+    }
+
+    virtual rpc::rcv_buf decompress(rpc::rcv_buf data) override {
+        _stats.compressed_bytes_received += data.size;
+        auto ret = _compressor->decompress(std::move(data));
+        _stats.uncompressed_bytes_received += ret.size;
+        return ret;
+    }
+
+    virtual sstring name() const override {
+        return _compressor->name();
+    }
+};
+
+class rpc_compression::counting_factory final : public rpc::compressor::factory {
+    std::unique_ptr<rpc::compressor::factory> _factory;
+    // Updated by the compressors negotiated by the factory
+    mutable rpc_compression_stats _stats;
+public:
+    explicit counting_factory(std::unique_ptr<rpc::compressor::factory> factory)
+        : _factory(std::move(factory))
+    { }
+
+    virtual const sstring& supported() const override {
+        return _factory->supported();
+    }
+
+    virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server) const override {
+        auto c = _factory->negotiate(std::move(feature), is_server);
+        if (!c) {
+            return nullptr;
+        }
+        return std::make_unique<counting_compressor>(std::move(c), _stats);
+    }
+
+    const rpc_compression_stats& stats() const {
+        return _stats;
+    }
+};
+
+const rpc::compressor::factory* rpc_compression::add(std::unique_ptr<rpc::compressor::factory> f, sstring algorithm) {
+    namespace sm = seastar::metrics;
+    static const sm::label algorithm_label("algorithm");
+    static const sm::label compressor_label("compressor");
+
+    auto& cf = *_counting_factories.emplace_back(std::make_unique<counting_factory>(std::move(f)));
+    auto labels = std::vector<sm::label_instance>{algorithm_label(algorithm), compressor_label(cf.supported())};
+    _metrics.add_group("rpc_compression", {
+        sm::make_derive("uncompressed_bytes_sent", [&cf] { return cf.stats().uncompressed_bytes_sent; },
+                sm::description("Counts the bytes of messages passed to compression before being sent."), labels),
+        sm::make_derive("compressed_bytes_sent", [&cf] { return cf.stats().compressed_bytes_sent; },
+                sm::description("Counts the bytes of messages sent after compression."), labels),
+        sm::make_derive("compressed_bytes_received", [&cf] { return cf.stats().compressed_bytes_received; },
+                sm::description("Counts the bytes of compressed messages received."), labels),
+        sm::make_derive("uncompressed_bytes_received", [&cf] { return cf.stats().uncompressed_bytes_received; },
+                sm::description("Counts the bytes of messages received after decompression."), labels),
+    });
+    return &cf;
+}
+
+rpc_compression::rpc_compression(rpc_compression_config cfg)
+    : _cfg(std::move(cfg))
+{
+    if (_cfg.zstd_dictionary) {
+        _dictionary = make_lw_shared<const zstd_dictionary>(*_cfg.zstd_dictionary, _cfg.zstd_level);
+    }
+
+    std::vector<const rpc::compressor::factory*> zstd;
+    if (_dictionary) {
+        zstd.push_back(add(std::make_unique<zstd_compressor_factory>(_cfg.zstd_level, _dictionary), "zstd"));
+    }
+    zstd.push_back(add(std::make_unique<zstd_compressor_factory>(_cfg.zstd_level, nullptr), "zstd"));
+    std::vector<const rpc::compressor::factory*> lz4 = {
+        add(std::make_unique<rpc::lz4_fragmented_compressor::factory>(), "lz4"),
+        add(std::make_unique<rpc::lz4_compressor::factory>(), "lz4"),
+    };
+
+    // Negotiation picks the first feature offered by the client which the
+    // server supports, so zstd clients fall back to lz4 with servers which
+    // don't know about zstd.
+    auto zstd_or_lz4 = zstd;
+    zstd_or_lz4.insert(zstd_or_lz4.end(), lz4.begin(), lz4.end());
+    _client_factories[size_t(rpc_compression_algorithm::lz4)] = std::make_unique<rpc::multi_algo_compressor_factory>(lz4);
+    _client_factories[size_t(rpc_compression_algorithm::zstd)] = std::make_unique<rpc::multi_algo_compressor_factory>(zstd_or_lz4);
+    _server_factory = std::make_unique<rpc::multi_algo_compressor_factory>(std::move(zstd_or_lz4));
+}
+
+rpc_compression::~rpc_compression() = default;
+
+rpc::compressor::factory* rpc_compression::client_factory(rpc_connection_group group) const {
+    return _client_factories[size_t(_cfg.algorithm(group))].get();
+}
+
+}
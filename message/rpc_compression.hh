@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <seastar/core/future.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/rpc/rpc_types.hh>
+
+#include "bytes.hh"
+#include "seastarx.hh"
+
+namespace netw {
+
+enum class rpc_compression_algorithm {
+    none,
+    lz4,
+    zstd,
+};
+
+// Groups of verbs sharing rpc connections, see messaging_service::get_rpc_client_idx().
+enum class rpc_connection_group {
+    gossip,
+    streaming,
+    statement,
+};
+
+struct rpc_compression_config {
+    // Algorithm clients ask for, by connection group. Servers accept all of them.
+    std::array<rpc_compression_algorithm, 3> algorithms = {
+        rpc_compression_algorithm::lz4,
+        rpc_compression_algorithm::lz4,
+        rpc_compression_algorithm::lz4,
+    };
+    int zstd_level = 1;
+    // Dictionary for zstd. It is only used on connections where both ends
+    // have the same one, otherwise zstd goes without.
+    std::optional<bytes> zstd_dictionary;
+
+    rpc_compression_algorithm algorithm(rpc_connection_group group) const {
+        return algorithms[size_t(group)];
+    }
+
+    // Parses internode_compression_algorithm: a comma-separated list of
+    // [group:]algorithm, where group is one of gossip, streaming and
+    // statement, and algorithm one of none, lz4 and zstd. An algorithm
+    // without a group applies to all groups. For instance "lz4,streaming:zstd".
+    // Throws std::invalid_argument.
+    static rpc_compression_config parse(std::string_view algorithms);
+};
+
+future<bytes> read_rpc_compression_dictionary(sstring path);
+
+class zstd_dictionary;
+
+// Compressor factories of a messaging_service.
+//
+// All compressors are wrapped to count the bytes they are given and the
+// bytes they produce, exported as metrics labelled with the algorithm.
+class rpc_compression {
+public:
+    class counting_factory;
+private:
+    rpc_compression_config _cfg;
+    lw_shared_ptr<const zstd_dictionary> _dictionary;
+    std::vector<std::unique_ptr<counting_factory>> _counting_factories;
+    // Offered by clients, by algorithm
+    std::array<std::unique_ptr<rpc::compressor::factory>, 3> _client_factories;
+    std::unique_ptr<rpc::compressor::factory> _server_factory;
+    seastar::metrics::metric_groups _metrics;
+private:
+    const rpc::compressor::factory* add(std::unique_ptr<rpc::compressor::factory> f, sstring algorithm);
+public:
+    explicit rpc_compression(rpc_compression_config cfg);
+    ~rpc_compression();
+
+    // Returns the factory for clients of the given connection group, or
+    // nullptr if they don't compress.
+    rpc::compressor::factory* client_factory(rpc_connection_group group) const;
+    rpc::compressor::factory& server_factory() const {
+        return *_server_factory;
+    }
+};
+
+}
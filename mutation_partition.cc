@@ -885,6 +885,50 @@ static void get_compacted_row_slice(const schema& s,
     }
 }
 
+// Whether the regular cells satisfy all the row filters of the slice.
+static bool satisfies_row_filters(const schema& s, const query::partition_slice& slice, const row& cells) {
+    for (auto& f : slice.row_filters) {
+        if (f.column >= s.regular_columns_count()) {
+            continue;
+        }
+        auto&& def = s.regular_column_at(f.column);
+        if (!def.is_atomic() || def.is_counter()) {
+            continue;
+        }
+        const atomic_cell_or_collection* cell = cells.find_cell(f.column);
+        if (!cell) {
+            return false;
+        }
+        auto c = cell->as_atomic_cell(def);
+        if (!c.is_live()) {
+            return false;
+        }
+        auto cmp = def.type->without_reversed().compare(c.value(), managed_bytes_view(bytes_view(f.value)));
+        bool satisfied = false;
+        switch (f.op) {
+        case query::row_filter_op::eq:
+            satisfied = cmp == 0;
+            break;
+        case query::row_filter_op::lt:
+            satisfied = cmp < 0;
+            break;
+        case query::row_filter_op::lte:
+            satisfied = cmp <= 0;
+            break;
+        case query::row_filter_op::gt:
+            satisfied = cmp > 0;
+            break;
+        case query::row_filter_op::gte:
+            satisfied = cmp >= 0;
+            break;
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool has_any_live_data(const schema& s, column_kind kind, const row& cells, tombstone tomb = tombstone(),
                        gc_clock::time_point now = gc_clock::time_point::min()) {
     bool any_live = false;
@@ -1872,6 +1916,7 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
         _pw.last_modified() = max_ts.max;
     }
 
+    const bool send_cells = satisfies_row_filters(_schema, slice, cr.cells());
     auto write_row = [&] (auto& rows_writer) {
         auto cells_wr = [&] {
             if (slice.options.contains(query::partition_slice::option::send_clustering_key)) {
@@ -1880,7 +1925,13 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
                 return rows_writer.add().skip_key().start_cells().start_cells();
             }
         }();
-        get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
+        if (send_cells) {
+            get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
+        } else {
+            for (size_t i = 0; i < slice.regular_columns.size(); ++i) {
+                cells_wr.add().skip();
+            }
+        }
         std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
     };
 
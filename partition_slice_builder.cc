@@ -32,6 +32,7 @@ partition_slice_builder::partition_slice_builder(const schema& schema, query::pa
     , _specific_ranges(std::move(slice._specific_ranges))
     , _schema(schema)
     , _options(std::move(slice.options))
+    , _row_filters(std::move(slice.row_filters))
 {
 }
 
@@ -69,7 +70,7 @@ partition_slice_builder::build() {
             _schema.regular_columns() | boost::adaptors::transformed(std::mem_fn(&column_definition::id)));
     }
 
-    return {
+    query::partition_slice slice{
         std::move(ranges),
         std::move(static_columns),
         std::move(regular_columns),
@@ -78,6 +79,8 @@ partition_slice_builder::build() {
         cql_serialization_format::internal(),
         _partition_row_limit,
     };
+    slice.row_filters = std::move(_row_filters);
+    return slice;
 }
 
 partition_slice_builder&
@@ -24,6 +24,7 @@
 #include "partition_version.hh"
 #include "row_cache.hh"
 #include "utils/small_vector.hh"
+#include <boost/dynamic_bitset.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/range/algorithm/heap_algorithm.hpp>
 
@@ -352,6 +353,35 @@ class partition_snapshot_row_cursor final {
         return cr;
     }
 
+    // Can be called only when cursor is valid and pointing at a row.
+    //
+    // Like row(), but leaves out the regular cells of the columns not in
+    // the set, except for those which may be what makes the row live. Only
+    // rows with a live marker which doesn't expire have cells left out, and
+    // only cells not newer than the marker, which is covered by no tombstone
+    // not covering them as well.
+    clustering_row row(const boost::dynamic_bitset<uint64_t>& columns) const {
+        row_marker marker;
+        consume_row([&] (const deletable_row& r) {
+            marker.apply(r.marker());
+        });
+        if (!marker.is_live() || marker.is_expiring()) {
+            return row();
+        }
+        clustering_row cr(key());
+        consume_row([&] (const deletable_row& r) {
+            cr.apply(_schema, deletable_row(r.deleted_at(), row_marker(r.marker()), ::row()));
+            r.cells().for_each_cell([&] (column_id id, const cell_and_hash& c_a_h) {
+                const column_definition& def = _schema.regular_column_at(id);
+                if (!columns.test(id) && def.is_atomic() && c_a_h.cell.as_atomic_cell(def).timestamp() <= marker.timestamp()) {
+                    return;
+                }
+                cr.cells().apply(def, c_a_h.cell, c_a_h.hash);
+            });
+        });
+        return cr;
+    }
+
     // Can be called only when cursor is valid and pointing at a row.
     deletable_row& latest_row() const noexcept {
         return _current_row[0].it->row();
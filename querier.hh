@@ -155,6 +155,10 @@ class querier_base {
         return _slice->options.contains(query::partition_slice::option::reversed);
     }
 
+    const query::partition_slice& slice() const {
+        return *_slice;
+    }
+
     virtual position_view current_position() const = 0;
 
     dht::partition_ranges_view ranges() const {
@@ -31,6 +31,7 @@
 #include "tracing/tracing.hh"
 #include "utils/small_vector.hh"
 #include "query_class_config.hh"
+#include "db/consistency_level_type.hh"
 
 class position_in_partition_view;
 class partition_slice_builder;
@@ -141,6 +142,22 @@ constexpr auto max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto partition_max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto max_rows_if_set = std::numeric_limits<uint32_t>::max();
 
+enum class row_filter_op : uint8_t {
+    eq = 0,
+    lt = 1,
+    lte = 2,
+    gt = 3,
+    gte = 4,
+};
+
+// A comparison of the cell of a regular column with a value, see
+// partition_slice::row_filters.
+struct row_filter {
+    column_id column;
+    row_filter_op op;
+    bytes value;
+};
+
 // Specifies subset of rows, columns and cell attributes to be returned in a query.
 // Can be accessed across cores.
 // Schema-dependent.
@@ -174,6 +191,11 @@ class partition_slice {
         // directly, bypassing the intermediate reconcilable_result format used
         // in pre 4.5 range scans.
         range_scan_data_variant,
+        // Set by replicas on the slices of the data queries they serve, never
+        // sent: rows may be read without the cells of the regular columns not
+        // selected, when that doesn't change the result (see read_context).
+        // Mutation and digest reads get whole rows.
+        project_regular_columns,
     };
     using option_set = enum_set<super_enum<option,
         option::send_clustering_key,
@@ -188,12 +210,21 @@ class partition_slice {
         option::with_digest,
         option::bypass_cache,
         option::always_return_static_content,
-        option::range_scan_data_variant>>;
+        option::range_scan_data_variant,
+        option::project_regular_columns>>;
     clustering_row_ranges _row_ranges;
 public:
     column_id_vector static_columns; // TODO: consider using bitmap
     column_id_vector regular_columns;  // TODO: consider using bitmap
     option_set options;
+    // The rows of the results of data queries which don't satisfy all the row
+    // filters are returned without their cells, so that the cells aren't
+    // serialized, transferred and parsed only for the coordinator to drop the
+    // rows when filtering them. The rows are still returned, so that limits,
+    // paging and digests are the same with and without row filters. Only
+    // the coordinator can drop them, since they may be shadowed by the data
+    // of other replicas. Set for restrictions not satisfied by null cells.
+    std::vector<row_filter> row_filters;
 private:
     std::unique_ptr<specific_ranges> _specific_ranges;
     cql_serialization_format _cql_format;
@@ -205,7 +236,8 @@ class partition_slice {
         std::unique_ptr<specific_ranges> specific_ranges,
         cql_serialization_format,
         uint32_t partition_row_limit_low_bits,
-        uint32_t partition_row_limit_high_bits);
+        uint32_t partition_row_limit_high_bits,
+        std::vector<row_filter> row_filters = {});
     partition_slice(clustering_row_ranges row_ranges, column_id_vector static_columns,
         column_id_vector regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges = nullptr,
@@ -372,4 +404,32 @@ class read_command {
     friend std::ostream& operator<<(std::ostream& out, const read_command& r);
 };
 
+
+// Describes a full-scan aggregation that a coordinator splits among replicas
+// (and replica shards) and whose partial results it then merges. The
+// replicas compute each aggregation over their part of `pr` and return the
+// partial values in the same order as `aggregations`.
+struct forward_request {
+    // A single reducible aggregate function applied to the selected columns.
+    // `name` is the name of a native aggregate function (e.g. "sum") and
+    // `column_names` are the (case-preserved) names of its argument columns.
+    struct aggregation_info {
+        sstring name;
+        std::vector<sstring> column_names;
+    };
+
+    std::vector<aggregation_info> aggregations;
+    query::read_command cmd;
+    dht::partition_range_vector pr;
+    db::consistency_level cl;
+};
+
+std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_info& a);
+std::ostream& operator<<(std::ostream& out, const forward_request& r);
+
+// Partial results of a forward_request, one value per requested aggregation.
+struct forward_result {
+    std::vector<bytes_opt> query_results;
+};
+
 }
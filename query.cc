@@ -56,6 +56,9 @@ std::ostream& operator<<(std::ostream& out, const partition_slice& ps) {
     out << ", options=" << format("{:x}", ps.options.mask()); // FIXME: pretty print options
     out << ", cql_format=" << ps.cql_format();
     out << ", partition_row_limit=" << ps.partition_row_limit();
+    if (!ps.row_filters.empty()) {
+        out << ", row_filters=" << ps.row_filters.size();
+    }
     return out << "}";
 }
 
@@ -73,6 +76,19 @@ std::ostream& operator<<(std::ostream& out, const read_command& r) {
         << "}";
 }
 
+std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_info& a) {
+    return out << a.name << "(" << join(", ", a.column_names) << ")";
+}
+
+std::ostream& operator<<(std::ostream& out, const forward_request& r) {
+    return out << "forward_request{"
+        << "aggregations=[" << join(", ", r.aggregations) << "]"
+        << ", cmd=" << r.cmd
+        << ", pr=[" << join(", ", r.pr) << "]"
+        << ", cl=" << r.cl
+        << "}";
+}
+
 std::ostream& operator<<(std::ostream& out, const specific_ranges& s) {
     return out << "{" << s._pk << " : " << join(", ", s._ranges) << "}";
 }
@@ -177,11 +193,13 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     std::unique_ptr<specific_ranges> specific_ranges,
     cql_serialization_format cql_format,
     uint32_t partition_row_limit_low_bits,
-    uint32_t partition_row_limit_high_bits)
+    uint32_t partition_row_limit_high_bits,
+    std::vector<row_filter> row_filters)
     : _row_ranges(std::move(row_ranges))
     , static_columns(std::move(static_columns))
     , regular_columns(std::move(regular_columns))
     , options(options)
+    , row_filters(std::move(row_filters))
     , _specific_ranges(std::move(specific_ranges))
     , _cql_format(std::move(cql_format))
     , _partition_row_limit_low_bits(partition_row_limit_low_bits)
@@ -225,6 +243,7 @@ partition_slice::partition_slice(const partition_slice& s)
     , static_columns(s.static_columns)
     , regular_columns(s.regular_columns)
     , options(s.options)
+    , row_filters(s.row_filters)
     , _specific_ranges(s._specific_ranges ? std::make_unique<specific_ranges>(*s._specific_ranges) : nullptr)
     , _cql_format(s._cql_format)
     , _partition_row_limit_low_bits(s._partition_row_limit_low_bits)
@@ -28,6 +28,8 @@
 #include "tracing/tracing.hh"
 #include "row_cache.hh"
 
+#include <boost/dynamic_bitset.hpp>
+
 namespace cache {
 
 /*
@@ -157,6 +159,10 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     std::optional<dht::decorated_key> _key;
     bool _partition_exists;
     row_cache::phase_type _phase;
+    // The regular columns of the slice, when it doesn't have all of them and
+    // allows it. Rows are copied out of cache without the other columns when
+    // possible.
+    std::optional<boost::dynamic_bitset<uint64_t>> _projected_columns;
 public:
     read_context(row_cache& cache,
             schema_ptr schema,
@@ -181,6 +187,13 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
         if (!_range_query) {
             _key = range.start()->value().as_decorated_key();
         }
+        if (_slice.options.contains<query::partition_slice::option::project_regular_columns>()
+                && _slice.regular_columns.size() < _schema->regular_columns_count()) {
+            _projected_columns.emplace(_schema->regular_columns_count());
+            for (column_id id : _slice.regular_columns) {
+                _projected_columns->set(id);
+            }
+        }
     }
     ~read_context() {
         ++_cache._tracker._stats.reads_done;
@@ -207,6 +220,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     bool partition_exists() const { return _partition_exists; }
     void on_underlying_created() { ++_underlying_created; }
     bool digest_requested() const { return _slice.options.contains<query::partition_slice::option::with_digest>(); }
+    const std::optional<boost::dynamic_bitset<uint64_t>>& projected_columns() const { return _projected_columns; }
 public:
     future<> ensure_underlying() {
         if (_underlying_snapshot) {
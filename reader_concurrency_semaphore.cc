@@ -21,6 +21,8 @@
 
 #include <seastar/core/seastar.hh>
 #include <seastar/core/print.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/util/defer.hh>
 #include <seastar/util/lazy.hh>
 #include <seastar/util/log.hh>
 #include <seastar/core/coroutine.hh>
@@ -31,6 +33,7 @@
 #include "schema.hh"
 #include "utils/human_readable.hh"
 #include "flat_mutation_reader.hh"
+#include "utils/histogram_metrics_helper.hh"
 
 logger rcslog("reader_concurrency_semaphore");
 
@@ -95,6 +98,10 @@ class reader_permit::impl
     bool _marked_as_blocked = false;
     db::timeout_clock::time_point _timeout;
     query::max_result_size _max_result_size{query::result_memory_limiter::unlimited_result_size};
+    // Charged with the memory consumed by the permit, set on admission.
+    reader_concurrency_semaphore::wait_class* _wait_class = nullptr;
+    tracing::latency_breakdown _latency_breakdown;
+    bool _latency_breakdown_enabled = false;
 
 private:
     void on_permit_used() {
@@ -152,6 +159,10 @@ class reader_permit::impl
         _semaphore.on_permit_created(*this);
     }
     ~impl() {
+        if (_wait_class) {
+            --_wait_class->permits;
+        }
+
         if (_base_resources_consumed) {
             signal(_base_resources);
         }
@@ -234,6 +245,9 @@ class reader_permit::impl
     void consume(reader_resources res) {
         _resources += res;
         _semaphore.consume(res);
+        if (_wait_class && res.memory > 0) {
+            _wait_class->virtual_time += res.memory;
+        }
     }
 
     void signal(reader_resources res) {
@@ -249,6 +263,18 @@ class reader_permit::impl
         return _base_resources;
     }
 
+    reader_concurrency_semaphore::wait_class* wait_class() const {
+        return _wait_class;
+    }
+
+    void set_wait_class(reader_concurrency_semaphore::wait_class& c) {
+        if (_wait_class) {
+            --_wait_class->permits;
+        }
+        _wait_class = &c;
+        ++c.permits;
+    }
+
     sstring description() const {
         return format("{}.{}:{}",
                 _schema ? _schema->ks_name() : "*",
@@ -330,6 +356,18 @@ class reader_permit::impl
     void set_max_result_size(query::max_result_size s) {
         _max_result_size = std::move(s);
     }
+
+    tracing::latency_breakdown& latency_breakdown() noexcept {
+        return _latency_breakdown;
+    }
+
+    void enable_latency_breakdown() noexcept {
+        _latency_breakdown_enabled = true;
+    }
+
+    bool latency_breakdown_enabled() const noexcept {
+        return _latency_breakdown_enabled;
+    }
 };
 
 static_assert(std::is_nothrow_copy_constructible_v<reader_permit>);
@@ -430,6 +468,18 @@ void reader_permit::set_max_result_size(query::max_result_size s) {
     _impl->set_max_result_size(std::move(s));
 }
 
+tracing::latency_breakdown& reader_permit::latency_breakdown() const noexcept {
+    return _impl->latency_breakdown();
+}
+
+void reader_permit::enable_latency_breakdown() noexcept {
+    _impl->enable_latency_breakdown();
+}
+
+bool reader_permit::latency_breakdown_enabled() const noexcept {
+    return _impl->latency_breakdown_enabled();
+}
+
 std::ostream& operator<<(std::ostream& os, reader_permit::state s) {
     switch (s) {
         case reader_permit::state::waiting:
@@ -633,11 +683,12 @@ void reader_concurrency_semaphore::signal(const resources& r) noexcept {
 reader_concurrency_semaphore::reader_concurrency_semaphore(int count, ssize_t memory, sstring name, size_t max_queue_length)
     : _initial_resources(count, memory)
     , _resources(count, memory)
-    , _wait_list(expiry_handler(*this))
     , _ready_list(max_queue_length)
     , _name(std::move(name))
     , _max_queue_length(max_queue_length)
-{ }
+{
+    _default_wait_class = &_wait_classes.try_emplace("*", *this, "*").first->second;
+}
 
 reader_concurrency_semaphore::reader_concurrency_semaphore(no_limits, sstring name)
     : reader_concurrency_semaphore(
@@ -665,9 +716,9 @@ reader_concurrency_semaphore::inactive_read_handle reader_concurrency_semaphore:
     permit_impl.on_register_as_inactive();
     // Implies _inactive_reads.empty(), we don't queue new readers before
     // evicting all inactive reads.
-    // Checking the _wait_list covers the count resources only, so check memory
+    // Checking the wait lists covers the count resources only, so check memory
     // separately.
-    if (_wait_list.empty() && _resources.memory > 0) {
+    if (!has_waiters() && _resources.memory > 0) {
       try {
         auto irp = std::make_unique<inactive_read>(std::move(reader));
         auto& ir = *irp;
@@ -816,7 +867,7 @@ bool reader_concurrency_semaphore::all_used_permits_are_stalled() const {
 }
 
 std::exception_ptr reader_concurrency_semaphore::check_queue_size(std::string_view queue_name) {
-    if ((_wait_list.size() + _ready_list.size()) >= _max_queue_length) {
+    if ((waiters() + _ready_list.size()) >= _max_queue_length) {
         _stats.total_reads_shed_due_to_overload++;
         maybe_dump_reader_permit_diagnostics(*this, _permit_list, fmt::format("{} queue overload", queue_name));
         return std::make_exception_ptr(std::runtime_error(format("{}: {} queue overload", _name, queue_name)));
@@ -832,7 +883,12 @@ future<> reader_concurrency_semaphore::enqueue_waiter(reader_permit permit, read
     auto fut = pr.get_future();
     permit.on_waiting();
     auto timeout = permit.timeout();
-    _wait_list.push_back(entry(std::move(pr), std::move(permit), std::move(func)), timeout);
+    auto& c = get_wait_class(permit);
+    if (c.wait_list.empty()) {
+        c.virtual_time = std::max(c.virtual_time, _virtual_time);
+    }
+    c.wait_list.push_back(entry(std::move(pr), std::move(permit), std::move(func)), timeout);
+    ++c.stats.reads_enqueued;
     ++_stats.reads_enqueued;
     return fut;
 }
@@ -841,8 +897,8 @@ void reader_concurrency_semaphore::evict_readers_in_background() {
     // Evict inactive readers in the background while wait list isn't empty
     // This is safe since stop() closes _gate;
     (void)with_gate(_close_readers_gate, [this] {
-        return do_until([this] { return _wait_list.empty() || _inactive_reads.empty(); }, [this] {
-            return detach_inactive_reader(_inactive_reads.front(), evict_reason::permit).close();
+        return do_until([this] { return !has_waiters() || _inactive_reads.empty(); }, [this] {
+            return detach_inactive_reader(inactive_read_to_evict(), evict_reason::permit).close();
         });
     });
  }
@@ -851,7 +907,7 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
     if (!_execution_loop_future) {
         _execution_loop_future.emplace(execution_loop());
     }
-    if (!_wait_list.empty() || !_ready_list.empty()) {
+    if (has_waiters() || !_ready_list.empty()) {
         return enqueue_waiter(std::move(permit), std::move(func));
     }
 
@@ -867,8 +923,7 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
         return enqueue_waiter(std::move(permit), std::move(func));
     }
 
-    permit.on_admission();
-    ++_stats.reads_admitted;
+    on_admission(get_wait_class(permit), permit);
     if (func) {
         return with_ready_permit(std::move(permit), std::move(func));
     }
@@ -876,11 +931,23 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
 }
 
 void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
-    while (!_wait_list.empty() && _ready_list.empty() && has_available_units(_wait_list.front().permit.base_resources()) && all_used_permits_are_stalled()) {
-        auto& x = _wait_list.front();
+    // Permits released while admitting (e.g. by popping the entries) signal
+    // the semaphore again, leave the admission to the outer loop, which must
+    // not have its class erased from under it.
+    if (_admitting_waiters) {
+        return;
+    }
+    _admitting_waiters = true;
+    auto reset_admitting = defer([this] () noexcept { _admitting_waiters = false; });
+    wait_class* c;
+    while ((c = next_wait_class()) && _ready_list.empty() && has_available_units(c->wait_list.front().permit.base_resources()) && all_used_permits_are_stalled()) {
+        auto& x = c->wait_list.front();
         try {
-            x.permit.on_admission();
-            ++_stats.reads_admitted;
+            auto wait_time = utils::time_estimated_histogram::clock::now() - x.enqueued_at;
+            ++c->stats.reads_admitted;
+            c->stats.wait_time.add(wait_time);
+            x.permit._impl->latency_breakdown().admission_wait += wait_time;
+            on_admission(*c, x.permit);
             if (x.func) {
                 _ready_list.push(std::move(x));
             } else {
@@ -889,7 +956,116 @@ void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
         } catch (...) {
             x.pr.set_exception(std::current_exception());
         }
-        _wait_list.pop_front();
+        c->wait_list.pop_front();
+    }
+    prune_wait_classes();
+}
+
+void reader_concurrency_semaphore::on_admission(wait_class& c, reader_permit& permit) {
+    _virtual_time = std::max(_virtual_time, c.virtual_time);
+    // Charges the base resources to the class.
+    permit._impl->set_wait_class(c);
+    permit.on_admission();
+    ++_stats.reads_admitted;
+}
+
+reader_concurrency_semaphore::wait_class& reader_concurrency_semaphore::get_wait_class(const reader_permit& permit) {
+    auto* s = permit._impl->get_schema();
+    if (!_fair_queuing() || !s) {
+        return *_default_wait_class;
+    }
+    auto [it, inserted] = _wait_classes.try_emplace(s->ks_name(), *this, s->ks_name());
+    if (inserted && _metrics_registered) {
+        register_metrics(it->second);
+    }
+    return it->second;
+}
+
+void reader_concurrency_semaphore::prune_wait_classes() noexcept {
+    for (auto it = _wait_classes.begin(); it != _wait_classes.end();) {
+        if (&it->second != _default_wait_class && it->second.wait_list.empty() && !it->second.permits) {
+            it = _wait_classes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+reader_concurrency_semaphore::wait_class* reader_concurrency_semaphore::next_wait_class() noexcept {
+    wait_class* next = nullptr;
+    for (auto& [name, c] : _wait_classes) {
+        if (!c.wait_list.empty() && (!next || c.virtual_time < next->virtual_time)) {
+            next = &c;
+        }
+    }
+    return next;
+}
+
+bool reader_concurrency_semaphore::has_waiters() const noexcept {
+    return std::any_of(_wait_classes.begin(), _wait_classes.end(), [] (const auto& c) {
+        return !c.second.wait_list.empty();
+    });
+}
+
+size_t reader_concurrency_semaphore::waiters() const {
+    size_t n = 0;
+    for (auto& [name, c] : _wait_classes) {
+        n += c.wait_list.size();
+    }
+    return n;
+}
+
+reader_concurrency_semaphore::inactive_read& reader_concurrency_semaphore::inactive_read_to_evict() noexcept {
+    // Evict the oldest inactive read of the class which consumed the most.
+    auto* victim = &_inactive_reads.front();
+    // The classes of the reads admitted before fair queuing was turned off
+    // stay around until they are released, don't let them pick the victim.
+    if (!_fair_queuing() || _wait_classes.size() == 1) {
+        return *victim;
+    }
+    auto virtual_time = [] (const inactive_read& ir) {
+        auto* c = ir.reader.permit()._impl->wait_class();
+        return c ? c->virtual_time : 0.0;
+    };
+    auto max_virtual_time = virtual_time(*victim);
+    for (auto& ir : _inactive_reads) {
+        if (auto vt = virtual_time(ir); vt > max_virtual_time) {
+            victim = &ir;
+            max_virtual_time = vt;
+        }
+    }
+    return *victim;
+}
+
+void reader_concurrency_semaphore::register_metrics() {
+    _metrics_registered = true;
+    for (auto& [name, c] : _wait_classes) {
+        register_metrics(c);
+    }
+}
+
+void reader_concurrency_semaphore::register_metrics(wait_class& c) {
+    namespace sm = seastar::metrics;
+    static const sm::label semaphore_label("semaphore");
+    static const sm::label wait_class_label("wait_class");
+    auto semaphore_label_instance = semaphore_label(_name);
+    auto wait_class_label_instance = wait_class_label(c.name);
+    const std::vector<sm::label_instance> labels{semaphore_label_instance, wait_class_label_instance};
+    c.metrics.add_group("reader_concurrency_semaphore", {
+        sm::make_derive("reads_enqueued", c.stats.reads_enqueued,
+                sm::description("Number of reads of the class which had to wait for admission."), labels),
+        sm::make_derive("reads_admitted", c.stats.reads_admitted,
+                sm::description("Number of reads of the class admitted after waiting."), labels),
+        sm::make_gauge("queued_reads", [&c] { return c.wait_list.size(); },
+                sm::description("Number of reads of the class currently waiting for admission."), labels),
+        sm::make_histogram("wait_latency", sm::description("Histogram of the time reads of the class waited for admission."),
+                [&c] { return to_metrics_histogram(c.stats.wait_time); })(semaphore_label_instance)(wait_class_label_instance),
+    });
+}
+
+void reader_concurrency_semaphore::for_each_wait_class(noncopyable_function<void(std::string_view, const wait_class_stats&)> func) const {
+    for (auto& [name, c] : _wait_classes) {
+        func(name, c.stats);
     }
 }
 
@@ -971,9 +1147,11 @@ void reader_concurrency_semaphore::broken(std::exception_ptr ex) {
     if (!ex) {
         ex = std::make_exception_ptr(broken_semaphore{});
     }
-    while (!_wait_list.empty()) {
-        _wait_list.front().pr.set_exception(ex);
-        _wait_list.pop_front();
+    for (auto& [name, c] : _wait_classes) {
+        while (!c.wait_list.empty()) {
+            c.wait_list.front().pr.set_exception(ex);
+            c.wait_list.pop_front();
+        }
     }
 }
 
@@ -1010,11 +1188,11 @@ class tracking_file_impl : public file_impl {
     }
 
     virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->read_dma(pos, buffer, len, pc);
+        return timed(get_file_impl(_tracked_file)->read_dma(pos, buffer, len, pc));
     }
 
     virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->read_dma(pos, iov, pc);
+        return timed(get_file_impl(_tracked_file)->read_dma(pos, iov, pc));
     }
 
     virtual future<> flush(void) override {
@@ -1054,10 +1232,30 @@ class tracking_file_impl : public file_impl {
     }
 
     virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
-        return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, units = _permit.consume_memory(range_size)] (temporary_buffer<uint8_t> buf) {
+        return timed(get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc)).then([this, units = _permit.consume_memory(range_size)] (temporary_buffer<uint8_t> buf) {
             return make_ready_future<temporary_buffer<uint8_t>>(make_tracked_temporary_buffer(std::move(buf), _permit));
         });
     }
+
+private:
+    // Accounts the time until the read resolves to the latency breakdown of the permit,
+    // if enabled.
+    template <typename T>
+    future<T> timed(future<T> f) {
+        if (!_permit.latency_breakdown_enabled()) {
+            return f;
+        }
+        if (f.available()) {
+            ++_permit.latency_breakdown().disk_reads;
+            return f;
+        }
+        auto start = tracing::latency_breakdown::clock::now();
+        return f.finally([this, start] {
+            auto& lb = _permit.latency_breakdown();
+            lb.disk_wait += tracing::latency_breakdown::clock::now() - start;
+            ++lb.disk_reads;
+        });
+    }
 };
 
 file make_tracked_file(file f, reader_permit p) {
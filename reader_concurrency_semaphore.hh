@@ -21,11 +21,15 @@
 
 #pragma once
 
+#include <map>
 #include <boost/intrusive/list.hpp>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
 #include "reader_permit.hh"
 #include "flat_mutation_reader.hh"
+#include "utils/estimated_histogram.hh"
+#include "utils/updateable_value.hh"
 
 namespace bi = boost::intrusive;
 
@@ -40,7 +44,7 @@ using namespace seastar;
 /// The semaphore can be configured with the desired limits on
 /// construction. New readers will only be admitted when there is both
 /// enough count and memory units available. Readers are admitted in
-/// FIFO order.
+/// FIFO order, unless fair queuing is enabled, see \ref set_fair_queuing().
 /// Semaphore's `name` must be provided in ctor and its only purpose is
 /// to increase readability of exceptions: both timeout exceptions and
 /// queue overflow exceptions (read below) include this `name` in messages.
@@ -105,13 +109,23 @@ class reader_concurrency_semaphore {
 
     using read_func = noncopyable_function<future<>(reader_permit)>;
 
+    struct wait_class_stats {
+        // Total number of reads of the class enqueued to wait for admission.
+        uint64_t reads_enqueued = 0;
+        // Total number of reads of the class admitted from the wait queue.
+        uint64_t reads_admitted = 0;
+        // Time the reads admitted from the wait queue waited.
+        utils::time_estimated_histogram wait_time;
+    };
+
 private:
     struct entry {
         promise<> pr;
         reader_permit permit;
         read_func func;
+        utils::time_estimated_histogram::clock::time_point enqueued_at;
         entry(promise<>&& pr, reader_permit permit, read_func func)
-            : pr(std::move(pr)), permit(std::move(permit)), func(std::move(func)) {}
+            : pr(std::move(pr)), permit(std::move(permit)), func(std::move(func)), enqueued_at(utils::time_estimated_histogram::clock::now()) {}
     };
 
     class expiry_handler {
@@ -137,6 +151,26 @@ class reader_concurrency_semaphore {
 
     using inactive_reads_type = bi::list<inactive_read, bi::constant_time_size<false>>;
 
+    using wait_list_type = expiring_fifo<entry, expiry_handler, db::timeout_clock>;
+
+    // The reads of a class wait for admission in FIFO order, classes are
+    // admitted from in start-time fair queuing order: by their virtual time,
+    // which advances with the memory consumed by their admitted reads.
+    struct wait_class {
+        sstring name;
+        wait_list_type wait_list;
+        double virtual_time = 0;
+        // Admitted permits charged to the class, see prune_wait_classes().
+        uint64_t permits = 0;
+        wait_class_stats stats;
+        seastar::metrics::metric_groups metrics;
+
+        wait_class(reader_concurrency_semaphore& semaphore, sstring name)
+            : name(std::move(name))
+            , wait_list(expiry_handler(semaphore))
+        { }
+    };
+
 public:
     class inactive_read_handle {
         reader_concurrency_semaphore* _sem = nullptr;
@@ -184,7 +218,16 @@ class reader_concurrency_semaphore {
     const resources _initial_resources;
     resources _resources;
 
-    expiring_fifo<entry, expiry_handler, db::timeout_clock> _wait_list;
+    // By keyspace, with fair queuing, see get_wait_class().
+    std::map<sstring, wait_class> _wait_classes;
+    wait_class* _default_wait_class;
+    // The highest virtual time of the classes at the admission of their reads.
+    // Classes starting to wait are brought up to it, so they can't make up
+    // for the time they didn't read.
+    double _virtual_time = 0;
+    utils::updateable_value<bool> _fair_queuing{false};
+    bool _metrics_registered = false;
+    bool _admitting_waiters = false;
     queue<entry> _ready_list;
 
     sstring _name;
@@ -203,6 +246,17 @@ class reader_concurrency_semaphore {
 
     bool has_available_units(const resources& r) const;
 
+    wait_class& get_wait_class(const reader_permit& permit);
+    // The class to admit from next, nullptr if there are no waiters.
+    wait_class* next_wait_class() noexcept;
+    void register_metrics(wait_class& c);
+    void on_admission(wait_class& c, reader_permit& permit);
+    // Erase the classes (except the default one) which have neither waiters
+    // nor admitted permits, e.g. the ones of dropped keyspaces.
+    void prune_wait_classes() noexcept;
+    bool has_waiters() const noexcept;
+    inactive_read& inactive_read_to_evict() noexcept;
+
     bool all_used_permits_are_stalled() const;
 
     [[nodiscard]] std::exception_ptr check_queue_size(std::string_view queue_name);
@@ -416,10 +470,26 @@ class reader_concurrency_semaphore {
 
     void signal(const resources& r) noexcept;
 
-    size_t waiters() const {
-        return _wait_list.size();
+    size_t waiters() const;
+
+    /// Enable or disable fair queuing of the reads waiting for admission.
+    ///
+    /// With fair queuing, waiting reads are grouped into classes by the
+    /// keyspace of their table. The class whose admitted reads consumed the
+    /// least memory is admitted from first, and inactive reads are evicted
+    /// from the class whose reads consumed the most memory first, instead of
+    /// the oldest inactive read. Without it, all reads wait in one class.
+    void set_fair_queuing(utils::updateable_value<bool> enabled) {
+        _fair_queuing = std::move(enabled);
     }
 
+    /// Register the per wait class metrics, labelled with the name of the
+    /// semaphore and that of the class.
+    void register_metrics();
+
+    /// Calls func with the name and the statistics of each wait class.
+    void for_each_wait_class(noncopyable_function<void(std::string_view, const wait_class_stats&)> func) const;
+
     void broken(std::exception_ptr ex = {});
 
     /// Dump diagnostics printout
@@ -27,6 +27,7 @@
 #include "db/timeout_clock.hh"
 #include "schema_fwd.hh"
 #include "query_class_config.hh"
+#include "tracing/latency_breakdown.hh"
 
 namespace seastar {
     class file;
@@ -169,6 +170,14 @@ class reader_permit {
 
     query::max_result_size max_result_size() const;
     void set_max_result_size(query::max_result_size);
+
+    // Where the time of the read went so far, on this replica.
+    tracing::latency_breakdown& latency_breakdown() const noexcept;
+    // Disk reads are only timed for the permits of reads which asked for
+    // their latency breakdown, the rest only account the admission wait and
+    // the cache misses, which come for free.
+    void enable_latency_breakdown() noexcept;
+    bool latency_breakdown_enabled() const noexcept;
 };
 
 using reader_permit_opt = optimized_optional<reader_permit>;
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdexcept>
+
+#include <seastar/core/format.hh>
+
+#include "repair/hash_sketch.hh"
+
+// The splitmix64 finalizer. Repair hashes are already seeded per repair, so
+// a fixed mix is enough to spread them over the cells.
+static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t check_hash(uint64_t hash) {
+    return mix(hash ^ 0x5851f42d4c957f2dULL);
+}
+
+size_t repair_hash_sketch::cells_for(size_t difference) {
+    // Decoding fails too often for small sketches of three sub-tables
+    // filled at their asymptotic threshold of 1.23 cells per hash, hence
+    // both the factor and the constant, which keep failures under 1%.
+    auto per_table = (difference * 2 + 32 + hash_count - 1) / hash_count;
+    return per_table * hash_count;
+}
+
+repair_hash_sketch::repair_hash_sketch(size_t cells)
+    : _cells(std::max<size_t>(cells / hash_count, 1) * hash_count)
+{
+}
+
+repair_hash_sketch::repair_hash_sketch(std::vector<cell> cells)
+    : _cells(std::move(cells))
+{
+    if (_cells.empty() || _cells.size() % hash_count) {
+        throw std::invalid_argument(seastar::format("repair_hash_sketch: invalid number of cells {}", _cells.size()));
+    }
+}
+
+size_t repair_hash_sketch::cell_index(uint64_t hash, unsigned i) const {
+    auto per_table = _cells.size() / hash_count;
+    return i * per_table + mix(hash + i) % per_table;
+}
+
+void repair_hash_sketch::update(uint64_t hash, int32_t count) {
+    auto check = check_hash(hash);
+    for (unsigned i = 0; i < hash_count; ++i) {
+        auto& c = _cells[cell_index(hash, i)];
+        c.count += count;
+        c.hash_sum ^= hash;
+        c.check_sum ^= check;
+    }
+}
+
+void repair_hash_sketch::subtract(const repair_hash_sketch& o) {
+    if (o._cells.size() != _cells.size()) {
+        throw std::invalid_argument(seastar::format("repair_hash_sketch: subtracting a sketch of {} cells from one of {}",
+                o._cells.size(), _cells.size()));
+    }
+    for (size_t i = 0; i < _cells.size(); ++i) {
+        _cells[i].count -= o._cells[i].count;
+        _cells[i].hash_sum ^= o._cells[i].hash_sum;
+        _cells[i].check_sum ^= o._cells[i].check_sum;
+    }
+}
+
+std::optional<repair_hash_sketch::difference> repair_hash_sketch::decode() && {
+    auto is_pure = [] (const cell& c) {
+        return (c.count == 1 || c.count == -1) && c.check_sum == check_hash(c.hash_sum);
+    };
+    std::vector<size_t> pure;
+    for (size_t i = 0; i < _cells.size(); ++i) {
+        if (is_pure(_cells[i])) {
+            pure.push_back(i);
+        }
+    }
+    difference diff;
+    while (!pure.empty()) {
+        auto& c = _cells[pure.back()];
+        pure.pop_back();
+        // Removing another hash may have made the cell impure again.
+        if (!is_pure(c)) {
+            continue;
+        }
+        auto hash = c.hash_sum;
+        auto count = c.count;
+        auto& side = count > 0 ? diff.local : diff.remote;
+        if (!side.insert(repair_hash(hash)).second) {
+            // A checksum collision made a cell look pure.
+            return std::nullopt;
+        }
+        update(hash, -count);
+        for (unsigned i = 0; i < hash_count; ++i) {
+            auto idx = cell_index(hash, i);
+            if (is_pure(_cells[idx])) {
+                pure.push_back(idx);
+            }
+        }
+    }
+    for (auto& c : _cells) {
+        if (c.count || c.hash_sum || c.check_sum) {
+            return std::nullopt;
+        }
+    }
+    return diff;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "repair/repair.hh"
+
+// Invertible Bloom lookup table of repair hashes.
+//
+// Each hash is added to one cell of each of hash_count equally sized
+// sub-tables, which keep the number of hashes added to them, and the xor of
+// the hashes and of a checksum of each. Subtracting the sketch of a peer
+// from the sketch of the local hashes, built with the same number of cells,
+// leaves the hashes present on only one side. These are decoded by
+// repeatedly removing the hashes found alone in a cell, which succeeds with
+// high probability when there are about twice as many cells as hashes left.
+// That way, peers which differ by a few rows exchange sketches sized to the
+// difference rather than all the hashes of their rows.
+class repair_hash_sketch {
+public:
+    static constexpr unsigned hash_count = 3;
+    using cell = repair_hash_sketch_cell;
+
+    struct difference {
+        // The hashes only added to the sketch subtracted from.
+        repair_hash_set local;
+        // The hashes only added to the sketch subtracted.
+        repair_hash_set remote;
+    };
+private:
+    std::vector<cell> _cells;
+private:
+    size_t cell_index(uint64_t hash, unsigned i) const;
+    void update(uint64_t hash, int32_t count);
+public:
+    // The number of cells of a sketch expected to decode a difference of
+    // up to the given number of hashes.
+    static size_t cells_for(size_t difference);
+
+    explicit repair_hash_sketch(size_t cells);
+    explicit repair_hash_sketch(std::vector<cell> cells);
+
+    void add(const repair_hash& h) {
+        update(h.hash, 1);
+    }
+
+    void add(const repair_hash_set& hashes) {
+        for (auto& h : hashes) {
+            add(h);
+        }
+    }
+
+    // Throws std::invalid_argument when the sketches have a different number of cells.
+    void subtract(const repair_hash_sketch& o);
+
+    // Returns the difference of the sketches subtracted, or std::nullopt if
+    // there are too many hashes left to tell them.
+    std::optional<difference> decode() &&;
+
+    size_t size() const {
+        return _cells.size();
+    }
+
+    // The size of the sketch on the wire.
+    size_t serialized_size() const {
+        return _cells.size() * (sizeof(cell::count) + sizeof(cell::hash_sum) + sizeof(cell::check_sum));
+    }
+
+    std::vector<cell> release() && {
+        return std::move(_cells);
+    }
+};
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "repair/range_digest_cache.hh"
+#include "database.hh"
+#include "utils/murmur_hash.hh"
+
+static std::optional<std::pair<dht::token, bool>> bound_key(const std::optional<dht::token_range::bound>& b) {
+    if (!b) {
+        return std::nullopt;
+    }
+    return std::pair(b->value(), b->is_inclusive());
+}
+
+bool repair_range_digest_cache::key::operator<(const key& o) const {
+    auto start = bound_key(range.start());
+    auto o_start = bound_key(o.range.start());
+    auto end = bound_key(range.end());
+    auto o_end = bound_key(o.range.end());
+    return std::tie(table, start, end) < std::tie(o.table, o_start, o_end);
+}
+
+repair_range_digest_cache::repair_range_digest_cache(size_t max_entries)
+    : _max_entries(max_entries)
+{
+}
+
+repair_range_digest_cache::fingerprint repair_range_digest_cache::fingerprint_of(const std::vector<int64_t>& sstable_generations) {
+    fingerprint fp;
+    utils::murmur_hash::hash3_x64_128(bytes_view(reinterpret_cast<const int8_t*>(sstable_generations.data()),
+            sstable_generations.size() * sizeof(int64_t)), 0, fp);
+    return fp;
+}
+
+std::optional<repair_range_digest_cache::source> repair_range_digest_cache::source_of(const table& t, table_schema_version schema_version, const dht::token_range& range) {
+    auto generations = t.sstable_generations_of(dht::to_partition_range(range));
+    if (!generations) {
+        return std::nullopt;
+    }
+    return source{schema_version, fingerprint_of(*generations)};
+}
+
+std::optional<repair_range_digest> repair_range_digest_cache::find(const key& k, const source& src) {
+    auto it = _entries.find(k);
+    if (it == _entries.end()) {
+        return std::nullopt;
+    }
+    if (!(it->second.src == src)) {
+        // The entry unlinks itself from the LRU.
+        _entries.erase(it);
+        return std::nullopt;
+    }
+    it->second.unlink();
+    _lru.push_back(it->second);
+    return it->second.digest;
+}
+
+void repair_range_digest_cache::insert(key k, repair_range_digest digest, source src) {
+    if (_max_entries == 0) {
+        return;
+    }
+    _entries.erase(k);
+    while (_entries.size() >= _max_entries && !_lru.empty()) {
+        _entries.erase(_entries.find(*_lru.front().k));
+    }
+    auto [it, inserted] = _entries.emplace(std::move(k), entry());
+    auto& e = it->second;
+    e.k = &it->first;
+    e.digest = digest;
+    e.src = std::move(src);
+    _lru.push_back(e);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <vector>
+#include <boost/intrusive/list.hpp>
+
+#include "dht/i_partitioner.hh"
+#include "repair/repair.hh"
+#include "schema.hh"
+#include "utils/UUID.hh"
+
+class table;
+
+// Digests of the ranges read in full by repairs on this shard, which let a
+// later repair find a range in sync without reading its rows.
+//
+// A repair reading all the rows of a range combines their hashes into a
+// digest of the range. It stays valid as long as the rows of the range
+// don't change, which the source of the rows tells: the schema version they
+// were read with, and the sstables which could hold some of them while no
+// memtable did. Any write, flush, compaction or streaming to the range
+// changes the latter, and invalidates the digest.
+//
+// Row hashes are seeded per repair, so the digests of two replicas only
+// compare when they were computed by the same repair, which is the case when
+// nothing changed on them since the last repair of the range. The repair
+// master then finds all the replicas with the same digest and skips the
+// range. Otherwise the range is repaired as usual, which refreshes the
+// digests.
+//
+// Per sstable digests wouldn't do: replicas with the same rows lay them out
+// differently in their sstables, and rows in several sstables of a replica
+// hash differently once merged.
+//
+// Entries are of a fixed size, the sstables of the source being kept as a
+// fingerprint of their generations, so the number of entries bounds the
+// memory of the cache.
+class repair_range_digest_cache {
+public:
+    // 128-bit hash of the sorted generations of the sstables of a source.
+    using fingerprint = std::array<uint64_t, 2>;
+
+    struct key {
+        utils::UUID table;
+        dht::token_range range;
+
+        bool operator<(const key& o) const;
+    };
+    struct source {
+        table_schema_version schema_version;
+        // Of the sstables which could hold rows of the range
+        fingerprint sstables;
+
+        bool operator==(const source& o) const {
+            return schema_version == o.schema_version && sstables == o.sstables;
+        }
+    };
+private:
+    using lru_hook = boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+    struct entry : public lru_hook {
+        const key* k = nullptr;
+        repair_range_digest digest;
+        source src;
+    };
+    using entries_type = std::map<key, entry>;
+
+    size_t _max_entries;
+    entries_type _entries;
+    // Least recently used first.
+    boost::intrusive::list<entry, boost::intrusive::constant_time_size<false>> _lru;
+public:
+    explicit repair_range_digest_cache(size_t max_entries);
+
+    static fingerprint fingerprint_of(const std::vector<int64_t>& sstable_generations);
+
+    // The source of the rows of the range in the table, read with the schema
+    // version, or std::nullopt if the memtables hold some of them.
+    static std::optional<source> source_of(const table& t, table_schema_version schema_version, const dht::token_range& range);
+
+    // Returns the digest of the range if its rows were read from the same
+    // source, and drops it otherwise.
+    std::optional<repair_range_digest> find(const key& k, const source& src);
+
+    void insert(key k, repair_range_digest digest, source src);
+
+    size_t size() const {
+        return _entries.size();
+    }
+};
@@ -147,6 +147,8 @@ std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo
         return out << "send_full_set";
     case row_level_diff_detect_algorithm::send_full_set_rpc_stream:
         return out << "send_full_set_rpc_stream";
+    case row_level_diff_detect_algorithm::send_sketch_rpc_stream:
+        return out << "send_sketch_rpc_stream";
     };
     return out << "unknown";
 }
@@ -638,6 +640,53 @@ void repair_info::check_in_abort() {
     }
 }
 
+void repair_info::record_sstables_at_start() {
+    started_at = db_clock::now();
+    for (auto& table_id : table_ids) {
+        try {
+            auto& generations = sstables_at_start[table_id];
+            for (auto& sst : *db.local().find_column_family(table_id).get_sstables()) {
+                generations.insert(sst->generation());
+            }
+        } catch (no_such_column_family&) {
+            sstables_at_start.erase(table_id);
+        }
+    }
+}
+
+future<> repair_info::mark_sstables_repaired() {
+    auto repaired_at = std::chrono::duration_cast<std::chrono::milliseconds>(started_at.time_since_epoch()).count();
+    for (auto& [table_id, generations] : sstables_at_start) {
+        table* t;
+        try {
+            t = &db.local().find_column_family(table_id);
+        } catch (no_such_column_family&) {
+            continue;
+        }
+        // Compaction mixes the repaired and unrepaired sstables of leveled
+        // tables, which would make the data marked repaired unrepaired again.
+        if (t->get_compaction_strategy().type() == sstables::compaction_strategy_type::leveled) {
+            continue;
+        }
+        // The data of the sstables written since the repair started, including
+        // those written by compactions, wasn't necessarily repaired. Shared
+        // sstables are left alone since each shard would only mark its copy,
+        // and staging ones since they are about to be moved.
+        // Compaction is disabled not to rewrite the statistics of sstables
+        // being deleted.
+        co_await t->get_compaction_manager().run_with_compaction_disabled(t, [t, &generations = generations, repaired_at] () -> future<> {
+            auto sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(*t->get_sstables()
+                    | boost::adaptors::filtered([&generations] (const sstables::shared_sstable& sst) {
+                return generations.contains(sst->generation()) && !sst->is_shared() && !sst->requires_view_building() && !sst->is_repaired();
+            }));
+            for (auto& sst : sstables) {
+                co_await sst->mutate_repaired_at(repaired_at);
+            }
+            rlogger.info("Marked {} sstables of {}.{} repaired at {}", sstables.size(), t->schema()->ks_name(), t->schema()->cf_name(), repaired_at);
+        });
+    }
+}
+
 repair_neighbors repair_info::get_repair_neighbors(const dht::token_range& range) {
     return neighbors.empty() ?
         repair_neighbors(get_neighbors(db.local(), keyspace, range, data_centers, hosts, ignore_nodes)) :
@@ -741,6 +790,10 @@ void repair_stats::add(const repair_stats& o) {
     rpc_call_nr += o.rpc_call_nr;
     tx_hashes_nr += o.tx_hashes_nr;
     rx_hashes_nr += o.rx_hashes_nr;
+    row_hash_sketch_decoded_nr += o.row_hash_sketch_decoded_nr;
+    row_hash_sketch_failed_nr += o.row_hash_sketch_failed_nr;
+    row_hash_sketch_bytes_saved += o.row_hash_sketch_bytes_saved;
+    range_digest_skipped_nr += o.range_digest_skipped_nr;
     tx_row_nr += o.tx_row_nr;
     rx_row_nr += o.rx_row_nr;
     tx_row_bytes += o.tx_row_bytes;
@@ -774,7 +827,7 @@ sstring repair_stats::get_stats() {
             row_from_disk_rows_per_sec[x.first] = 0;
         }
     }
-    return format("round_nr={}, round_nr_fast_path_already_synced={}, round_nr_fast_path_same_combined_hashes={}, round_nr_slow_path={}, rpc_call_nr={}, tx_hashes_nr={}, rx_hashes_nr={}, duration={} seconds, tx_row_nr={}, rx_row_nr={}, tx_row_bytes={}, rx_row_bytes={}, row_from_disk_bytes={}, row_from_disk_nr={}, row_from_disk_bytes_per_sec={} MiB/s, row_from_disk_rows_per_sec={} Rows/s, tx_row_nr_peer={}, rx_row_nr_peer={}",
+    return format("round_nr={}, round_nr_fast_path_already_synced={}, round_nr_fast_path_same_combined_hashes={}, round_nr_slow_path={}, rpc_call_nr={}, tx_hashes_nr={}, rx_hashes_nr={}, row_hash_sketch_decoded_nr={}, row_hash_sketch_failed_nr={}, row_hash_sketch_bytes_saved={}, range_digest_skipped_nr={}, duration={} seconds, tx_row_nr={}, rx_row_nr={}, tx_row_bytes={}, rx_row_bytes={}, row_from_disk_bytes={}, row_from_disk_nr={}, row_from_disk_bytes_per_sec={} MiB/s, row_from_disk_rows_per_sec={} Rows/s, tx_row_nr_peer={}, rx_row_nr_peer={}",
             round_nr,
             round_nr_fast_path_already_synced,
             round_nr_fast_path_same_combined_hashes,
@@ -782,6 +835,10 @@ sstring repair_stats::get_stats() {
             rpc_call_nr,
             tx_hashes_nr,
             rx_hashes_nr,
+            row_hash_sketch_decoded_nr,
+            row_hash_sketch_failed_nr,
+            row_hash_sketch_bytes_saved,
+            range_digest_skipped_nr,
             duration,
             tx_row_nr,
             rx_row_nr,
@@ -827,6 +884,10 @@ struct repair_options {
     // The node starting the repair must be in the data center; Issuing a
     // repair to a data center other than the named one returns an error.
     std::vector<sstring> data_centers;
+    // If incremental is true, only the sstables which weren't repaired yet
+    // are read, see sstable::is_repaired(). They are marked repaired by
+    // incremental repairs covering all the ranges of the node.
+    bool incremental = false;
 
     repair_options(std::unordered_map<sstring, sstring> options) {
         bool_opt(primary_range, options, PRIMARY_RANGE_KEY);
@@ -835,14 +896,7 @@ struct repair_options {
         list_opt(hosts, options, HOSTS_KEY);
         list_opt(ignore_nodes, options, IGNORE_NODES_KEY);
         list_opt(data_centers, options, DATACENTERS_KEY);
-        // We currently do not support incremental repair. We could probably
-        // ignore this option as it is just an optimization, but for now,
-        // let's make it an error.
-        bool incremental = false;
         bool_opt(incremental, options, INCREMENTAL_KEY);
-        if (incremental) {
-            throw std::runtime_error("unsupported incremental repair");
-        }
         // We do not currently support the distinction between "parallel" and
         // "sequential" repair, and operate the same for both.
         // We don't currently support "dc parallel" parallelism.
@@ -1005,8 +1059,13 @@ static future<> do_repair_ranges(lw_shared_ptr<repair_info> ri) {
 // same nodes as replicas.
 static future<> repair_ranges(lw_shared_ptr<repair_info> ri) {
     repair_tracker().add_repair_info(ri->id.id, ri);
+    if (ri->marks_sstables_repaired) {
+        ri->record_sstables_at_start();
+    }
     return do_repair_ranges(ri).then([ri] {
         ri->check_failed_ranges();
+        return ri->marks_sstables_repaired ? ri->mark_sstables_repaired() : make_ready_future<>();
+    }).then([ri] {
         repair_tracker().remove_repair_info(ri->id.id);
         return make_ready_future<>();
     }).handle_exception([ri] (std::exception_ptr eptr) {
@@ -1110,16 +1169,38 @@ int repair_service::do_repair_start(sstring keyspace, std::unordered_map<sstring
         ranges = std::move(intersections);
     }
 
+    if (options.incremental && !db.local().features().cluster_supports_incremental_repair()) {
+        throw std::runtime_error("Incremental repair is not supported by all the nodes of the cluster");
+    }
+    // Only incremental repairs mark the sstables, so that regular repairs
+    // don't rewrite their statistics. And only a repair of all the local
+    // ranges with all their replicas repairs all the data of the sstables.
+    bool marks_sstables_repaired = options.incremental
+            && options.ranges.empty() && !options.primary_range
+            && options.start_token.empty() && options.end_token.empty()
+            && options.data_centers.empty() && options.hosts.empty() && ignore_nodes.empty();
+
     std::vector<sstring> cfs =
         options.column_families.size() ? options.column_families : list_column_families(db.local(), keyspace);
     if (cfs.empty()) {
         rlogger.info("repair id {} completed successfully: no tables to repair", id);
         return id.id;
     }
+    // Leveled compaction can't keep repaired and unrepaired sstables apart
+    // without breaking the disjointness of its levels, so the sstables of
+    // leveled tables are never marked repaired.
+    if (options.incremental) {
+        for (auto& cf : cfs) {
+            auto& t = db.local().find_column_family(keyspace, cf);
+            if (t.get_compaction_strategy().type() == sstables::compaction_strategy_type::leveled) {
+                throw std::runtime_error(format("Incremental repair is not supported for {}.{}, which uses LeveledCompactionStrategy", keyspace, cf));
+            }
+        }
+    }
 
     // Do it in the background.
     (void)repair_tracker().run(id, [this, &db, id, keyspace = std::move(keyspace),
-            cfs = std::move(cfs), ranges = std::move(ranges), options = std::move(options), ignore_nodes = std::move(ignore_nodes)] () mutable {
+            cfs = std::move(cfs), ranges = std::move(ranges), options = std::move(options), ignore_nodes = std::move(ignore_nodes), marks_sstables_repaired] () mutable {
         auto participants = get_hosts_participating_in_repair(db.local(), keyspace, ranges, options.data_centers, options.hosts, ignore_nodes).get();
         std::vector<future<>> repair_results;
         repair_results.reserve(smp::count);
@@ -1157,11 +1238,14 @@ int repair_service::do_repair_start(sstring keyspace, std::unordered_map<sstring
 
         for (auto shard : boost::irange(unsigned(0), smp::count)) {
             auto f = container().invoke_on(shard, [keyspace, table_ids, id, ranges,
-                    data_centers = options.data_centers, hosts = options.hosts, ignore_nodes] (repair_service& local_repair) mutable {
+                    data_centers = options.data_centers, hosts = options.hosts, ignore_nodes,
+                    incremental = options.incremental, marks_sstables_repaired] (repair_service& local_repair) mutable {
                 _node_ops_metrics.repair_total_ranges_sum += ranges.size();
                 auto ri = make_lw_shared<repair_info>(local_repair,
                         std::move(keyspace), std::move(ranges), std::move(table_ids),
                         id, std::move(data_centers), std::move(hosts), std::move(ignore_nodes), streaming::stream_reason::repair, id.uuid);
+                ri->incremental = incremental;
+                ri->marks_sstables_repaired = marks_sstables_repaired;
                 return repair_ranges(ri);
             });
             repair_results.push_back(std::move(f));
@@ -35,6 +35,7 @@
 
 #include "database_fwd.hh"
 #include "frozen_mutation.hh"
+#include "db_clock.hh"
 #include "utils/UUID.hh"
 #include "utils/hash.hh"
 #include "streaming/stream_reason.hh"
@@ -133,6 +134,16 @@ class repair_stats {
     uint64_t tx_hashes_nr = 0;
     uint64_t rx_hashes_nr = 0;
 
+    // Row hash sets reconciled with sketches, those which failed to decode
+    // and needed the full set, and the bytes saved by the former.
+    uint64_t row_hash_sketch_decoded_nr = 0;
+    uint64_t row_hash_sketch_failed_nr = 0;
+    uint64_t row_hash_sketch_bytes_saved = 0;
+
+    // Ranges found in sync by comparing their cached digests, without
+    // reading their rows.
+    uint64_t range_digest_skipped_nr = 0;
+
     uint64_t tx_row_nr = 0;
     uint64_t rx_row_nr = 0;
 
@@ -194,6 +205,18 @@ class repair_info {
     repair_stats _stats;
     std::unordered_set<sstring> dropped_tables;
     std::optional<utils::UUID> _ops_uuid;
+    // Whether only the sstables which weren't repaired are read, by all
+    // the nodes, see sstable::is_repaired().
+    bool incremental = false;
+    // Whether the sstables of this shard are marked repaired once the repair
+    // succeeds, which requires it to be incremental and to cover all the
+    // local ranges with all their replicas: an sstable is repaired when all
+    // the data in it was repaired with all the other replicas of that data.
+    bool marks_sstables_repaired = false;
+    // The generations of the sstables of the tables, when the repair
+    // started, which are the ones marked repaired.
+    std::unordered_map<utils::UUID, std::unordered_set<int64_t>> sstables_at_start;
+    db_clock::time_point started_at;
 public:
     repair_info(repair_service& repair,
             const sstring& keyspace_,
@@ -220,6 +243,10 @@ class repair_info {
     };
 
     future<> repair_range(const dht::token_range& range);
+
+    // To be called before any range is repaired.
+    void record_sstables_at_start();
+    future<> mark_sstables_repaired();
 };
 
 // The repair_tracker tracks ongoing repair operations and their progress.
@@ -338,6 +365,27 @@ class repair_hash {
 
 using repair_hash_set = absl::btree_set<repair_hash>;
 
+// Cell of a repair_hash_sketch, see repair/hash_sketch.hh
+struct repair_hash_sketch_cell {
+    int32_t count = 0;
+    uint64_t hash_sum = 0;
+    uint64_t check_sum = 0;
+};
+
+// Combined hash of all the rows of a range, as read by a repair, with the
+// seed of the repair, see repair_range_digest_cache
+struct repair_range_digest {
+    uint64_t seed = 0;
+    repair_hash digest;
+
+    bool operator==(const repair_range_digest& o) const {
+        return seed == o.seed && digest == o.digest;
+    }
+    bool operator!=(const repair_range_digest& o) const {
+        return !(*this == o);
+    }
+};
+
 enum class repair_row_level_start_status: uint8_t {
     ok,
     no_such_column_family,
@@ -416,6 +464,10 @@ struct repair_row_on_wire_with_cmd {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    // Like send_full_set_rpc_stream, but the row hashes of peers are first
+    // reconciled with sketches (see repair_hash_sketch), and only sent in
+    // full when the sketch fails to decode.
+    send_sketch_rpc_stream,
 };
 
 std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo);
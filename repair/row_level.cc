@@ -21,6 +21,8 @@
 
 #include <seastar/util/defer.hh>
 #include "repair/repair.hh"
+#include "repair/hash_sketch.hh"
+#include "repair/range_digest_cache.hh"
 #include "message/messaging_service.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
@@ -83,6 +85,10 @@ enum class repair_state : uint16_t {
     get_full_row_hashes_with_rpc_stream_finished,
     get_full_row_hashes_started,
     get_full_row_hashes_finished,
+    get_row_hash_sketch_started,
+    get_row_hash_sketch_finished,
+    get_range_digest_started,
+    get_range_digest_finished,
     get_row_diff_started,
     get_row_diff_finished,
     put_row_diff_with_rpc_stream_started,
@@ -178,6 +184,10 @@ struct row_level_repair_metrics {
     uint64_t row_from_disk_bytes{0};
     uint64_t tx_hashes_nr{0};
     uint64_t rx_hashes_nr{0};
+    uint64_t row_hash_sketch_decoded_nr{0};
+    uint64_t row_hash_sketch_failed_nr{0};
+    uint64_t row_hash_sketch_bytes_saved{0};
+    uint64_t range_digest_skipped_nr{0};
     row_level_repair_metrics() {
         namespace sm = seastar::metrics;
         _metrics.add_group("repair", {
@@ -197,16 +207,28 @@ struct row_level_repair_metrics {
                             sm::description("Total number of rows read from disk on this shard.")),
             sm::make_derive("row_from_disk_bytes", row_from_disk_bytes,
                             sm::description("Total bytes of rows read from disk on this shard.")),
+            sm::make_derive("row_hash_sketch_decoded_nr", row_hash_sketch_decoded_nr,
+                            sm::description("Total number of row hash sketches of peers decoded on this shard.")),
+            sm::make_derive("row_hash_sketch_failed_nr", row_hash_sketch_failed_nr,
+                            sm::description("Total number of row hash sketches of peers which failed to decode on this shard, and were followed by a request for the full row hashes.")),
+            sm::make_derive("row_hash_sketch_bytes_saved", row_hash_sketch_bytes_saved,
+                            sm::description("Total bytes of row hashes not sent thanks to row hash sketches on this shard.")),
+            sm::make_derive("range_digest_skipped_nr", range_digest_skipped_nr,
+                            sm::description("Total number of ranges found in sync by their cached digests, without reading their rows, on this shard.")),
         });
     }
 };
 
 static thread_local row_level_repair_metrics _metrics;
 
+// Digests of the ranges read in full by repairs on this shard
+static thread_local repair_range_digest_cache _range_digest_cache(64 * 1024);
+
 static const std::vector<row_level_diff_detect_algorithm>& suportted_diff_detect_algorithms() {
     static std::vector<row_level_diff_detect_algorithm> _algorithms = {
         row_level_diff_detect_algorithm::send_full_set,
         row_level_diff_detect_algorithm::send_full_set_rpc_stream,
+        row_level_diff_detect_algorithm::send_sketch_rpc_stream,
     };
     return _algorithms;
 };
@@ -377,7 +399,8 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
             const dht::sharder& remote_sharder,
             unsigned remote_shard,
             uint64_t seed,
-            is_local_reader local_reader)
+            is_local_reader local_reader,
+            sstables::unrepaired_only unrepaired)
             : _schema(s)
             , _permit(std::move(permit))
             , _range(dht::to_partition_range(range))
@@ -386,7 +409,7 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
             , _local_read_op(local_reader ? std::optional(cf.read_in_progress()) : std::nullopt)
             , _reader(nullptr) {
         if (local_reader) {
-            auto ms = mutation_source([&cf] (
+            auto ms = mutation_source([&cf, unrepaired] (
                         schema_ptr s,
                         reader_permit permit,
                         const dht::partition_range& pr,
@@ -395,7 +418,7 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
                         tracing::trace_state_ptr,
                         streamed_mutation::forwarding,
                         mutation_reader::forwarding fwd_mr) {
-                return cf.make_streaming_reader(std::move(s), std::move(permit), pr, ps, fwd_mr);
+                return cf.make_streaming_reader(std::move(s), std::move(permit), pr, ps, fwd_mr, unrepaired);
             });
             std::tie(_reader, _reader_handle) = make_manually_paused_evictable_reader(
                     std::move(ms),
@@ -413,7 +436,7 @@ using is_local_reader = bool_class<class is_local_reader_tag>;
                     return std::optional<dht::partition_range>(dht::to_partition_range(*shard_range));
                 }
                 return std::optional<dht::partition_range>();
-            });
+            }, unrepaired);
         }
     }
 
@@ -655,6 +678,9 @@ class repair_meta {
     gms::inet_address _myip;
     uint32_t _repair_meta_id;
     streaming::stream_reason _reason;
+    // Whether only the sstables which weren't repaired are read, by all the
+    // nodes, for an incremental repair
+    sstables::unrepaired_only _unrepaired_only;
     // Repair master's sharding configuration
     shard_config _master_node_shard_config;
     // sharding info of repair master
@@ -689,6 +715,11 @@ class repair_meta {
     std::vector<repair_node_state> _all_node_states;
     is_dirty_on_master _dirty_on_master = is_dirty_on_master::no;
     std::optional<shared_promise<>> _stop_promise;
+    // Where the rows of the range were about to be read from when the master
+    // asked for the digest of the range, see repair_range_digest_cache
+    std::optional<repair_range_digest_cache::source> _range_digest_source;
+    // Combines all the repair_hash read from disk
+    repair_hash _range_digest;
 public:
     std::vector<repair_node_state>& all_nodes() {
         return _all_node_states;
@@ -725,6 +756,9 @@ class repair_meta {
     bool use_rpc_stream() const {
         return is_rpc_stream_supported(_algo);
     }
+    bool use_row_hash_sketch() const {
+        return _algo == row_level_diff_detect_algorithm::send_sketch_rpc_stream;
+    }
 
 public:
     repair_meta(
@@ -742,6 +776,7 @@ class repair_meta {
             repair_master master,
             uint32_t repair_meta_id,
             streaming::stream_reason reason,
+            sstables::unrepaired_only unrepaired_only,
             shard_config master_node_shard_config,
             std::vector<gms::inet_address> all_live_peer_nodes,
             size_t nr_peer_nodes = 1,
@@ -762,6 +797,7 @@ class repair_meta {
             , _myip(utils::fb_utilities::get_broadcast_address())
             , _repair_meta_id(repair_meta_id)
             , _reason(reason)
+            , _unrepaired_only(unrepaired_only)
             , _master_node_shard_config(std::move(master_node_shard_config))
             , _remote_sharder(make_remote_sharder())
             , _same_sharding_config(is_same_sharding_config())
@@ -775,7 +811,8 @@ class repair_meta {
                     _remote_sharder,
                     _master_node_shard_config.shard,
                     _seed,
-                    repair_reader::is_local_reader(_repair_master || _same_sharding_config)
+                    repair_reader::is_local_reader(_repair_master || _same_sharding_config),
+                    _unrepaired_only
               )
             , _repair_writer(make_lw_shared<repair_writer>(_schema, _permit, _estimated_partitions, _reason))
             , _sink_source_for_get_full_row_hashes(_repair_meta_id, _nr_peer_nodes,
@@ -865,7 +902,8 @@ class repair_meta {
             uint64_t seed,
             shard_config master_node_shard_config,
             table_schema_version schema_version,
-            streaming::stream_reason reason) {
+            streaming::stream_reason reason,
+            sstables::unrepaired_only unrepaired_only) {
         return repair.get_migration_manager().get_schema_for_write(schema_version, {from, src_cpu_id}, repair.get_messaging()).then([&repair,
                 from,
                 repair_meta_id,
@@ -875,7 +913,8 @@ class repair_meta {
                 seed,
                 master_node_shard_config,
                 schema_version,
-                reason] (schema_ptr s) {
+                reason,
+                unrepaired_only] (schema_ptr s) {
             auto& db = repair.get_db();
             auto& cf = db.local().find_column_family(s->id());
           return db.local().obtain_reader_permit(cf, "repair-meta", db::no_timeout).then([s = std::move(s),
@@ -890,7 +929,8 @@ class repair_meta {
                     seed,
                     master_node_shard_config,
                     schema_version,
-                    reason] (reader_permit permit) mutable {
+                    reason,
+                    unrepaired_only] (reader_permit permit) mutable {
             node_repair_meta_id id{from, repair_meta_id};
             auto rm = make_lw_shared<repair_meta>(db,
                     repair.get_messaging().container(),
@@ -906,6 +946,7 @@ class repair_meta {
                     repair_meta::repair_master::no,
                     repair_meta_id,
                     reason,
+                    unrepaired_only,
                     std::move(master_node_shard_config),
                     std::vector<gms::inet_address>{from});
             rm->set_repair_state_for_local_node(repair_state::row_level_start_started);
@@ -1155,6 +1196,7 @@ class repair_meta {
             return stop_iteration::no;
         }
         auto hash = do_hash_for_mf(*_repair_reader.get_current_dk(), mf);
+        _range_digest.add(hash);
         repair_row r(freeze(*_schema, mf), position_in_partition(mf.position()), _repair_reader.get_current_dk(), hash, is_dirty_on_master::no);
         rlogger.trace("Reading: r.boundary={}, r.hash={}", r.boundary(), r.hash());
         _metrics.row_from_disk_nr++;
@@ -1165,6 +1207,33 @@ class repair_meta {
         return stop_iteration::no;
     }
 
+    // The digest of the range is only cached for the rows of the range read
+    // from the local shard, and of all the sstables.
+    bool can_cache_range_digest() const {
+        return (_repair_master || _same_sharding_config) && !_unrepaired_only;
+    }
+
+    repair_range_digest_cache::key range_digest_key() const {
+        return repair_range_digest_cache::key{_schema->id(), _range};
+    }
+
+    std::optional<repair_range_digest_cache::source> range_digest_source() const {
+        return repair_range_digest_cache::source_of(_cf, _schema->version(), _range);
+    }
+
+    // Called once all the rows of the range were read. Their digest is only
+    // cached if they didn't change while they were read.
+    void maybe_cache_range_digest() {
+        if (!_range_digest_source) {
+            return;
+        }
+        auto src = range_digest_source();
+        if (src && *src == *_range_digest_source) {
+            _range_digest_cache.insert(range_digest_key(), repair_range_digest{_seed, _range_digest}, std::move(*src));
+        }
+        _range_digest_source.reset();
+    }
+
     // Read rows from sstable until the size of rows exceeds _max_row_buf_size  - current_size
     // This reads rows from where the reader left last time into _row_buf
     // _current_sync_boundary or _last_sync_boundary have no effect on the reader neither.
@@ -1179,7 +1248,8 @@ class repair_meta {
                 _gate.check();
                 return _repair_reader.read_mutation_fragment().then([this, &cur_size, &new_rows_size, &cur_rows] (mutation_fragment_opt mfopt) mutable {
                     if (!mfopt) {
-                      return _repair_reader.on_end_of_stream().then([] {
+                      return _repair_reader.on_end_of_stream().then([this] {
+                        maybe_cache_range_digest();
                         return stop_iteration::yes;
                       });
                     }
@@ -1612,6 +1682,66 @@ class repair_meta {
         });
     }
 
+    // RPC API
+    // Return the sketch, of the given number of cells, of the hashes of the
+    // rows in _working_row_buf
+    future<repair_hash_sketch>
+    get_row_hash_sketch(gms::inet_address remote_node, uint64_t cells) {
+        if (remote_node == _myip) {
+            return get_row_hash_sketch_handler(cells);
+        }
+        return _messaging.local().send_repair_get_row_hash_sketch(msg_addr(remote_node),
+                _repair_meta_id, cells).then([this, remote_node] (std::vector<repair_hash_sketch_cell> cells) {
+            rlogger.debug("Got row hash sketch from peer={}, nr_cells={}", remote_node, cells.size());
+            stats().rpc_call_nr++;
+            return repair_hash_sketch(std::move(cells));
+        });
+    }
+
+    // RPC handler
+    future<repair_hash_sketch>
+    get_row_hash_sketch_handler(uint64_t cells) {
+        return with_gate(_gate, [this, cells] {
+            return working_row_hashes().then([cells] (repair_hash_set hashes) {
+                repair_hash_sketch sketch(cells);
+                sketch.add(hashes);
+                return sketch;
+            });
+        });
+    }
+
+    // RPC API
+    // Return the digest of the range cached by the last repair which read it
+    // in full, if its rows didn't change since
+    future<std::optional<repair_range_digest>>
+    get_range_digest(gms::inet_address remote_node) {
+        if (remote_node == _myip) {
+            return get_range_digest_handler();
+        }
+        return _messaging.local().send_repair_get_range_digest(msg_addr(remote_node),
+                _repair_meta_id).then([this] (std::optional<repair_range_digest> digest) {
+            stats().rpc_call_nr++;
+            return digest;
+        });
+    }
+
+    // RPC handler
+    // Must be called before any row is read, so that the digest of the rows
+    // about to be read can be cached once they are all read.
+    future<std::optional<repair_range_digest>>
+    get_range_digest_handler() {
+        return with_gate(_gate, [this] {
+            std::optional<repair_range_digest> digest;
+            if (can_cache_range_digest()) {
+                _range_digest_source = range_digest_source();
+                if (_range_digest_source) {
+                    digest = _range_digest_cache.find(range_digest_key(), *_range_digest_source);
+                }
+            }
+            return make_ready_future<std::optional<repair_range_digest>>(digest);
+        });
+    }
+
     // RPC API
     // Return the combined hashes of the current working row buf
     future<get_combined_row_hash_response>
@@ -1656,7 +1786,7 @@ class repair_meta {
         return _messaging.local().send_repair_row_level_start(msg_addr(remote_node),
                 _repair_meta_id, ks_name, cf_name, std::move(range), _algo, _max_row_buf_size, _seed,
                 _master_node_shard_config.shard, _master_node_shard_config.shard_count, _master_node_shard_config.ignore_msb,
-                remote_partitioner_name, std::move(schema_version), reason).then([ks_name, cf_name] (rpc::optional<repair_row_level_start_response> resp) {
+                remote_partitioner_name, std::move(schema_version), reason, bool(_unrepaired_only)).then([ks_name, cf_name] (rpc::optional<repair_row_level_start_response> resp) {
             if (resp && resp->status == repair_row_level_start_status::no_such_column_family) {
                 return make_exception_future<>(no_such_column_family(ks_name, cf_name));
             } else {
@@ -1669,10 +1799,11 @@ class repair_meta {
     static future<repair_row_level_start_response>
     repair_row_level_start_handler(repair_service& repair, gms::inet_address from, uint32_t src_cpu_id, uint32_t repair_meta_id, sstring ks_name, sstring cf_name,
             dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size,
-            uint64_t seed, shard_config master_node_shard_config, table_schema_version schema_version, streaming::stream_reason reason) {
+            uint64_t seed, shard_config master_node_shard_config, table_schema_version schema_version, streaming::stream_reason reason,
+            sstables::unrepaired_only unrepaired_only) {
         rlogger.debug(">>> Started Row Level Repair (Follower): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, max_row_buf_siz={}",
             utils::fb_utilities::get_broadcast_address(), from, repair_meta_id, ks_name, cf_name, schema_version, range, seed, max_row_buf_size);
-        return insert_repair_meta(repair, from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason).then([] {
+        return insert_repair_meta(repair, from, src_cpu_id, repair_meta_id, std::move(range), algo, max_row_buf_size, seed, std::move(master_node_shard_config), std::move(schema_version), reason, unrepaired_only).then([] {
             return repair_row_level_start_response{repair_row_level_start_status::ok};
         }).handle_exception_type([] (no_such_column_family&) {
             return repair_row_level_start_response{repair_row_level_start_status::no_such_column_family};
@@ -2315,6 +2446,30 @@ future<> repair_service::init_ms_handlers() {
             });
         }) ;
     });
+    ms.register_repair_get_row_hash_sketch([] (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint64_t cells) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return smp::submit_to(src_cpu_id % smp::count, [from, repair_meta_id, cells] {
+            auto rm = repair_meta::get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_row_hash_sketch_started);
+            return rm->get_row_hash_sketch_handler(cells).then([rm] (repair_hash_sketch sketch) {
+                rm->set_repair_state_for_local_node(repair_state::get_row_hash_sketch_finished);
+                return std::move(sketch).release();
+            });
+        });
+    });
+    ms.register_repair_get_range_digest([] (const rpc::client_info& cinfo, uint32_t repair_meta_id) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return smp::submit_to(src_cpu_id % smp::count, [from, repair_meta_id] {
+            auto rm = repair_meta::get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_range_digest_started);
+            return rm->get_range_digest_handler().then([rm] (std::optional<repair_range_digest> digest) {
+                rm->set_repair_state_for_local_node(repair_state::get_range_digest_finished);
+                return digest;
+            });
+        });
+    });
     ms.register_repair_get_combined_row_hash([] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
             std::optional<repair_sync_boundary> common_sync_boundary) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
@@ -2387,11 +2542,12 @@ future<> repair_service::init_ms_handlers() {
     });
     ms.register_repair_row_level_start([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id, sstring ks_name,
             sstring cf_name, dht::token_range range, row_level_diff_detect_algorithm algo, uint64_t max_row_buf_size, uint64_t seed,
-            unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason) {
+            unsigned remote_shard, unsigned remote_shard_count, unsigned remote_ignore_msb, sstring remote_partitioner_name, table_schema_version schema_version, rpc::optional<streaming::stream_reason> reason,
+            rpc::optional<bool> unrepaired_only) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(src_cpu_id % smp::count, [from, src_cpu_id, repair_meta_id, ks_name, cf_name,
-                range, algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, schema_version, reason] (repair_service& local_repair) mutable {
+                range, algo, max_row_buf_size, seed, remote_shard, remote_shard_count, remote_ignore_msb, schema_version, reason, unrepaired_only] (repair_service& local_repair) mutable {
             if (!local_repair._sys_dist_ks.local_is_initialized() || !local_repair._view_update_generator.local_is_initialized()) {
                 return make_exception_future<repair_row_level_start_response>(std::runtime_error(format("Node {} is not fully initialized for repair, try again later",
                         utils::fb_utilities::get_broadcast_address())));
@@ -2400,7 +2556,7 @@ future<> repair_service::init_ms_handlers() {
             return repair_meta::repair_row_level_start_handler(local_repair, from, src_cpu_id, repair_meta_id, std::move(ks_name),
                     std::move(cf_name), std::move(range), algo, max_row_buf_size, seed,
                     shard_config{remote_shard, remote_shard_count, remote_ignore_msb},
-                    schema_version, r);
+                    schema_version, r, sstables::unrepaired_only(unrepaired_only && *unrepaired_only));
         });
     });
     ms.register_repair_row_level_stop([] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
@@ -2442,6 +2598,8 @@ future<> repair_service::uninit_ms_handlers() {
         ms.unregister_repair_put_row_diff_with_rpc_stream(),
         ms.unregister_repair_get_full_row_hashes_with_rpc_stream(),
         ms.unregister_repair_get_full_row_hashes(),
+        ms.unregister_repair_get_row_hash_sketch(),
+        ms.unregister_repair_get_range_digest(),
         ms.unregister_repair_get_combined_row_hash(),
         ms.unregister_repair_get_sync_boundary(),
         ms.unregister_repair_get_row_diff(),
@@ -2522,6 +2680,10 @@ class row_level_repair {
     // the next repair.
     uint64_t _seed;
 
+    // Number of rows by which each peer differed from the local node the
+    // last time their row hashes were compared, to size the next sketch.
+    std::vector<std::optional<size_t>> _sketch_difference_estimates;
+
 public:
     row_level_repair(repair_info& ri,
             sstring cf_name,
@@ -2534,7 +2696,8 @@ class row_level_repair {
         , _range(std::move(range))
         , _all_live_peer_nodes(std::move(all_live_peer_nodes))
         , _cf(_ri.db.local().find_column_family(_table_id))
-        , _seed(get_random_seed()) {
+        , _seed(get_random_seed())
+        , _sketch_difference_estimates(_all_live_peer_nodes.size()) {
     }
 
 private:
@@ -2609,6 +2772,57 @@ class row_level_repair {
         return op_status::next_step;
     }
 
+    // Sets the row hashes of the peer to the local ones, patched with the
+    // difference decoded from the sketches of both. Returns false, leaving
+    // them alone, if the sketch wouldn't be smaller than the hashes or
+    // failed to decode, in which case the full row hashes are needed.
+    bool get_peer_row_hashes_with_sketch(repair_meta& master, repair_node_state& ns, unsigned node_idx) {
+        const auto& node = ns.node;
+        repair_hash_set local = master.working_row_hashes().get0();
+        auto& estimate = _sketch_difference_estimates[node_idx];
+        if (!estimate) {
+            estimate = local.size() / 32;
+        }
+        repair_hash_sketch sketch(repair_hash_sketch::cells_for(*estimate));
+        auto sketch_bytes = sketch.serialized_size();
+        if (sketch_bytes >= local.size() * sizeof(uint64_t)) {
+            return false;
+        }
+        ns.state = repair_state::get_row_hash_sketch_started;
+        auto remote = master.get_row_hash_sketch(node, sketch.size()).get0();
+        ns.state = repair_state::get_row_hash_sketch_finished;
+        sketch.add(local);
+        sketch.subtract(remote);
+        auto diff = std::move(sketch).decode();
+        // A decoded difference which doesn't apply to the local hashes is
+        // the sign of a checksum collision.
+        auto applies = [&] {
+            return std::all_of(diff->local.begin(), diff->local.end(), [&] (const repair_hash& h) { return local.contains(h); })
+                    && std::none_of(diff->remote.begin(), diff->remote.end(), [&] (const repair_hash& h) { return local.contains(h); });
+        };
+        if (!diff || !applies()) {
+            rlogger.debug("Failed to decode row hash sketch of node {}, cells={}, estimated_difference={}", node, remote.size(), *estimate);
+            master.stats().row_hash_sketch_failed_nr++;
+            _metrics.row_hash_sketch_failed_nr++;
+            return false;
+        }
+        estimate = diff->local.size() + diff->remote.size();
+        for (auto& h : diff->local) {
+            local.erase(h);
+        }
+        local.insert(diff->remote.begin(), diff->remote.end());
+        auto hashes_bytes = local.size() * sizeof(uint64_t);
+        auto saved = hashes_bytes > sketch_bytes ? hashes_bytes - sketch_bytes : 0;
+        rlogger.debug("Decoded row hash sketch of node {}, cells={}, local_only={}, peer_only={}, bytes_saved={}",
+                node, remote.size(), diff->local.size(), diff->remote.size(), saved);
+        master.stats().row_hash_sketch_decoded_nr++;
+        master.stats().row_hash_sketch_bytes_saved += saved;
+        _metrics.row_hash_sketch_decoded_nr++;
+        _metrics.row_hash_sketch_bytes_saved += saved;
+        master.peer_row_hash_sets(node_idx) = std::move(local);
+        return true;
+    }
+
     // Step B: Get missing rows from peer nodes so that local node contains all the rows
     op_status get_missing_rows_from_follower_nodes(repair_meta& master) {
         check_in_shutdown();
@@ -2697,11 +2911,19 @@ class row_level_repair {
 
             rlogger.debug("Before master.get_full_row_hashes for node {}, hash_sets={}",
                 node, master.peer_row_hash_sets(node_idx).size());
-            // Ask the peer to send the full list hashes in the working row buf.
-            if (master.use_rpc_stream()) {
+            // Ask the peer to send a sketch of the hashes in the working row
+            // buf, or failing that the full list of them.
+            if (master.use_row_hash_sketch() && get_peer_row_hashes_with_sketch(master, ns, node_idx)) {
+                // The peer row hashes were decoded from the sketch.
+            } else if (master.use_rpc_stream()) {
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_rpc_stream(node, node_idx).get0();
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_finished;
+                if (master.use_row_hash_sketch()) {
+                    auto& peer = master.peer_row_hash_sets(node_idx);
+                    auto local = master.working_row_hashes().get0();
+                    _sketch_difference_estimates[node_idx] = repair_meta::get_set_diff(peer, local).size() + repair_meta::get_set_diff(local, peer).size();
+                }
             } else {
                 ns.state = repair_state::get_full_row_hashes_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes(node).get0();
@@ -2771,6 +2993,28 @@ class row_level_repair {
         master.stats().round_nr_slow_path++;
     }
 
+    // Returns true if all the nodes have the same digest of the range, cached
+    // by the last repair which read it in full, in which case the range is
+    // in sync and needn't be read. See repair_range_digest_cache.
+    bool range_digests_match(repair_meta& master) {
+        check_in_shutdown();
+        _ri.check_in_abort();
+        std::vector<std::optional<repair_range_digest>> digests(master.all_nodes().size());
+        parallel_for_each(boost::irange(size_t(0), digests.size()), [&] (size_t idx) {
+            auto& ns = master.all_nodes()[idx];
+            ns.state = repair_state::get_range_digest_started;
+            return master.get_range_digest(ns.node).then([&, idx] (std::optional<repair_range_digest> digest) {
+                ns.state = repair_state::get_range_digest_finished;
+                rlogger.trace("Got range digest from node {}: seed={}, digest={}", ns.node,
+                        digest ? digest->seed : 0, digest ? digest->digest : repair_hash());
+                digests[idx] = digest;
+            });
+        }).get();
+        return digests.front() && std::all_of(digests.begin(), digests.end(), [&] (const std::optional<repair_range_digest>& d) {
+            return d == digests.front();
+        });
+    }
+
 public:
     future<> run() {
         return seastar::async([this] {
@@ -2804,6 +3048,7 @@ class row_level_repair {
                     repair_meta::repair_master::yes,
                     repair_meta_id,
                     _ri.reason,
+                    sstables::unrepaired_only(_ri.incremental),
                     std::move(master_node_shard_config),
                     _all_live_peer_nodes,
                     _all_live_peer_nodes.size(),
@@ -2845,18 +3090,24 @@ class row_level_repair {
                     });
                 }).get();
 
-                while (true) {
-                    auto status = negotiate_sync_boundary(master);
-                    if (status == op_status::next_round) {
-                        continue;
-                    } else if (status == op_status::all_done) {
-                        break;
-                    }
-                    status = get_missing_rows_from_follower_nodes(master);
-                    if (status == op_status::next_round) {
-                        continue;
+                if (_ri.db.local().features().cluster_supports_repair_range_digest() && range_digests_match(master)) {
+                    rlogger.debug("Skipped range in sync according to its digest: keyspace={}, cf={}, range={}", _ri.keyspace, _cf_name, _range);
+                    master.stats().range_digest_skipped_nr++;
+                    _metrics.range_digest_skipped_nr++;
+                } else {
+                    while (true) {
+                        auto status = negotiate_sync_boundary(master);
+                        if (status == op_status::next_round) {
+                            continue;
+                        } else if (status == op_status::all_done) {
+                            break;
+                        }
+                        status = get_missing_rows_from_follower_nodes(master);
+                        if (status == op_status::next_round) {
+                            continue;
+                        }
+                        send_missing_rows_to_follower_nodes(master);
                     }
-                    send_missing_rows_to_follower_nodes(master);
                 }
             } catch (no_such_column_family& e) {
                 table_dropped = true;
@@ -166,6 +166,36 @@ void cache_tracker::touch(rows_entry& e) {
     _lru.add(e);
 }
 
+cache_tracker::recent_partitions cache_tracker::walk_recent_partitions(lru_marker& marker, size_t max_rows) {
+    return _walk_section(_region, [&] {
+        recent_partitions ret;
+        const cache_entry* last = nullptr;
+        ret.done = _lru.walk_from_most_recent(marker, max_rows, [&] (evictable& e) {
+            // The LRU holds the pages of the sstable index caches too.
+            auto* row = dynamic_cast<rows_entry*>(&e);
+            if (!row) {
+                return;
+            }
+            mutation_partition::rows_type::iterator it(row);
+            auto* pv = &partition_version::container_of(mutation_partition::container_of(*it.owning_tree()));
+            while (pv->prev()) {
+                pv = pv->prev();
+            }
+            // Versions no longer referenced from an entry are garbage.
+            if (!pv->is_referenced_from_entry()) {
+                return;
+            }
+            auto& ce = cache_entry::container_of(partition_entry::container_of(*pv));
+            if (&ce == last || ce.is_dummy_entry()) {
+                return;
+            }
+            last = &ce;
+            ret.keys.emplace_back(ce.schema(), ce.key());
+        });
+        return ret;
+    });
+}
+
 void cache_tracker::insert(cache_entry& entry) {
     insert(entry.partition());
     ++_stats.partition_insertions;
@@ -445,8 +475,9 @@ void row_cache::on_partition_hit() {
     _tracker.on_partition_hit();
 }
 
-void row_cache::on_partition_miss() {
+void row_cache::on_partition_miss(const reader_permit& permit) {
     _tracker.on_partition_miss();
+    ++permit.latency_breakdown().cache_misses;
 }
 
 void row_cache::on_row_hit() {
@@ -458,9 +489,10 @@ void row_cache::on_mispopulate() {
     _tracker.on_mispopulate();
 }
 
-void row_cache::on_row_miss() {
+void row_cache::on_row_miss(const reader_permit& permit) {
     _stats.misses.mark();
     _tracker.on_row_miss();
+    ++permit.latency_breakdown().cache_misses;
 }
 
 void row_cache::on_static_row_insert() {
@@ -521,7 +553,7 @@ class range_populating_reader {
                         return make_ready_future<read_result>(read_result(std::nullopt, std::nullopt));
                     });
                 }
-                _cache.on_partition_miss();
+                _cache.on_partition_miss(_read_context.permit());
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
                 if (_reader.creation_phase() == _cache.phase_of(key)) {
@@ -755,7 +787,7 @@ row_cache::do_make_reader(schema_ptr s,
                 return make_empty_flat_reader(std::move(s), std::move(permit));
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
-                on_partition_miss();
+                on_partition_miss(permit);
                 return make_flat_mutation_reader<single_partition_populating_reader>(*this, make_context());
             }
         });
@@ -269,9 +269,10 @@ class row_cache final {
     flat_mutation_reader create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
     void on_partition_hit();
-    void on_partition_miss();
+    // Misses are also accounted to the latency breakdown of the read.
+    void on_partition_miss(const reader_permit& permit);
     void on_row_hit();
-    void on_row_miss();
+    void on_row_miss(const reader_permit& permit);
     void on_static_row_insert();
     void on_mispopulate();
     void upgrade_entry(cache_entry&);
@@ -421,6 +422,7 @@ class row_cache final {
     // that they are not evicted by memory reclaimer.
     void unlink_from_lru(const dht::decorated_key&);
 
+
     // Synchronizes cache with the underlying mutation source
     // by invalidating ranges which were modified. This will force
     // them to be re-read from the underlying mutation source
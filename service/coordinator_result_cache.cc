@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/core/metrics.hh>
+
+#include "service/coordinator_result_cache.hh"
+#include "utils/hash.hh"
+
+namespace service {
+
+// Memory of an entry besides the result.
+static constexpr size_t entry_overhead = sizeof(coordinator_result_cache::key) + 128;
+
+coordinator_result_cache::coordinator_result_cache(size_t max_memory, utils::updateable_value<uint32_t> ttl_in_ms)
+    : _max_memory(max_memory)
+    , _ttl_in_ms(std::move(ttl_in_ms))
+{
+}
+
+void coordinator_result_cache::register_metrics() {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("coordinator_result_cache", {
+        sm::make_total_operations("hits", _stats.hits,
+                sm::description("number of reads served from the cache")),
+        sm::make_total_operations("misses", _stats.misses,
+                sm::description("number of reads of tables with the coordinator_results caching option which missed the cache")),
+        sm::make_total_operations("inserts", _stats.inserts,
+                sm::description("number of results inserted into the cache")),
+        sm::make_total_operations("dropped_inserts", _stats.dropped_inserts,
+                sm::description("number of results not inserted into the cache because their partition was written to during the read")),
+        sm::make_total_operations("invalidations", _stats.invalidations,
+                sm::description("number of partition invalidations, because of writes")),
+        sm::make_total_operations("evictions", _stats.evictions,
+                sm::description("number of results evicted from the cache to free memory")),
+        sm::make_gauge("entries", [this] { return _entries.size(); },
+                sm::description("number of results in the cache")),
+        sm::make_gauge("bytes", [this] { return _memory; },
+                sm::description("memory used by the cache")),
+    });
+}
+
+coordinator_result_cache::generation_type& coordinator_result_cache::generation_of(const utils::UUID& table, const dht::token& t) {
+    auto h = utils::hash_combine(std::hash<utils::UUID>()(table), std::hash<int64_t>()(t.raw()));
+    return _generations[h % generations_count];
+}
+
+coordinator_result_cache::entries_type::iterator coordinator_result_cache::erase(entries_type::iterator it) {
+    _memory -= it->second.memory;
+    // The entry unlinks itself from the LRU.
+    return _entries.erase(it);
+}
+
+lw_shared_ptr<query::result> coordinator_result_cache::find(const key& k) {
+    auto it = _entries.find(k);
+    if (it == _entries.end()) {
+        ++_stats.misses;
+        return nullptr;
+    }
+    if (it->second.expiry < lowres_clock::now()) {
+        erase(it);
+        ++_stats.misses;
+        return nullptr;
+    }
+    ++_stats.hits;
+    it->second.unlink();
+    _lru.push_back(it->second);
+    return it->second.result;
+}
+
+void coordinator_result_cache::insert(key k, const query::result& r, generation_type gen, std::optional<gc_clock::time_point> valid_until) {
+    if (generation_of(k.table, k.token) != gen) {
+        ++_stats.dropped_inserts;
+        return;
+    }
+    auto ttl = std::chrono::duration_cast<lowres_clock::duration>(std::chrono::milliseconds(_ttl_in_ms()));
+    if (valid_until) {
+        auto left = *valid_until - gc_clock::now();
+        if (left <= gc_clock::duration::zero()) {
+            return;
+        }
+        ttl = std::min(ttl, std::chrono::duration_cast<lowres_clock::duration>(left));
+    }
+    auto memory = r.buf().size() + k.query.size() + entry_overhead;
+    if (memory > _max_memory / 16) {
+        return;
+    }
+    if (auto it = _entries.find(k); it != _entries.end()) {
+        erase(it);
+    }
+    while (_memory + memory > _max_memory && !_lru.empty()) {
+        erase(_entries.find(*_lru.front().k));
+        ++_stats.evictions;
+    }
+    auto [it, inserted] = _entries.emplace(std::move(k), entry());
+    auto& e = it->second;
+    e.k = &it->first;
+    e.result = make_lw_shared<query::result>(bytes_ostream(r.buf()), r.digest(), r.last_modified(), r.is_short_read(),
+            r.row_count_low_bits(), r.partition_count(), r.row_count_high_bits());
+    e.memory = memory;
+    e.expiry = lowres_clock::now() + ttl;
+    _lru.push_back(e);
+    _memory += memory;
+    ++_stats.inserts;
+}
+
+void coordinator_result_cache::invalidate(const utils::UUID& table, const dht::token& t) {
+    ++generation_of(table, t);
+    ++_stats.invalidations;
+    auto it = _entries.lower_bound(key{table, t, bytes()});
+    while (it != _entries.end() && it->first.table == table && it->first.token == t) {
+        it = erase(it);
+    }
+}
+
+void coordinator_result_cache::clear() {
+    for (auto& g : _generations) {
+        ++g;
+    }
+    _entries.clear();
+    _memory = 0;
+}
+
+void coordinator_result_cache::invalidate(const utils::UUID& table) {
+    for (auto& g : _generations) {
+        ++g;
+    }
+    auto it = _entries.lower_bound(key{table, dht::minimum_token(), bytes()});
+    while (it != _entries.end() && it->first.table == table) {
+        it = erase(it);
+    }
+}
+
+}
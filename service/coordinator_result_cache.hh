@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <boost/intrusive/list.hpp>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include "bytes.hh"
+#include "dht/token.hh"
+#include "gc_clock.hh"
+#include "query-result.hh"
+#include "utils/UUID.hh"
+#include "utils/updateable_value.hh"
+#include "seastarx.hh"
+
+namespace service {
+
+// Cache, on the coordinator, of the results of single partition reads of the
+// tables with the coordinator_results caching option.
+//
+// Entries are found by table, token of the partition and an opaque query key,
+// which identifies the statement, its bound values and the consistency level
+// (see select_statement). Only the results of reads at a consistency level
+// which a single replica satisfies, read from this node as a replica, are
+// cached, so that the cache never returns a result older than the data of
+// this replica. A write to a partition invalidates all the entries of its
+// token when this replica applies it (see storage_proxy), so writes needn't
+// wait for any other node. Streamed and repaired data invalidates the
+// entries of its table. Since sstables loaded with refresh don't, entries
+// also expire, and no later than the earliest expiring cell of their result.
+//
+// An insertion is dropped if the token was invalidated while the query was
+// running, since the result may predate the write. To tell, invalidations
+// bump a generation, out of a small array indexed by a hash of the token,
+// and insertions present the generation they saw before starting the query.
+//
+// Entries live on the shard owning the token, where the writes are applied,
+// so that invalidations needn't be broadcast to all shards.
+class coordinator_result_cache {
+public:
+    struct key {
+        utils::UUID table;
+        dht::token token;
+        bytes query;
+
+        bool operator<(const key& o) const {
+            return std::tie(table, token, query) < std::tie(o.table, o.token, o.query);
+        }
+    };
+    using generation_type = uint64_t;
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        // Insertions dropped because of an invalidation racing with the query.
+        uint64_t dropped_inserts = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+    };
+private:
+    using lru_hook = boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+    struct entry : public lru_hook {
+        const key* k = nullptr;
+        lw_shared_ptr<query::result> result;
+        size_t memory;
+        lowres_clock::time_point expiry;
+    };
+    using entries_type = std::map<key, entry>;
+    static constexpr size_t generations_count = 1024;
+
+    size_t _max_memory;
+    utils::updateable_value<uint32_t> _ttl_in_ms;
+    entries_type _entries;
+    // Least recently used first.
+    boost::intrusive::list<entry, boost::intrusive::constant_time_size<false>> _lru;
+    size_t _memory = 0;
+    std::array<generation_type, generations_count> _generations = {};
+    stats _stats;
+    seastar::metrics::metric_groups _metrics;
+private:
+    generation_type& generation_of(const utils::UUID& table, const dht::token& t);
+    entries_type::iterator erase(entries_type::iterator it);
+public:
+    coordinator_result_cache(size_t max_memory, utils::updateable_value<uint32_t> ttl_in_ms);
+
+    void register_metrics();
+
+    // Returns nullptr on a miss. The result must not be modified.
+    lw_shared_ptr<query::result> find(const key& k);
+
+    // To be called before starting the query whose result is to be inserted.
+    generation_type generation(const key& k) {
+        return generation_of(k.table, k.token);
+    }
+
+    // Copies the result in, unless the token of the key was invalidated since
+    // the generation was obtained. The entry expires no later than
+    // valid_until, the earliest expiry of the cells of the result.
+    void insert(key k, const query::result& r, generation_type gen, std::optional<gc_clock::time_point> valid_until = {});
+
+    void invalidate(const utils::UUID& table, const dht::token& t);
+    void invalidate(const utils::UUID& table);
+    void clear();
+
+    const stats& get_stats() const {
+        return _stats;
+    }
+};
+
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/future-util.hh>
+#include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/range/irange.hpp>
+
+#include "service/forward_service.hh"
+#include "service/storage_proxy.hh"
+#include "service/migration_manager.hh"
+#include "service/pager/query_pagers.hh"
+#include "service/query_state.hh"
+#include "service/client_state.hh"
+#include "message/messaging_service.hh"
+#include "cql3/selection/selection.hh"
+#include "cql3/selection/raw_selector.hh"
+#include "cql3/selection/selectable-expr.hh"
+#include "cql3/functions/functions.hh"
+#include "cql3/functions/aggregate_fcts.hh"
+#include "cql3/functions/aggregate_function.hh"
+#include "cql3/statements/select_statement.hh"
+#include "cql3/query_options.hh"
+#include "cql3/result_set.hh"
+#include "dht/sharder.hh"
+#include "schema_registry.hh"
+#include "database.hh"
+#include "tracing/tracing.hh"
+#include "utils/fb_utilities.hh"
+
+namespace service {
+
+static logging::logger flogger("forward_service");
+
+static const dht::token& end_token(const dht::partition_range& r) {
+    static const dht::token max_token = dht::maximum_token();
+    return r.end() ? r.end()->value().token() : max_token;
+}
+
+static ::shared_ptr<cql3::functions::aggregate_function>
+get_reducer(const schema& s, const query::forward_request::aggregation_info& info) {
+    using namespace cql3::functions;
+    shared_ptr<function> f;
+    if (info.name == aggregate_fcts::COUNT_ROWS_FUNCTION_NAME || info.name == "count") {
+        // Partial counts are merged by summing them up.
+        f = functions::find(function_name::native_function("sum"), {long_type});
+    } else if (info.name == "sum" || info.name == "min" || info.name == "max") {
+        if (info.column_names.size() != 1) {
+            return nullptr;
+        }
+        auto def = s.get_column_definition(to_bytes(info.column_names.front()));
+        if (!def) {
+            return nullptr;
+        }
+        f = functions::find(function_name::native_function(info.name), {def->type->without_reversed()});
+    }
+    return dynamic_pointer_cast<aggregate_function>(std::move(f));
+}
+
+static std::vector<::shared_ptr<cql3::functions::aggregate_function>>
+get_reducers(const schema& s, const std::vector<query::forward_request::aggregation_info>& aggregations) {
+    std::vector<::shared_ptr<cql3::functions::aggregate_function>> reducers;
+    reducers.reserve(aggregations.size());
+    for (auto& info : aggregations) {
+        auto reducer = get_reducer(s, info);
+        if (!reducer) {
+            throw std::runtime_error(format("forward_service: no reducer for aggregation {}", info));
+        }
+        reducers.push_back(std::move(reducer));
+    }
+    return reducers;
+}
+
+// Merges partial aggregation results into a single one.
+static query::forward_result reduce_results(const schema& s, const std::vector<query::forward_request::aggregation_info>& aggregations,
+        std::vector<query::forward_result> partials) {
+    auto sf = cql_serialization_format::internal();
+    query::forward_result result;
+    result.query_results.reserve(aggregations.size());
+    auto reducers = get_reducers(s, aggregations);
+    for (size_t i = 0; i < reducers.size(); ++i) {
+        auto aggregate = reducers[i]->new_aggregate();
+        for (auto& partial : partials) {
+            aggregate->add_input(sf, {std::move(partial.query_results[i])});
+        }
+        result.query_results.push_back(aggregate->compute(sf));
+    }
+    return result;
+}
+
+static ::shared_ptr<cql3::selection::selection>
+make_selection(database& db, schema_ptr s, const std::vector<query::forward_request::aggregation_info>& aggregations) {
+    std::vector<::shared_ptr<cql3::selection::raw_selector>> raw_selectors;
+    raw_selectors.reserve(aggregations.size());
+    for (auto& info : aggregations) {
+        cql3::expr::expression selectable = cql3::selection::make_count_rows_function_expression();
+        if (info.name != cql3::functions::aggregate_fcts::COUNT_ROWS_FUNCTION_NAME) {
+            std::vector<cql3::expr::expression> args;
+            args.reserve(info.column_names.size());
+            for (auto& name : info.column_names) {
+                args.push_back(cql3::expr::unresolved_identifier{::make_shared<cql3::column_identifier_raw>(name, true)});
+            }
+            selectable = cql3::expr::function_call{cql3::functions::function_name::native_function(info.name), std::move(args)};
+        }
+        raw_selectors.push_back(::make_shared<cql3::selection::raw_selector>(std::move(selectable), nullptr));
+    }
+    return cql3::selection::selection::from_selectors(db, std::move(s), raw_selectors);
+}
+
+bool forward_service::can_be_parallelized(const schema& s, const std::vector<query::forward_request::aggregation_info>& aggregations) {
+    return !aggregations.empty() && boost::algorithm::all_of(aggregations, [&s] (const query::forward_request::aggregation_info& info) {
+        return bool(get_reducer(s, info));
+    });
+}
+
+forward_service::forward_service(netw::messaging_service& ms, storage_proxy& p)
+        : _messaging(ms)
+        , _proxy(p) {
+    register_metrics();
+}
+
+future<> forward_service::stop() {
+    return make_ready_future<>();
+}
+
+void forward_service::register_metrics() {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("forward_service", {
+        sm::make_total_operations("requests_dispatched_to_other_nodes", _stats.requests_dispatched_to_other_nodes,
+                sm::description("how many forward requests were dispatched to other nodes")),
+        sm::make_total_operations("requests_dispatched_to_own_shards", _stats.requests_dispatched_to_own_shards,
+                sm::description("how many forward requests were dispatched to local shards")),
+        sm::make_total_operations("requests_executed", _stats.requests_executed,
+                sm::description("how many forward requests were executed")),
+    });
+}
+
+future<query::forward_result> forward_service::execute_on_this_shard(schema_ptr schema, query::forward_request req,
+        std::optional<tracing::trace_info> tr_info, db::timeout_clock::time_point timeout) {
+    _stats.requests_executed++;
+
+    tracing::trace_state_ptr tr_state;
+    if (tr_info) {
+        tr_state = tracing::tracing::get_local_tracing_instance().create_session(*tr_info);
+        tracing::begin(tr_state);
+    }
+
+    auto selection = make_selection(_proxy.local_db(), schema, req.aggregations);
+    auto now = gc_clock::now();
+    auto cmd = make_lw_shared<query::read_command>(std::move(req.cmd));
+    cmd->slice.options.set<query::partition_slice::option::allow_short_read>();
+
+    service::query_state query_state(client_state::for_internal_calls(), tr_state, empty_service_permit());
+    cql3::query_options query_options(req.cl, std::vector<cql3::raw_value>{});
+    auto pager = pager::query_pagers::pager(schema, selection, query_state, query_options, cmd, std::move(req.pr));
+    cql3::selection::result_set_builder builder(*selection, now, cql_serialization_format::internal());
+
+    while (!pager->is_exhausted()) {
+        co_await pager->fetch_page(builder, cql3::statements::select_statement::DEFAULT_COUNT_PAGE_SIZE, now, timeout);
+    }
+    auto rs = builder.build();
+    tracing::trace(tr_state, "Computed partial aggregation result on shard {}", this_shard_id());
+
+    if (rs->rows().empty()) {
+        // Cannot happen for an aggregate selection, but do not let
+        // a missing row turn into an out-of-range access.
+        on_internal_error(flogger, "aggregation query returned no rows");
+    }
+    co_return query::forward_result{rs->rows().front()};
+}
+
+future<query::forward_result> forward_service::dispatch_to_shards(schema_ptr schema, query::forward_request req,
+        std::optional<tracing::trace_info> tr_info, db::timeout_clock::time_point timeout) {
+    _stats.requests_dispatched_to_own_shards++;
+
+    // Split the ranges along shard boundaries so that every shard
+    // only reads the data it owns.
+    std::vector<dht::partition_range_vector> ranges_per_shard(smp::count);
+    dht::ring_position_range_vector_sharder sharder(schema->get_sharder(), std::move(req.pr));
+    while (auto r = sharder.next(*schema)) {
+        ranges_per_shard[r->shard].push_back(std::move(r->ring_range));
+    }
+
+    global_schema_ptr gs(schema);
+    std::vector<query::forward_result> partials;
+    partials.reserve(smp::count);
+    co_await parallel_for_each(boost::irange(0u, smp::count), [&] (unsigned shard) -> future<> {
+        if (ranges_per_shard[shard].empty()) {
+            return make_ready_future<>();
+        }
+        auto shard_req = query::forward_request{req.aggregations, req.cmd, std::move(ranges_per_shard[shard]), req.cl};
+        return container().invoke_on(shard, [gs, shard_req = std::move(shard_req), tr_info, timeout] (forward_service& fs) mutable {
+            return fs.execute_on_this_shard(gs.get(), std::move(shard_req), std::move(tr_info), timeout);
+        }).then([&partials] (query::forward_result partial) {
+            partials.push_back(std::move(partial));
+        });
+    });
+
+    co_return reduce_results(*schema, req.aggregations, std::move(partials));
+}
+
+future<query::forward_result> forward_service::dispatch(query::forward_request req, tracing::trace_state_ptr tr_state,
+        db::timeout_clock::time_point timeout) {
+    auto& db = _proxy.local_db();
+    schema_ptr schema = local_schema_registry().get(req.cmd.schema_version);
+    auto& ks = db.find_keyspace(schema->ks_name());
+    auto tr_info = tracing::make_trace_info(tr_state);
+
+    if (ks.get_replication_strategy().get_type() == locator::replication_strategy_type::local) {
+        tracing::trace(tr_state, "Executing aggregation on local shards");
+        co_return co_await dispatch_to_shards(schema, std::move(req), std::move(tr_info), timeout);
+    }
+
+    // Group vnodes by the replica which will compute the partial result for
+    // them. The closest live replica is chosen; the replica executes the read
+    // with the requested consistency level, so the choice affects only the
+    // amount of network traffic, not correctness.
+    std::map<gms::inet_address, dht::partition_range_vector> vnodes_per_endpoint;
+    query_ranges_to_vnodes_generator generator(_proxy.get_token_metadata_ptr(), schema, std::move(req.pr));
+    while (!generator.empty()) {
+        for (auto& vnode : generator(1)) {
+            auto endpoints = _proxy.get_live_sorted_endpoints(ks, end_token(vnode));
+            auto ep = endpoints.empty() ? utils::fb_utilities::get_broadcast_address() : endpoints.front();
+            vnodes_per_endpoint[ep].push_back(std::move(vnode));
+        }
+    }
+
+    std::vector<query::forward_result> partials;
+    partials.reserve(vnodes_per_endpoint.size());
+    co_await parallel_for_each(vnodes_per_endpoint, [&] (auto& ep_and_vnodes) -> future<> {
+        auto& [ep, vnodes] = ep_and_vnodes;
+        auto ep_req = query::forward_request{req.aggregations, req.cmd, std::move(vnodes), req.cl};
+        future<query::forward_result> f = make_ready_future<query::forward_result>();
+        if (utils::fb_utilities::is_me(ep)) {
+            tracing::trace(tr_state, "Executing aggregation on local shards");
+            f = dispatch_to_shards(schema, std::move(ep_req), tr_info, timeout);
+        } else {
+            _stats.requests_dispatched_to_other_nodes++;
+            tracing::trace(tr_state, "Sending forward request to /{}", ep);
+            f = _messaging.send_forward_request(netw::messaging_service::msg_addr{ep, 0}, timeout, ep_req, tr_info);
+        }
+        return f.then([&partials, &tr_state, ep = ep] (query::forward_result partial) {
+            tracing::trace(tr_state, "Received partial aggregation result from /{}", ep);
+            partials.push_back(std::move(partial));
+        });
+    });
+
+    co_return reduce_results(*schema, req.aggregations, std::move(partials));
+}
+
+void forward_service::init_messaging_service(shared_ptr<migration_manager> mm) {
+    _messaging.register_forward_request([this, mm] (const rpc::client_info& cinfo, rpc::opt_time_point t,
+            query::forward_request req, std::optional<tracing::trace_info> tr_info) -> future<query::forward_result> {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        auto timeout = t ? *t : db::no_timeout;
+        schema_ptr schema = co_await mm->get_schema_for_read(req.cmd.schema_version, std::move(src_addr), _messaging);
+        co_return co_await dispatch_to_shards(std::move(schema), std::move(req), std::move(tr_info), timeout);
+    });
+}
+
+future<> forward_service::uninit_messaging_service() {
+    return _messaging.unregister_forward_request();
+}
+
+} // namespace service
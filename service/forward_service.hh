@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <seastar/core/future.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/metrics_registration.hh>
+
+#include "db/timeout_clock.hh"
+#include "schema_fwd.hh"
+#include "query-request.hh"
+#include "tracing/trace_state.hh"
+
+namespace netw {
+class messaging_service;
+}
+
+namespace service {
+
+class storage_proxy;
+class migration_manager;
+
+// Executes aggregation queries (e.g. SELECT COUNT(*) FROM t) in parallel.
+//
+// The coordinator splits the queried ranges into vnodes and groups them by
+// the replica chosen to handle each vnode. Every group is sent to its replica
+// in a single FORWARD_REQUEST; the replica spreads the work over its shards,
+// each shard pages through the ranges it owns and computes partial aggregates,
+// and the partial results are merged on the way back to the coordinator.
+class forward_service : public seastar::peering_sharded_service<forward_service> {
+    netw::messaging_service& _messaging;
+    storage_proxy& _proxy;
+
+    struct stats {
+        uint64_t requests_dispatched_to_other_nodes = 0;
+        uint64_t requests_dispatched_to_own_shards = 0;
+        uint64_t requests_executed = 0;
+    } _stats;
+    seastar::metrics::metric_groups _metrics;
+public:
+    forward_service(netw::messaging_service& ms, storage_proxy& p);
+
+    future<> stop();
+
+    void init_messaging_service(shared_ptr<migration_manager> mm);
+    future<> uninit_messaging_service();
+
+    // Splits the request into vnode-sized pieces, executes them on the
+    // appropriate nodes and returns the merged aggregation result.
+    future<query::forward_result> dispatch(query::forward_request req, tracing::trace_state_ptr tr_state,
+            db::timeout_clock::time_point timeout);
+
+    // Returns true if partial results of the aggregation can be merged,
+    // i.e. there is a reducer for every aggregation in the request.
+    static bool can_be_parallelized(const schema& s, const std::vector<query::forward_request::aggregation_info>& aggregations);
+private:
+    // Used by the coordinator for its own vnodes and by a replica handling
+    // a FORWARD_REQUEST: distributes the ranges among the owning shards.
+    future<query::forward_result> dispatch_to_shards(schema_ptr schema, query::forward_request req, std::optional<tracing::trace_info> tr_info,
+            db::timeout_clock::time_point timeout);
+
+    // Computes partial aggregates over the given ranges on the current shard.
+    future<query::forward_result> execute_on_this_shard(schema_ptr schema, query::forward_request req, std::optional<tracing::trace_info> tr_info,
+            db::timeout_clock::time_point timeout);
+
+    void register_metrics();
+};
+
+} // namespace service
@@ -203,7 +203,8 @@ static bool has_clustering_keys(const schema& s, const query::read_command& cmd)
                 std::move(command),
                 std::move(ranges),
                 _options.get_consistency(),
-                {timeout, _state.get_permit(), _state.get_client_state(), _state.get_trace_state(), std::move(_last_replicas), _query_read_repair_decision});
+                {timeout, _state.get_permit(), _state.get_client_state(), _state.get_trace_state(), std::move(_last_replicas), _query_read_repair_decision,
+                        _state.get_latency_breakdown()});
     }
 
     future<> query_pager::fetch_page(cql3::selection::result_set_builder& builder, uint32_t page_size, gc_clock::time_point now, db::timeout_clock::time_point timeout) {
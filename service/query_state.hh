@@ -25,6 +25,7 @@
 
 #include "service/client_state.hh"
 #include "tracing/tracing.hh"
+#include "tracing/latency_breakdown.hh"
 #include "service_permit.hh"
 
 namespace qos {
@@ -37,6 +38,7 @@ class query_state final {
     client_state& _client_state;
     tracing::trace_state_ptr _trace_state_ptr;
     service_permit _permit;
+    tracing::latency_breakdown_ptr _latency_breakdown;
 
 public:
     query_state(client_state& client_state, service_permit permit)
@@ -78,6 +80,15 @@ class query_state final {
         return std::move(_permit);
     }
 
+    // Set when the client asked for the latency breakdown of the request.
+    const tracing::latency_breakdown_ptr& get_latency_breakdown() const {
+        return _latency_breakdown;
+    }
+
+    void set_latency_breakdown(tracing::latency_breakdown_ptr latency_breakdown) {
+        _latency_breakdown = std::move(latency_breakdown);
+    }
+
     qos::service_level_controller& get_service_level_controller() const {
         return _client_state.get_service_level_controller();
     }
@@ -1631,6 +1631,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("speculative_reads_won", speculative_reads_won,
+                       sm::description("number of speculative read requests whose replica replied before the consistency level was reached"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_histogram("cas_read_latency", sm::description("Transactional read latency histogram"),
                 {storage_proxy_stats::current_scheduling_group_label()},
                 [this]{ return to_metrics_histogram(estimated_cas_read);}),
@@ -1837,16 +1841,25 @@ storage_proxy::storage_proxy(distributed<database>& db, gms::gossiper& gossiper,
     , _connection_dropped([this] (gms::inet_address addr) { connection_dropped(std::move(addr)); })
     , _condrop_registration(_messaging.when_connection_drops(_connection_dropped))
     , _max_view_update_backlog(max_view_update_backlog)
-    , _view_update_handlers_list(std::make_unique<view_update_handlers_list>()) {
+    , _view_update_handlers_list(std::make_unique<view_update_handlers_list>())
+    , _result_cache(size_t(_db.local().get_config().coordinator_result_cache_size_in_mb()) << 20, _db.local().get_config().coordinator_result_cache_ttl_in_ms)
+    , _view_update_batches_timer([this] { send_view_update_batches(); }) {
     namespace sm = seastar::metrics;
     _metrics.add_group(storage_proxy_stats::COORDINATOR_STATS_CATEGORY, {
         sm::make_queue_length("current_throttled_writes", [this] { return _throttled_writes.size(); },
                        sm::description("number of currently throttled write requests")),
+        sm::make_total_operations("view_update_batches", _view_update_batch_stats.batches,
+                       sm::description("number of batches of view updates sent to paired view replicas, see view_update_batch_window_in_ms")),
+        sm::make_total_operations("view_update_batched_updates", _view_update_batch_stats.updates,
+                       sm::description("number of view updates sent in batches. Divided by view_update_batches, gives the batching factor")),
+        sm::make_total_operations("view_update_batched_mutations", _view_update_batch_stats.mutations,
+                       sm::description("number of mutations sent in batches of view updates, once the updates to the same view partition were merged")),
     });
 
     slogger.trace("hinted DCs: {}", cfg.hinted_handoff_enabled.to_configuration_string());
     _hints_manager.register_metrics("hints_manager");
     _hints_for_views_manager.register_metrics("hints_for_views_manager");
+    _result_cache.register_metrics();
 }
 
 storage_proxy::unique_response_handler::unique_response_handler(storage_proxy& p_, response_id_type id_) : id(id_), p(p_) {}
@@ -1870,11 +1883,24 @@ storage_proxy::response_id_type storage_proxy::unique_response_handler::release(
     return r;
 }
 
+void storage_proxy::invalidate_cached_results(const schema& s, const dht::token& t) {
+    _result_cache.invalidate(s.id(), t);
+}
+
+// Called on the shard which applied a write to this replica.
+static void maybe_invalidate_cached_results(const schema& s, const frozen_mutation& m) {
+    if (s.caching_options().coordinator_results()) {
+        get_local_storage_proxy().invalidate_cached_results(s, m.decorated_key(s).token());
+    }
+}
+
 void storage_proxy::connection_dropped(gms::inet_address addr) {
     slogger.debug("Drop hit rate info for {} because of disconnect", addr);
     for (auto&& cf : _db.local().get_non_system_column_families()) {
         cf->drop_hit_rate(addr);
+        cf->drop_replica_read_latency(addr);
     }
+    fall_back_view_update_batches(addr);
 }
 
 future<>
@@ -1887,7 +1913,9 @@ storage_proxy::mutate_locally(const mutation& m, tracing::trace_state_ptr tr_sta
              gtr = tracing::global_trace_state_ptr(std::move(tr_state)),
              timeout,
              sync] (database& db) mutable -> future<> {
-        return db.apply(s, m, gtr.get(), sync, timeout);
+        return db.apply(s, m, gtr.get(), sync, timeout).then([&s, &m] {
+            maybe_invalidate_cached_results(*s.get(), m);
+        });
     });
 }
 
@@ -1898,7 +1926,9 @@ storage_proxy::mutate_locally(const schema_ptr& s, const frozen_mutation& m, tra
     get_stats().replica_cross_shard_ops += shard != this_shard_id();
     return _db.invoke_on(shard, {smp_grp, timeout},
             [&m, gs = global_schema_ptr(s), gtr = tracing::global_trace_state_ptr(std::move(tr_state)), timeout, sync] (database& db) mutable -> future<> {
-        return db.apply(gs, m, gtr.get(), sync, timeout);
+        return db.apply(gs, m, gtr.get(), sync, timeout).then([&m, &gs] {
+            maybe_invalidate_cached_results(*gs.get(), m);
+        });
     });
 }
 
@@ -1920,7 +1950,9 @@ storage_proxy::mutate_hint(const schema_ptr& s, const frozen_mutation& m, tracin
     auto shard = _db.local().shard_of(m);
     get_stats().replica_cross_shard_ops += shard != this_shard_id();
     return _db.invoke_on(shard, {_hints_write_smp_service_group, timeout}, [&m, gs = global_schema_ptr(s), tr_state = std::move(tr_state), timeout] (database& db) mutable -> future<> {
-        return db.apply_hint(gs, m, std::move(tr_state), timeout);
+        return db.apply_hint(gs, m, std::move(tr_state), timeout).then([&m, &gs] {
+            maybe_invalidate_cached_results(*gs.get(), m);
+        });
     });
 }
 
@@ -1945,6 +1977,9 @@ storage_proxy::mutate_counter_on_leader_and_replicate(const schema_ptr& s, froze
         auto trace_state = gt.get();
         auto p = local ? std::move(permit) : /* FIXME: either obtain a real permit on this shard or hold original one across shard */ empty_service_permit();
         return db.apply_counter_update(gs, fm, timeout, trace_state).then([cl, timeout, trace_state, p = std::move(p)] (mutation m) mutable {
+            if (m.schema()->caching_options().coordinator_results()) {
+                service::get_local_storage_proxy().invalidate_cached_results(*m.schema(), m.token());
+            }
             return service::get_local_storage_proxy().replicate_counter_from_leader(std::move(m), cl, std::move(trace_state), timeout, std::move(p));
         });
     });
@@ -2679,6 +2714,136 @@ future<> storage_proxy::send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s,
             allow_hints::no);
 }
 
+future<> storage_proxy::send_hint_batch_to_endpoint(std::vector<frozen_mutation> fms, gms::inet_address target, tracing::trace_state_ptr tr_state) {
+    auto timeout = clock_type::now() + std::chrono::milliseconds(_db.local().get_config().write_request_timeout_in_ms());
+    tracing::trace(tr_state, "Sending a batch of {} hints to /{}", fms.size(), target);
+    return do_with(std::move(fms), [this, target, timeout, tr_state = std::move(tr_state)] (const std::vector<frozen_mutation>& fms) {
+        return _messaging.send_hint_mutation_batch(netw::messaging_service::msg_addr{target, 0}, timeout, fms, tracing::make_trace_info(tr_state));
+    });
+}
+
+future<> storage_proxy::send_view_update_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target,
+        tracing::trace_state_ptr tr_state, allow_hints allow_hints) {
+    auto window = _db.local().get_config().view_update_batch_window_in_ms();
+    if (!window || !_features.cluster_supports_view_update_batch()) {
+        return send_to_endpoint(std::move(fm_a_s), target, {}, db::write_type::VIEW, std::move(tr_state), allow_hints);
+    }
+    auto key = std::pair(target, bool(allow_hints));
+    auto& batch = _view_update_batches[key];
+    if (!batch) {
+        batch = make_lw_shared<view_update_batch>();
+    }
+    const auto size = fm_a_s.fm.representation().size();
+    auto [it, inserted] = batch->index.emplace(std::pair(fm_a_s.s->version(), to_bytes(fm_a_s.fm.key().representation())), batch->entries.size());
+    if (inserted) {
+        batch->entries.push_back(view_update_batch::entry{std::move(fm_a_s)});
+    } else {
+        auto& e = batch->entries[it->second];
+        if (!e.merged) {
+            e.merged = e.m.fm.unfreeze(e.m.s);
+        }
+        e.merged->apply(fm_a_s.fm.unfreeze(fm_a_s.s));
+    }
+    ++batch->updates;
+    batch->size += size;
+    tracing::trace(tr_state, "Added view update to the batch of {} updates to {}", batch->updates, target);
+    auto f = batch->sent.get_shared_future();
+    if (batch->size >= size_t(_db.local().get_config().view_update_batch_size_in_kb()) * 1024) {
+        auto full = std::move(batch);
+        _view_update_batches.erase(key);
+        send_view_update_batch(target, allow_hints, std::move(full));
+    } else if (!_view_update_batches_timer.armed()) {
+        _view_update_batches_timer.arm(std::chrono::milliseconds(window));
+    }
+    return f;
+}
+
+void storage_proxy::send_view_update_batches() {
+    for (auto& [key, batch] : std::exchange(_view_update_batches, {})) {
+        send_view_update_batch(key.first, allow_hints(key.second), std::move(batch));
+    }
+}
+
+// Sends the batch in the background, and resolves its promise once all of its
+// updates were applied. If the replica is down, or the batch fails, the updates
+// are sent again one at a time, so that they are hinted, if allowed, and their
+// failures accounted, as if they weren't batched.
+void storage_proxy::send_view_update_batch(gms::inet_address target, allow_hints allow_hints, lw_shared_ptr<view_update_batch> batch) {
+    if (!_gossiper.is_alive(target)) {
+        send_view_updates_one_at_a_time(target, allow_hints, std::move(batch));
+        return;
+    }
+    ++_view_update_batch_stats.batches;
+    _view_update_batch_stats.updates += batch->updates;
+    _view_update_batch_stats.mutations += batch->entries.size();
+    auto fms = boost::copy_range<std::vector<frozen_mutation>>(batch->entries | boost::adaptors::transformed([] (const view_update_batch::entry& e) {
+        return e.merged ? freeze(*e.merged) : e.m.fm;
+    }));
+    // Like single view updates, see send_to_endpoint(). The batch doesn't wait
+    // that long for a replica which goes down, see fall_back_view_update_batches().
+    auto timeout = clock_type::now() + 5min;
+    auto key = std::pair(target, bool(allow_hints));
+    _view_update_batches_in_flight.emplace(key, batch);
+    (void)do_with(std::move(fms), [this, target, timeout] (const std::vector<frozen_mutation>& fms) {
+        return _messaging.send_view_update_batch(netw::messaging_service::msg_addr{target, 0}, timeout, fms);
+    }).then_wrapped([this, p = shared_from_this(), key, batch] (future<db::view::update_backlog> f) {
+        auto [begin, end] = _view_update_batches_in_flight.equal_range(key);
+        auto it = std::find_if(begin, end, [&batch] (const auto& e) { return e.second == batch; });
+        if (it != end) {
+            _view_update_batches_in_flight.erase(it);
+        }
+        if (batch->done) {
+            // Already sent one at a time, the updates are idempotent.
+            f.ignore_ready_future();
+            return;
+        }
+        if (f.failed()) {
+            slogger.debug("Failed to send a batch of {} view updates to {}, sending them one at a time: {}", batch->updates, key.first, f.get_exception());
+            send_view_updates_one_at_a_time(key.first, allow_hints(key.second), batch);
+            return;
+        }
+        maybe_update_view_backlog_of(key.first, f.get0());
+        batch->done = true;
+        batch->sent.set_value();
+    });
+}
+
+void storage_proxy::send_view_updates_one_at_a_time(gms::inet_address target, allow_hints allow_hints, lw_shared_ptr<view_update_batch> batch) {
+    batch->done = true;
+    (void)parallel_for_each(batch->entries, [this, target, allow_hints] (view_update_batch::entry& e) {
+        auto m = e.merged ? frozen_mutation_and_schema{freeze(*e.merged), e.m.s} : e.m;
+        return send_to_endpoint(std::move(m), target, {}, db::write_type::VIEW, tracing::trace_state_ptr(), allow_hints);
+    }).then_wrapped([p = shared_from_this(), batch] (future<> f) {
+        if (f.failed()) {
+            batch->sent.set_exception(f.get_exception());
+        } else {
+            batch->sent.set_value();
+        }
+    });
+}
+
+// Called when the replica went down, or the connection to it dropped. Its
+// batches, those waiting for the window as well as those waiting for an
+// answer, are sent one update at a time right away, so that they are hinted
+// instead of waiting for the timeout of the batch.
+void storage_proxy::fall_back_view_update_batches(gms::inet_address target) {
+    auto first = std::pair(target, false);
+    auto last = std::pair(target, true);
+    for (auto it = _view_update_batches.lower_bound(first); it != _view_update_batches.upper_bound(last);) {
+        auto ah = allow_hints(it->first.second);
+        auto batch = std::move(it->second);
+        it = _view_update_batches.erase(it);
+        send_view_updates_one_at_a_time(target, ah, std::move(batch));
+    }
+    auto in_flight = std::vector<decltype(_view_update_batches_in_flight)::value_type>(
+            _view_update_batches_in_flight.lower_bound(first), _view_update_batches_in_flight.upper_bound(last));
+    for (auto& [key, batch] : in_flight) {
+        if (!batch->done) {
+            send_view_updates_one_at_a_time(target, allow_hints(key.second), batch);
+        }
+    }
+}
+
 future<> storage_proxy::send_hint_to_all_replicas(frozen_mutation_and_schema fm_a_s) {
     if (!_features.cluster_supports_hinted_handoff_separate_connection()) {
         std::array<mutation, 1> ms{fm_a_s.fm.unfreeze(fm_a_s.s)};
@@ -2984,6 +3149,9 @@ class digest_read_resolver : public abstract_read_resolver {
     bool has_data() {
         return _data_result;
     }
+    bool has_cl_responses() const {
+        return _cl_reported;
+    }
     void add_wait_targets(size_t targets_count) {
         _targets_count += targets_count;
     }
@@ -3503,7 +3671,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     tracing::trace_state_ptr _trace_state;
     lw_shared_ptr<column_family> _cf;
     bool _foreground = true;
+    // Whether the latency of each replica is tracked, see latency_read_balancing
+    bool _track_replica_latency;
     service_permit _permit; // holds admission permit until operation completes
+    // Local data reads add their replica side breakdown to it, if set
+    tracing::latency_breakdown_ptr _latency_breakdown;
 
 private:
     void on_read_resolved() noexcept {
@@ -3515,7 +3687,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     abstract_read_executor(schema_ptr s, lw_shared_ptr<column_family> cf, shared_ptr<storage_proxy> proxy, lw_shared_ptr<query::read_command> cmd, dht::partition_range pr, db::consistency_level cl, size_t block_for,
             inet_address_vector_replica_set targets, tracing::trace_state_ptr trace_state, service_permit permit) :
                            _schema(std::move(s)), _proxy(std::move(proxy)), _cmd(std::move(cmd)), _partition_range(std::move(pr)), _cl(cl), _block_for(block_for), _targets(std::move(targets)), _trace_state(std::move(trace_state)),
-                           _cf(std::move(cf)), _permit(std::move(permit)) {
+                           _cf(std::move(cf)), _track_replica_latency(_proxy->get_db().local().get_config().latency_read_balancing()), _permit(std::move(permit)) {
         _proxy->get_stats().reads++;
         _proxy->get_stats().foreground_reads++;
     }
@@ -3532,6 +3704,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         return _used_targets;
     }
 
+    void set_latency_breakdown(tracing::latency_breakdown_ptr latency_breakdown) {
+        _latency_breakdown = std::move(latency_breakdown);
+    }
+
 protected:
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> make_mutation_data_request(lw_shared_ptr<query::read_command> cmd, gms::inet_address ep, clock_type::time_point timeout) {
         ++_proxy->get_stats().mutation_data_read_attempts.get_ep_stat(ep);
@@ -3554,7 +3730,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   : query::result_options{query::result_request::only_result, query::digest_algorithm::none};
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_data: querying locally");
-            return _proxy->query_result_local(_schema, _cmd, _partition_range, opts, _trace_state, timeout);
+            return _proxy->query_result_local(_schema, _cmd, _partition_range, opts, _trace_state, timeout, _latency_breakdown);
         } else {
             tracing::trace(_trace_state, "read_data: sending a message to /{}", ep);
             return _proxy->_messaging.send_read_data(netw::messaging_service::msg_addr{ep, 0}, timeout, *_cmd, _partition_range, opts.digest_algo).then([this, ep](rpc::tuple<query::result, rpc::optional<cache_temperature>> result_hit_rate) {
@@ -3584,6 +3760,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            replica_read_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
                 try {
@@ -3591,8 +3768,9 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     _cf->set_hit_rate(ep, std::get<1>(v));
                     resolver->add_mutate_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().mutation_data_read_completed.get_ep_stat(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(ep, latency_clock::now() - start);
                 } catch(...) {
+                    replica_read_failed(ep, latency_clock::now() - start);
                     ++_proxy->get_stats().mutation_data_read_errors.get_ep_stat(ep);
                     resolver->error(ep, std::current_exception());
                 }
@@ -3602,16 +3780,19 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            replica_read_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
+                    got_response(*resolver, ep);
                     resolver->add_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().data_read_completed.get_ep_stat(ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(ep, latency_clock::now() - start);
                 } catch(...) {
+                    replica_read_failed(ep, latency_clock::now() - start);
                     ++_proxy->get_stats().data_read_errors.get_ep_stat(ep);
                     resolver->error(ep, std::current_exception());
                 }
@@ -3621,16 +3802,19 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            replica_read_started(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<2>(v));
+                    got_response(*resolver, ep);
                     resolver->add_digest(ep, std::get<0>(v), std::get<1>(v));
                     ++_proxy->get_stats().digest_read_completed.get_ep_stat(ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    register_request_latency(ep, latency_clock::now() - start);
                 } catch(...) {
+                    replica_read_failed(ep, latency_clock::now() - start);
                     ++_proxy->get_stats().digest_read_errors.get_ep_stat(ep);
                     resolver->error(ep, std::current_exception());
                 }
@@ -3644,6 +3828,9 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         make_digest_requests(resolver, _targets.begin() + 1, _targets.end(), timeout);
     }
     virtual void got_cl() {}
+    // Called when a replica replies to a data or digest request, before the
+    // reply is handed to the resolver.
+    virtual void got_response(const digest_read_resolver& resolver, gms::inet_address ep) {}
     uint64_t original_row_limit() const {
         return _cmd->get_row_limit();
     }
@@ -3828,8 +4015,21 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
 
 private:
-    void register_request_latency(latency_clock::duration d) {
+    void replica_read_started(gms::inet_address ep) {
+        if (_track_replica_latency) {
+            _cf->replica_read_started(ep);
+        }
+    }
+    void replica_read_failed(gms::inet_address ep, latency_clock::duration elapsed) {
+        if (_track_replica_latency) {
+            _cf->replica_read_failed(ep, elapsed);
+        }
+    }
+    void register_request_latency(gms::inet_address ep, latency_clock::duration d) {
         _max_request_latency = std::max(_max_request_latency, d);
+        if (_track_replica_latency) {
+            _cf->replica_read_finished(ep, d);
+        }
     }
 
     static constexpr latency_clock::duration NO_LATENCY{-1};
@@ -3861,12 +4061,32 @@ class always_speculating_read_executor : public abstract_read_executor {
 // this executor sends request to an additional replica after some time below timeout
 class speculating_read_executor : public abstract_read_executor {
     timer<storage_proxy::clock_type> _speculate_timer;
+    bool _speculated = false;
+
+    // How long to wait for the replicas read from before speculating: the
+    // given percentile of their latency if it is tracked, the worst one
+    // among them, or else of the coordinator latency of the table.
+    std::chrono::milliseconds read_latency_percentile(double percentile) {
+        if (!_track_replica_latency) {
+            return _cf->get_coordinator_read_latency_percentile(percentile);
+        }
+        std::chrono::microseconds t{0};
+        for (const gms::inet_address& ep : boost::make_iterator_range(_targets.begin(), _targets.end() - 1)) {
+            auto q = _cf->get_replica_read_latency_quantile(ep, percentile);
+            if (!q) {
+                return _cf->get_coordinator_read_latency_percentile(percentile);
+            }
+            t = std::max(t, *q);
+        }
+        return std::max(std::chrono::ceil<std::chrono::milliseconds>(t), std::chrono::milliseconds(1));
+    }
 public:
     using abstract_read_executor::abstract_read_executor;
     virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
         _speculate_timer.set_callback([this, resolver, timeout] {
             if (!resolver->is_completed()) { // at the time the callback runs request may be completed already
                 resolver->add_wait_targets(1); // we send one more request so wait for it too
+                _speculated = true;
                 // FIXME: consider disabling for CL=*ONE
                 auto send_request = [&] (bool has_data) {
                     if (has_data) {
@@ -3882,7 +4102,7 @@ class speculating_read_executor : public abstract_read_executor {
         });
         auto& sr = _schema->speculative_retry();
         auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
+            std::min(read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
             std::chrono::milliseconds(unsigned(sr.get_value()));
         _speculate_timer.arm(t);
 
@@ -3907,11 +4127,35 @@ class speculating_read_executor : public abstract_read_executor {
     virtual void got_cl() override {
         _speculate_timer.cancel();
     }
+    virtual void got_response(const digest_read_resolver& resolver, gms::inet_address ep) override {
+        if (_speculated && ep == _targets.back() && !resolver.has_cl_responses()) {
+            _proxy->get_stats().speculative_reads_won++;
+        }
+    }
     virtual void adjust_targets_for_reconciliation() override {
         _targets = used_targets();
     }
 };
 
+// Orders the replicas of the local data center, which come first, from the
+// one expected to reply the soonest: the one with the lowest average latency,
+// weighted by the number of reads in flight to it (see table::replica_read_score()).
+// Replicas of other data centers stay in proximity order.
+static void sort_endpoints_by_read_latency(column_family& cf, inet_address_vector_replica_set& eps) {
+    auto local_end = std::stable_partition(eps.begin(), eps.end(), db::is_local);
+    if (std::distance(eps.begin(), local_end) < 2) {
+        return;
+    }
+    utils::small_vector<std::pair<double, gms::inet_address>, 3> scored;
+    for (auto ep : boost::make_iterator_range(eps.begin(), local_end)) {
+        scored.emplace_back(cf.replica_read_score(ep), ep);
+    }
+    std::stable_sort(scored.begin(), scored.end(), [] (const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    boost::range::transform(scored, eps.begin(), [] (const auto& p) { return p.second; });
+}
+
 db::read_repair_decision storage_proxy::new_read_repair_decision(const schema& s) {
     if (s.dc_local_read_repair_chance() > 0 || s.read_repair_chance() > 0) {
         double chance = _read_repair_chance(_urandom);
@@ -3949,9 +4193,13 @@ ::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_
     is_read_non_local |= !all_replicas.empty() && all_replicas.front() != utils::fb_utilities::get_broadcast_address();
 
     auto cf = _db.local().find_column_family(schema).shared_from_this();
+    bool latency_read_balancing = _db.local().get_config().latency_read_balancing();
+    if (latency_read_balancing) {
+        sort_endpoints_by_read_latency(*cf, all_replicas);
+    }
     inet_address_vector_replica_set target_replicas = db::filter_for_query(cl, ks, all_replicas, preferred_endpoints, repair_decision,
             retry_type == speculative_retry::type::NONE ? nullptr : &extra_replica,
-            _db.local().get_config().cache_hit_rate_read_balancing() ? &*cf : nullptr);
+            _db.local().get_config().cache_hit_rate_read_balancing() && !latency_read_balancing ? &*cf : nullptr);
 
     slogger.trace("creating read executor for token {} with all: {} targets: {} rp decision: {}", token, all_replicas, target_replicas, repair_decision);
     tracing::trace(trace_state, "Creating read executor for token {} with all: {} targets: {} repair decision: {}", token, all_replicas, target_replicas, repair_decision);
@@ -4012,19 +4260,32 @@ storage_proxy::query_result_local_digest(schema_ptr s, lw_shared_ptr<query::read
 
 future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>
 storage_proxy::query_result_local(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr, query::result_options opts,
-                                  tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout) {
+                                  tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout,
+                                  tracing::latency_breakdown_ptr latency_breakdown) {
     cmd->slice.options.set_if<query::partition_slice::option::with_digest>(opts.request != query::result_request::only_result);
     if (pr.is_singular()) {
         unsigned shard = dht::shard_of(*s, pr.start()->value().token());
         get_stats().replica_cross_shard_ops += shard != this_shard_id();
-        return _db.invoke_on(shard, _read_smp_service_group, [gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state))] (database& db) mutable {
+        // The replica shard returns its part of the breakdown with the result,
+        // to be added to the breakdown of the request back on this shard.
+        using replica_result = std::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature, tracing::latency_breakdown>;
+        return _db.invoke_on(shard, _read_smp_service_group, [gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state)),
+                with_latency_breakdown = bool(latency_breakdown)] (database& db) mutable {
             auto trace_state = gt.get();
             tracing::trace(trace_state, "Start querying singular range {}", prv.front());
-            return db.query(gs, *cmd, opts, prv, trace_state, timeout).then([trace_state](std::tuple<lw_shared_ptr<query::result>, cache_temperature>&& f_ht) {
+            auto lb = with_latency_breakdown ? std::make_unique<tracing::latency_breakdown>() : nullptr;
+            auto f = db.query(gs, *cmd, opts, prv, trace_state, timeout, lb.get());
+            return f.then([trace_state, lb = std::move(lb)] (std::tuple<lw_shared_ptr<query::result>, cache_temperature>&& f_ht) {
                 auto&& [f, ht] = f_ht;
                 tracing::trace(trace_state, "Querying is done");
-                return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(rpc::tuple(make_foreign(std::move(f)), ht));
+                return make_ready_future<replica_result>(replica_result(make_foreign(std::move(f)), ht, lb ? *lb : tracing::latency_breakdown()));
             });
+        }).then([latency_breakdown = std::move(latency_breakdown)] (replica_result r) {
+            auto&& [result, hit_rate, lb] = r;
+            if (latency_breakdown) {
+                *latency_breakdown += lb;
+            }
+            return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(rpc::tuple(std::move(result), hit_rate));
         });
     } else {
         // FIXME: adjust multishard_mutation_query to accept an smp_service_group and propagate it there
@@ -4084,6 +4345,7 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd,
         auto read_executor = get_read_executor(cmd, schema, std::move(pr), cl, repair_decision,
                                                query_options.trace_state, replicas, is_read_non_local,
                                                query_options.permit);
+        read_executor->set_latency_breakdown(query_options.latency_breakdown);
 
         exec.emplace_back(read_executor, std::move(token_range));
     }
@@ -4448,16 +4710,20 @@ storage_proxy::do_query(schema_ptr s,
         lc.start();
         auto p = shared_from_this();
 
+        auto latency_breakdown = query_options.latency_breakdown;
         if (query::is_single_partition(partition_ranges[0])) { // do not support mixed partitions (yet?)
             try {
                 return query_singular(cmd,
                         std::move(partition_ranges),
                         cl,
-                        std::move(query_options)).finally([lc, p] () mutable {
+                        std::move(query_options)).finally([lc, p, latency_breakdown] () mutable {
                     p->get_stats().read.mark(lc.stop().latency());
                     if (lc.is_start()) {
                         p->get_stats().estimated_read.add(lc.latency());
                     }
+                    if (latency_breakdown) {
+                        latency_breakdown->replica_wait += lc.latency();
+                    }
                 });
             } catch (const no_such_column_family&) {
                 get_stats().read.mark(lc.stop().latency());
@@ -4468,11 +4734,14 @@ storage_proxy::do_query(schema_ptr s,
         return query_partition_key_range(cmd,
                 std::move(partition_ranges),
                 cl,
-                std::move(query_options)).finally([lc, p] () mutable {
+                std::move(query_options)).finally([lc, p, latency_breakdown] () mutable {
             p->get_stats().range.mark(lc.stop().latency());
             if (lc.is_start()) {
                 p->get_stats().estimated_range.add(lc.latency());
             }
+            if (latency_breakdown) {
+                latency_breakdown->replica_wait += lc.latency();
+            }
         });
     }
 }
@@ -5057,6 +5326,45 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
     ms.register_mutation(std::bind_front<>(receive_mutation_handler, mm, _write_smp_service_group));
     ms.register_hint_mutation(std::bind_front<>(receive_mutation_handler, mm, _hints_write_smp_service_group));
 
+    ms.register_hint_mutation_batch([&ms, mm, smp_grp = _hints_write_smp_service_group] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> fms,
+            rpc::optional<std::optional<tracing::trace_info>> trace_info) {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        auto timeout = t ? *t : db::no_timeout;
+        tracing::trace_state_ptr trace_state_ptr;
+        if (trace_info && *trace_info) {
+            trace_state_ptr = tracing::tracing::get_local_tracing_instance().create_session(**trace_info);
+            tracing::begin(trace_state_ptr);
+            tracing::trace(trace_state_ptr, "Message received from /{}", src_addr.addr);
+        }
+        return do_with(std::move(fms), [src_addr, timeout, &ms, mm, smp_grp, trace_state_ptr] (const std::vector<frozen_mutation>& fms) {
+            auto p = get_local_shared_storage_proxy();
+            p->get_stats().received_mutations += fms.size();
+            return parallel_for_each(fms, [src_addr, timeout, &ms, mm, smp_grp, p, trace_state_ptr] (const frozen_mutation& fm) {
+                return mm->get_schema_for_write(fm.schema_version(), src_addr, ms).then([&fm, timeout, smp_grp, p, trace_state_ptr] (schema_ptr s) {
+                    return p->mutate_locally(std::move(s), fm, trace_state_ptr, db::commitlog::force_sync::no, timeout, smp_grp);
+                });
+            }).finally([trace_state_ptr, n = fms.size()] {
+                tracing::trace(trace_state_ptr, "Batch of {} hints handling is done", n);
+            });
+        });
+    });
+
+    ms.register_view_update_batch([&ms, mm, smp_grp = _write_smp_service_group] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> fms) {
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        auto timeout = t ? *t : db::no_timeout;
+        return do_with(std::move(fms), [src_addr, timeout, &ms, mm, smp_grp] (const std::vector<frozen_mutation>& fms) {
+            auto p = get_local_shared_storage_proxy();
+            p->get_stats().received_mutations += fms.size();
+            return parallel_for_each(fms, [src_addr, timeout, &ms, mm, smp_grp, p] (const frozen_mutation& fm) {
+                return mm->get_schema_for_write(fm.schema_version(), src_addr, ms).then([&fm, timeout, smp_grp, p] (schema_ptr s) {
+                    return p->mutate_locally(std::move(s), fm, tracing::trace_state_ptr(), db::commitlog::force_sync::no, timeout, smp_grp);
+                });
+            }).then([p] {
+                return p->get_view_update_backlog();
+            });
+        });
+    });
+
     ms.register_paxos_learn([mm] (const rpc::client_info& cinfo, rpc::opt_time_point t, paxos::proposal decision,
             std::vector<gms::inet_address> forward, gms::inet_address reply_to, unsigned shard,
             storage_proxy::response_id_type response_id, std::optional<tracing::trace_info> trace_info) {
@@ -5188,7 +5496,9 @@ void storage_proxy::init_messaging_service(shared_ptr<migration_manager> mm) {
         return do_with(utils::make_joinpoint([] { return db_clock::now();}),
                         [this, ksname, cfname](auto& tsf) {
             return container().invoke_on_all(_write_smp_service_group, [ksname, cfname, &tsf](storage_proxy& sp) {
-                return sp._db.local().truncate(ksname, cfname, [&tsf] { return tsf.value(); });
+                return sp._db.local().truncate(ksname, cfname, [&tsf] { return tsf.value(); }).then([&sp, ksname, cfname] {
+                    sp._result_cache.invalidate(sp._db.local().find_uuid(ksname, cfname));
+                });
             });
         });
     });
@@ -5302,6 +5612,8 @@ future<> storage_proxy::uninit_messaging_service() {
         ms.unregister_counter_mutation(),
         ms.unregister_mutation(),
         ms.unregister_hint_mutation(),
+        ms.unregister_hint_mutation_batch(),
+        ms.unregister_view_update_batch(),
         ms.unregister_mutation_done(),
         ms.unregister_mutation_failed(),
         ms.unregister_read_data(),
@@ -5528,6 +5840,7 @@ void storage_proxy::retire_view_response_handlers(noncopyable_function<bool(cons
 }
 
 void storage_proxy::on_down(const gms::inet_address& endpoint) {
+    fall_back_view_update_batches(endpoint);
     return retire_view_response_handlers([endpoint] (const abstract_write_response_handler& handler) {
         const auto& targets = handler.get_targets();
         return boost::find(targets, endpoint) != targets.end();
@@ -5538,6 +5851,9 @@ future<> storage_proxy::drain_on_shutdown() {
     //NOTE: the thread is spawned here because there are delicate lifetime issues to consider
     // and writing them down with plain futures is error-prone.
     return async([this] {
+        // Don't leave view updates waiting for the batching window.
+        _view_update_batches_timer.cancel();
+        send_view_update_batches();
         retire_view_response_handlers([] (const abstract_write_response_handler&) { return true; });
         _hints_resource_manager.stop().get();
     });
@@ -50,6 +50,7 @@
 #include <seastar/core/distributed.hh>
 #include <seastar/core/execution_stage.hh>
 #include <seastar/core/scheduling_specific.hh>
+#include <seastar/core/shared_future.hh>
 #include "db/consistency_level_type.hh"
 #include "db/read_repair_decision.hh"
 #include "db/write_type.hh"
@@ -59,6 +60,7 @@
 #include "utils/histogram.hh"
 #include "utils/estimated_histogram.hh"
 #include "tracing/trace_state.hh"
+#include "tracing/latency_breakdown.hh"
 #include <seastar/core/metrics.hh>
 #include "storage_proxy_stats.hh"
 #include "cache_temperature.hh"
@@ -68,6 +70,7 @@
 #include "locator/abstract_replication_strategy.hh"
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
+#include "service/coordinator_result_cache.hh"
 #include "service/endpoint_lifecycle_subscriber.hh"
 
 class reconcilable_result;
@@ -216,19 +219,23 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         tracing::trace_state_ptr trace_state = nullptr;
         replicas_per_token_range preferred_replicas;
         std::optional<db::read_repair_decision> read_repair_decision;
+        // Where the time of the request goes, if set.
+        tracing::latency_breakdown_ptr latency_breakdown;
 
         coordinator_query_options(clock_type::time_point timeout,
                 service_permit permit_,
                 client_state& client_state_,
                 tracing::trace_state_ptr trace_state = nullptr,
                 replicas_per_token_range preferred_replicas = { },
-                std::optional<db::read_repair_decision> read_repair_decision = { })
+                std::optional<db::read_repair_decision> read_repair_decision = { },
+                tracing::latency_breakdown_ptr latency_breakdown = { })
             : _timeout(timeout)
             , permit(std::move(permit_))
             , cstate(client_state_)
             , trace_state(std::move(trace_state))
             , preferred_replicas(std::move(preferred_replicas))
-            , read_repair_decision(read_repair_decision) {
+            , read_repair_decision(read_repair_decision)
+            , latency_breakdown(std::move(latency_breakdown)) {
         }
 
         clock_type::time_point timeout(storage_proxy& sp) const {
@@ -262,6 +269,11 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
 
     query::max_result_size get_max_result_size(const query::partition_slice& slice) const;
 
+    // Returns the natural endpoints of `token` which are currently alive,
+    // optionally sorted by their proximity to this node.
+    inet_address_vector_replica_set get_live_endpoints(keyspace& ks, const dht::token& token) const;
+    inet_address_vector_replica_set get_live_sorted_endpoints(keyspace& ks, const dht::token& token) const;
+
 private:
     distributed<database>& _db;
     gms::gossiper& _gossiper;
@@ -331,6 +343,37 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     cdc::cdc_service* _cdc = nullptr;
 
     cdc_stats _cdc_stats;
+
+    coordinator_result_cache _result_cache;
+
+    // View updates to a paired view replica, gathered to be sent in a single
+    // VIEW_UPDATE_BATCH message. See send_view_update_to_endpoint().
+    struct view_update_batch {
+        struct entry {
+            frozen_mutation_and_schema m;
+            // Engaged once another update to the same view partition was merged into it.
+            mutation_opt merged;
+        };
+        // One per view partition
+        std::vector<entry> entries;
+        std::map<std::pair<table_schema_version, bytes>, size_t> index;
+        // Number and size of the updates added, before merging
+        size_t updates = 0;
+        size_t size = 0;
+        shared_promise<> sent;
+        // Set once the batch was answered, or its updates sent one at a time
+        bool done = false;
+    };
+    // By replica, and whether the updates may be hinted
+    std::map<std::pair<gms::inet_address, bool>, lw_shared_ptr<view_update_batch>> _view_update_batches;
+    // The batches sent and not answered yet, keyed like _view_update_batches
+    std::multimap<std::pair<gms::inet_address, bool>, lw_shared_ptr<view_update_batch>> _view_update_batches_in_flight;
+    timer<> _view_update_batches_timer;
+    struct view_update_batch_stats {
+        uint64_t batches = 0;
+        uint64_t updates = 0;
+        uint64_t mutations = 0;
+    } _view_update_batch_stats;
 private:
     future<coordinator_query_result> query_singular(lw_shared_ptr<query::read_command> cmd,
             dht::partition_range_vector&& partition_ranges,
@@ -364,9 +407,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     bool cannot_hint(const Range& targets, db::write_type type) const;
     bool hints_enabled(db::write_type type) const noexcept;
     db::hints::manager& hints_manager_for(db::write_type type);
-    inet_address_vector_replica_set get_live_endpoints(keyspace& ks, const dht::token& token) const;
     static void sort_endpoints_by_proximity(inet_address_vector_replica_set& eps);
-    inet_address_vector_replica_set get_live_sorted_endpoints(keyspace& ks, const dht::token& token) const;
     db::read_repair_decision new_read_repair_decision(const schema& s);
     ::shared_ptr<abstract_read_executor> get_read_executor(lw_shared_ptr<query::read_command> cmd,
             schema_ptr schema,
@@ -380,7 +421,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> query_result_local(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr,
                                                                            query::result_options opts,
                                                                            tracing::trace_state_ptr trace_state,
-                                                                           clock_type::time_point timeout);
+                                                                           clock_type::time_point timeout,
+                                                                           tracing::latency_breakdown_ptr latency_breakdown = {});
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> query_result_local_digest(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr,
                                                                                                    tracing::trace_state_ptr trace_state,
                                                                                                    clock_type::time_point timeout,
@@ -460,6 +502,10 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
 
     void retire_view_response_handlers(noncopyable_function<bool(const abstract_write_response_handler&)> filter_fun);
     void connection_dropped(gms::inet_address);
+    void send_view_update_batches();
+    void send_view_update_batch(gms::inet_address target, allow_hints allow_hints, lw_shared_ptr<view_update_batch> batch);
+    void send_view_updates_one_at_a_time(gms::inet_address target, allow_hints allow_hints, lw_shared_ptr<view_update_batch> batch);
+    void fall_back_view_update_batches(gms::inet_address target);
 public:
     storage_proxy(distributed<database>& db, gms::gossiper& gossiper, config cfg, db::view::node_update_backlog& max_view_update_backlog,
             scheduling_group_key stats_key, gms::feature_service& feat, const locator::shared_token_metadata& stm, locator::effective_replication_map_factory& erm_factory, netw::messaging_service& ms);
@@ -467,6 +513,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     const distributed<database>& get_db() const {
         return _db;
     }
+    db::hints::manager& get_hints_manager() noexcept {
+        return _hints_manager;
+    }
     distributed<database>& get_db() {
         return _db;
     }
@@ -492,6 +541,15 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         return *_view_update_handlers_list;
     }
 
+    coordinator_result_cache& get_result_cache() {
+        return _result_cache;
+    }
+
+    // Invalidates the cached results of a partition written to on this
+    // replica. Must be called on the shard owning the token, after the
+    // write was applied.
+    void invalidate_cached_results(const schema& s, const dht::token& t);
+
     response_id_type get_next_response_id() {
         auto next = _next_response_id++;
         if (next == 0) { // 0 is reserved for unique_response_handler
@@ -580,6 +638,22 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     // and use different RPC verb.
     future<> send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target);
 
+    // Send several mutations to a specific remote target as hints, in a single
+    // HINT_MUTATION_BATCH message. Resolves once the target has applied all of them.
+    // Requires the HINT_MUTATION_BATCH cluster feature.
+    future<> send_hint_batch_to_endpoint(std::vector<frozen_mutation> fms, gms::inet_address target, tracing::trace_state_ptr tr_state = nullptr);
+
+    // Send a view update to a paired view replica with no pending endpoints.
+    // When view_update_batch_window_in_ms is set, the update is merged with
+    // the other updates to the same view partition and sent with the other
+    // updates to the replica gathered in that window, in a single message.
+    // Once the replica goes down, or the connection to it drops, its batches
+    // are sent one update at a time instead.
+    // Resolves, like send_to_endpoint(), once the replica applied the update,
+    // or it was hinted.
+    future<> send_view_update_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target,
+            tracing::trace_state_ptr tr_state, allow_hints allow_hints);
+
     /**
      * Performs the truncate operatoin, which effectively deletes all data from
      * the column family cfname
@@ -651,6 +725,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     const global_stats& get_global_stats() const {
         return _global_stats;
     }
+    const view_update_batch_stats& get_view_update_batch_stats() const {
+        return _view_update_batch_stats;
+    }
     global_stats& get_global_stats() {
         return _global_stats;
     }
@@ -27,6 +27,7 @@
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/loop.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
@@ -34,6 +35,7 @@
 #include "unimplemented.hh"
 #include "segmented_compress_params.hh"
 #include "utils/class_registrator.hh"
+#include "utils/div_ceil.hh"
 
 namespace sstables {
 
@@ -266,7 +268,7 @@ local_compression::local_compression(compressor_ptr p)
 local_compression::local_compression(const compression& c)
     : _compressor([&c] {
         sstring n(c.name.value.begin(), c.name.value.end());
-        return compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
+        auto p = compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
             if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
                 return to_sstring(c.chunk_len / 1024);
             }
@@ -280,6 +282,10 @@ local_compression::local_compression(const compression& c)
             }
             return std::nullopt;
         });
+        if (p && c.dictionary()) {
+            return p->with_dictionary(*c.dictionary());
+        }
+        return p;
     }())
 {}
 
@@ -487,23 +493,25 @@ enum class compressed_checksum_mode {
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink_impl : public data_sink_impl {
+    // Large enough for zstd to gain most of what a dictionary can bring
+    // to chunks of a few KiB.
+    static constexpr size_t max_dictionary_size = 16 * 1024;
+    // Training runs on the reactor and can't be preempted, so its input is
+    // kept small enough for it to take about a millisecond.
+    static constexpr size_t max_training_size = 8 * max_dictionary_size;
+
     output_stream<char> _out;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::writer _offsets;
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
-public:
-    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
-            : _out(std::move(out))
-            , _compression_metadata(cm)
-            , _offsets(_compression_metadata->offsets.get_writer())
-            , _compression(lc)
-            , _full_checksum(ChecksumType::init_checksum())
-    {}
-
-    virtual future<> put(net::packet data) override { abort(); }
-    virtual future<> put(temporary_buffer<char> buf) override {
+    // Chunks held back until there is enough of them to train a dictionary.
+    size_t _dictionary_sample_size;
+    size_t _sampled = 0;
+    std::vector<temporary_buffer<char>> _samples;
+private:
+    future<> compress_and_write(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -543,8 +551,62 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
+
+    // Trains a dictionary from the chunks held back and writes them. If
+    // the samples are not enough to train one, compresses without.
+    future<> write_samples() {
+        _dictionary_sample_size = 0;
+        // Training copies its input into one buffer, and its cost grows
+        // with the input, so it is given evenly spaced chunks of at most
+        // max_training_size bytes in all.
+        auto step = std::max(size_t(1), div_ceil(_sampled, max_training_size));
+        std::vector<bytes_view> samples;
+        samples.reserve(div_ceil(_samples.size(), step));
+        size_t training_size = 0;
+        for (size_t i = 0; i < _samples.size() && training_size < max_training_size; i += step) {
+            auto& buf = _samples[i];
+            auto size = std::min(buf.size(), max_training_size - training_size);
+            samples.emplace_back(reinterpret_cast<const int8_t*>(buf.get()), size);
+            training_size += size;
+        }
+        auto dictionary = _compression.compressor()->train_dictionary(samples, max_dictionary_size);
+        if (dictionary) {
+            _compression_metadata->set_dictionary(std::move(dictionary));
+            _compression = sstables::local_compression(_compression.compressor()->with_dictionary(*_compression_metadata->dictionary()));
+        }
+        return do_for_each(_samples, [this] (temporary_buffer<char>& buf) {
+            return compress_and_write(std::move(buf));
+        }).then([this] {
+            _samples.clear();
+        });
+    }
+public:
+    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc, size_t dictionary_sample_size)
+            : _out(std::move(out))
+            , _compression_metadata(cm)
+            , _offsets(_compression_metadata->offsets.get_writer())
+            , _compression(lc)
+            , _full_checksum(ChecksumType::init_checksum())
+            , _dictionary_sample_size(dictionary_sample_size)
+    {}
+
+    virtual future<> put(net::packet data) override { abort(); }
+    virtual future<> put(temporary_buffer<char> buf) override {
+        if (_dictionary_sample_size) {
+            _sampled += buf.size();
+            _samples.push_back(std::move(buf));
+            if (_sampled < _dictionary_sample_size) {
+                return make_ready_future<>();
+            }
+            return write_samples();
+        }
+        return compress_and_write(std::move(buf));
+    }
     virtual future<> close() override {
-        return _out.close();
+        auto f = _dictionary_sample_size && !_samples.empty() ? write_samples() : make_ready_future<>();
+        return f.finally([this] {
+            return _out.close();
+        });
     }
 
     virtual size_t buffer_size() const noexcept override {
@@ -556,16 +618,17 @@ template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink : public data_sink {
 public:
-    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc, size_t dictionary_sample_size)
         : data_sink(std::make_unique<compressed_file_data_sink_impl<ChecksumType, mode>>(
-                std::move(out), cm, std::move(lc))) {}
+                std::move(out), cm, std::move(lc), dictionary_sample_size)) {}
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 inline output_stream<char> make_compressed_file_output_stream(output_stream<char> out,
          sstables::compression* cm,
-         const compression_parameters& cp) {
+         const compression_parameters& cp,
+         size_t dictionary_sample_size) {
     // buffer of output stream is set to chunk length, because flush must
     // happen every time a chunk was filled up.
 
@@ -577,7 +640,11 @@ inline output_stream<char> make_compressed_file_output_stream(output_stream<char
     // defaults to 1.0.
     cm->options.elements.push_back({"crc_check_chance", "1.0"});
 
-    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p));
+    if (!p->supports_dictionary()) {
+        dictionary_sample_size = 0;
+    }
+
+    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p, dictionary_sample_size));
 }
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
@@ -595,8 +662,9 @@ input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(output_stream<char> out,
         sstables::compression* cm,
-        const compression_parameters& cp) {
+        const compression_parameters& cp,
+        size_t dictionary_sample_size) {
     return make_compressed_file_output_stream<crc32_utils, compressed_checksum_mode::checksum_all>(
-            std::move(out), cm, cp);
+            std::move(out), cm, cp, dictionary_sample_size);
 }
 
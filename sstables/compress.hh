@@ -314,6 +314,9 @@ struct compression {
     // Variables *not* found in the "Compression Info" file (added by update()):
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
+    // Dictionary the chunks are compressed with, if any. Stored in the
+    // CompressionDictionary component.
+    std::unique_ptr<const compression_dictionary> _dictionary;
 public:
     // Set the compressor algorithm, please check the definition of enum compressor.
     void set_compressor(compressor_ptr c);
@@ -371,6 +374,14 @@ struct compression {
         _full_checksum = checksum;
     }
 
+    const compression_dictionary* dictionary() const noexcept {
+        return _dictionary.get();
+    }
+
+    void set_dictionary(std::unique_ptr<const compression_dictionary> dictionary) {
+        _dictionary = std::move(dictionary);
+    }
+
     friend class sstable;
 };
 
@@ -390,9 +401,14 @@ input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
                 class file_input_stream_options options);
 
+// If the compressor supports it and dictionary_sample_size is not 0, the
+// stream holds back the first dictionary_sample_size bytes of data, trains
+// a dictionary from them, and compresses all the chunks with it. The
+// dictionary is set in the compression metadata.
 output_stream<char> make_compressed_file_m_format_output_stream(output_stream<char> out,
                 sstables::compression* cm,
-                const compression_parameters& cp);
+                const compression_parameters& cp,
+                size_t dictionary_sample_size = 0);
 
 }
 
@@ -792,7 +792,9 @@ class writer : public sstable_writer::writer_impl {
         // exactly what callers used to do anyway.
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
-        _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _schema.bloom_filter_fp_chance());
+        auto compressor = _schema.get_compressor_params().get_compressor();
+        _sst.generate_toc(compressor, _schema.bloom_filter_fp_chance(),
+                compressor && compressor->supports_dictionary() && _cfg.compression_dictionary_sample_size);
         _sst.write_toc(_pc);
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -800,7 +802,8 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(),
+                _cfg.blocked_bloom_filter ? utils::filter_format::blocked_format : utils::filter_format::m_format);
         _pi_write_m.desired_block_size = cfg.promoted_index_block_size;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
@@ -892,7 +895,9 @@ void writer::init_file_writers() {
             make_compressed_file_m_format_output_stream(
                 std::move(out),
                 &_sst._components->compression,
-                _schema.get_compressor_params()), _sst.filename(component_type::Data));
+                _schema.get_compressor_params(),
+                _sst.has_component(component_type::CompressionDictionary) ? _cfg.compression_dictionary_sample_size : 0),
+            _sst.filename(component_type::Data));
     }
     auto w = file_writer::make(std::move(_sst._index_file), std::move(options), _sst.filename(component_type::Index));
     _index_writer = std::make_unique<file_writer>(w.get0());
@@ -1489,6 +1494,9 @@ void writer::consume_end_of_stream() {
     _sst.write_statistics(_pc);
     _sst.write_compression(_pc);
     auto features = sstable_enabled_features::all();
+    if (!_cfg.blocked_bloom_filter) {
+        features.disable(sstable_feature::BlockedBloomFilter);
+    }
     run_identifier identifier{_run_identifier};
     std::optional<scylla_metadata::large_data_stats> ld_stats(std::move(_large_data_stats));
     _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
@@ -117,7 +117,10 @@ sstable_directory::process_descriptor(sstables::entry_descriptor desc, const ::i
         validate(sst);
         if (_need_mutate_level) {
             dirlog.trace("Mutating {} to level 0\n", sst->get_filename());
-            return sst->mutate_sstable_level(0);
+            // Uploaded sstables weren't repaired with the replicas of this cluster.
+            return sst->mutate_sstable_level(0).then([sst] {
+                return sst->mutate_repaired_at(0);
+            });
         } else {
             return make_ready_future<>();
         }
@@ -764,6 +764,30 @@ filter_sstable_for_reader_by_ck(std::vector<shared_sstable>&& sstables, column_f
     return std::move(sstables);
 }
 
+// Filter out sstables for reader which compaction would drop as fully expired
+// (see get_fully_expired_sstables()): all their data expired before gc_before,
+// and is older than the data of the other sstables containing the partition,
+// so it covers none of it. As it is purgeable, the read needn't see it.
+static std::vector<shared_sstable>
+filter_expired_sstable_for_reader(std::vector<shared_sstable>&& sstables, column_family& cf, const schema& schema) {
+    auto gc_before = gc_clock::now() - schema.gc_grace_seconds();
+    auto is_expired = [gc_before] (const shared_sstable& sst) {
+        return sst->get_max_local_deletion_time() < gc_before;
+    };
+    int64_t min_timestamp = std::numeric_limits<int64_t>::max();
+    for (auto& sst : sstables) {
+        if (!is_expired(sst)) {
+            min_timestamp = std::min(min_timestamp, sst->get_stats_metadata().min_timestamp);
+        }
+    }
+    auto skipped = std::partition(sstables.begin(), sstables.end(), [&] (const shared_sstable& sst) {
+        return !is_expired(sst) || sst->get_stats_metadata().max_timestamp >= min_timestamp;
+    });
+    cf.cf_stats()->expired_sstables_skipped_by_reads += std::distance(skipped, sstables.end());
+    sstables.erase(skipped, sstables.end());
+    return std::move(sstables);
+}
+
 std::vector<sstable_run>
 sstable_set_impl::select_sstable_runs(const std::vector<shared_sstable>& sstables) const {
     throw_with_backtrace<std::bad_function_call>();
@@ -789,14 +813,15 @@ sstable_set_impl::create_single_key_sstable_reader(
         return make_empty_flat_reader(schema, permit);
     }
     auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(
-        filter_sstable_for_reader_by_ck(std::move(selected_sstables), *cf, schema, slice)
+        filter_sstable_for_reader_by_ck(filter_expired_sstable_for_reader(std::move(selected_sstables), *cf, *schema), *cf, schema, slice)
         | boost::adaptors::transformed([&] (const shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pos, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->make_reader_v1(schema, permit, pr, slice, pc, trace_state, fwd);
         })
     );
 
-    // If filter_sstable_for_reader_by_ck filtered any sstable that contains the partition
+    // If filter_sstable_for_reader_by_ck or filter_expired_sstable_for_reader
+    // filtered any sstable that contains the partition
     // we want to emit partition_start/end if no rows were found,
     // to prevent https://github.com/scylladb/scylla/issues/3552.
     //
@@ -174,6 +174,9 @@ std::ostream& operator<<(std::ostream& os, const sstables::sstable_run& run);
 
 using offstrategy = bool_class<class offstrategy_tag>;
 
+// Whether to read only the sstables which weren't repaired, see sstable::is_repaired().
+using unrepaired_only = bool_class<class unrepaired_only_tag>;
+
 /// Return the amount of overlapping in a set of sstables. 0 is returned if set is disjoint.
 ///
 /// The 'sstables' parameter must be a set of sstables sorted by first key.
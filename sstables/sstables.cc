@@ -860,7 +860,7 @@ future<> sstable::read_toc() noexcept {
 
 }
 
-void sstable::generate_toc(compressor_ptr c, double filter_fp_chance) {
+void sstable::generate_toc(compressor_ptr c, double filter_fp_chance, bool compression_dictionary) {
     // Creating table of components.
     _recognized_components.insert(component_type::TOC);
     _recognized_components.insert(component_type::Statistics);
@@ -875,6 +875,9 @@ void sstable::generate_toc(compressor_ptr c, double filter_fp_chance) {
         _recognized_components.insert(component_type::CRC);
     } else {
         _recognized_components.insert(component_type::CompressionInfo);
+        if (compression_dictionary) {
+            _recognized_components.insert(component_type::CompressionDictionary);
+        }
     }
     _recognized_components.insert(component_type::Scylla);
 }
@@ -1094,7 +1097,9 @@ future<> sstable::read_compression(const io_priority_class& pc) {
         return make_ready_future<>();
     }
 
-    return read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    return read_simple<component_type::CompressionInfo>(_components->compression, pc).then([this, &pc] {
+        return read_compression_dictionary(pc);
+    });
 }
 
 void sstable::write_compression(const io_priority_class& pc) {
@@ -1103,6 +1108,41 @@ void sstable::write_compression(const io_priority_class& pc) {
     }
 
     write_simple<component_type::CompressionInfo>(_components->compression, pc);
+    write_compression_dictionary(pc);
+}
+
+// The CompressionDictionary component holds the dictionary as a
+// disk_string<uint32_t>. It is empty if the writer could not train one,
+// in which case the chunks are compressed without.
+future<> sstable::read_compression_dictionary(const io_priority_class& pc) {
+    if (!has_component(component_type::CompressionDictionary)) {
+        return make_ready_future<>();
+    }
+
+    auto content = make_lw_shared<disk_string<uint32_t>>();
+    return read_simple<component_type::CompressionDictionary>(*content, pc).then([this, content] {
+        if (content->value.empty()) {
+            return;
+        }
+        auto c = get_sstable_compressor(_components->compression);
+        if (!c || !c->supports_dictionary()) {
+            throw malformed_sstable_exception(format("compression dictionary found, but {} does not use dictionaries",
+                    sstring(to_sstring_view(bytes_view(_components->compression.name.value)))), filename(component_type::CompressionDictionary));
+        }
+        _components->compression.set_dictionary(c->make_dictionary(std::move(content->value)));
+    });
+}
+
+void sstable::write_compression_dictionary(const io_priority_class& pc) {
+    if (!has_component(component_type::CompressionDictionary)) {
+        return;
+    }
+
+    disk_string<uint32_t> content;
+    if (auto dictionary = _components->compression.dictionary()) {
+        content.value = bytes(dictionary->content());
+    }
+    write_simple<component_type::CompressionDictionary>(content, pc);
 }
 
 void sstable::validate_partitioner() {
@@ -1378,6 +1418,13 @@ future<> sstable::read_filter(const io_priority_class& pc) {
         utils::filter_format format = (_version >= sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
+        if (has_blocked_bloom_filter()) {
+            if (filter.hashes != utils::filter::blocked_bloom_filter::words_per_block
+                    || nr_bits % utils::filter::blocked_bloom_filter::block_bits) {
+                throw malformed_sstable_exception(fmt::format("Invalid blocked bloom filter: {} hashes, {} bits", filter.hashes, nr_bits), filename(component_type::Filter));
+            }
+            format = utils::filter_format::blocked_format;
+        }
         _components->filter = utils::filter::create_filter(filter.hashes, std::move(bs), format);
     });
 }
@@ -1387,7 +1434,7 @@ void sstable::write_filter(const io_priority_class& pc) {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
     auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
@@ -2413,6 +2460,33 @@ future<> sstable::mutate_sstable_level(uint32_t new_level) {
     });
 }
 
+future<> sstable::mutate_repaired_at(uint64_t repaired_at) {
+    if (!has_component(component_type::Statistics)) {
+        return make_ready_future<>();
+    }
+
+    auto entry = _components->statistics.contents.find(metadata_type::Stats);
+    if (entry == _components->statistics.contents.end()) {
+        return make_ready_future<>();
+    }
+
+    auto& p = entry->second;
+    if (!p) {
+        throw std::runtime_error("Statistics is malformed");
+    }
+    stats_metadata& s = *static_cast<stats_metadata *>(p.get());
+    if (s.repaired_at == repaired_at) {
+        return make_ready_future<>();
+    }
+
+    sstlog.debug("set repaired_at of {} from {} to {}", get_filename(), s.repaired_at, repaired_at);
+    s.repaired_at = repaired_at;
+    return seastar::async([this] {
+        // Same as mutate_sstable_level(), repair marking sstables isn't urgent.
+        rewrite_statistics(default_priority_class());
+    });
+}
+
 int sstable::compare_by_max_timestamp(const sstable& other) const {
     auto ts1 = get_stats_metadata().max_timestamp;
     auto ts2 = other.get_stats_metadata().max_timestamp;
@@ -3124,6 +3198,7 @@ std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp
     case ct::TemporaryTOC: out << "TemporaryTOC"; break;
     case ct::TemporaryStatistics: out << "TemporaryStatistics"; break;
     case ct::Scylla: out << "Scylla"; break;
+    case ct::CompressionDictionary: out << "CompressionDictionary"; break;
     case ct::Unknown: out << "Unknown"; break;
     }
     return out;
@@ -117,10 +117,17 @@ struct sstable_writer_config {
     mutation_fragment_stream_validation_level validation_level;
     std::optional<db::replay_position> replay_position;
     std::optional<int> sstable_level;
+    // Time the data written was repaired at, in milliseconds since the
+    // epoch, or 0 if it wasn't.
+    uint64_t repaired_at = 0;
     write_monitor* monitor = &default_write_monitor();
     utils::UUID run_identifier = utils::make_random_uuid();
     size_t summary_byte_cost;
     sstring origin;
+    bool blocked_bloom_filter = false;
+    // Amount of data to train a compression dictionary from, 0 to write
+    // without one. Only used by compressors which support dictionaries.
+    size_t compression_dictionary_sample_size = 0;
 
 private:
     explicit sstable_writer_config() {}
@@ -578,13 +585,16 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     future<> touch_temp_dir();
     future<> remove_temp_dir();
 
-    void generate_toc(compressor_ptr c, double filter_fp_chance);
+    void generate_toc(compressor_ptr c, double filter_fp_chance, bool compression_dictionary = false);
     void write_toc(const io_priority_class& pc);
     future<> seal_sstable();
 
     future<> read_compression(const io_priority_class& pc);
     void write_compression(const io_priority_class& pc);
 
+    future<> read_compression_dictionary(const io_priority_class& pc);
+    void write_compression_dictionary(const io_priority_class& pc);
+
     future<> read_scylla_metadata(const io_priority_class& pc) noexcept;
     void write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features, run_identifier identifier,
             std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
@@ -698,6 +708,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return has_scylla_component() && _components->scylla_metadata->has_feature(sstable_feature::ShadowableTombstones);
     }
 
+    bool has_blocked_bloom_filter() const {
+        return has_scylla_component() && _components->scylla_metadata->has_feature(sstable_feature::BlockedBloomFilter);
+    }
+
     sstable_enabled_features features() const {
         if (!has_scylla_component()) {
             return {};
@@ -815,6 +829,21 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     future<> mutate_sstable_level(uint32_t);
 
+    // Whether all the data of the sstable was repaired, see repaired_at().
+    bool is_repaired() const {
+        return repaired_at() != 0;
+    }
+
+    // The time the sstable was last repaired at, in milliseconds since the
+    // epoch, or 0 if it has data which wasn't repaired.
+    uint64_t repaired_at() const {
+        return get_stats_metadata().repaired_at;
+    }
+
+    // Sets the time the sstable was repaired at, and rewrites the
+    // statistics component to persist it.
+    future<> mutate_repaired_at(uint64_t repaired_at);
+
     const summary& get_summary() const {
         return _components->summary;
     }
@@ -61,6 +61,10 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    cfg.blocked_bloom_filter = _db_config.enable_blocked_bloom_filter() && _features.cluster_supports_blocked_bloom_filter();
+    if (_features.cluster_supports_sstable_compression_dictionaries()) {
+        cfg.compression_dictionary_sample_size = size_t(_db_config.sstable_compression_dictionary_sample_size_in_kb()) * 1024;
+    }
 
     cfg.origin = std::move(origin);
 
@@ -38,6 +38,9 @@ sstable_writer::sstable_writer(sstable& sst, const schema& s, uint64_t estimated
     if (cfg.sstable_level) {
         _impl->_collector.set_sstable_level(cfg.sstable_level.value());
     }
+    if (cfg.repaired_at) {
+        _impl->_collector.set_repaired_at(cfg.repaired_at);
+    }
     sst.get_stats().on_open_for_writing();
 }
 
@@ -26,6 +26,7 @@
 #include "database.hh"
 #include "sstables/sstables.hh"
 #include "gms/inet_address.hh"
+#include "gms/feature_service.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "message/messaging_service.hh"
@@ -131,7 +132,13 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
     auto& table = _db.local().find_column_family(table_id);
     auto s = table.schema();
     const auto cf_id = s->id();
-    const auto reason = streaming::stream_reason::repair;
+    // Receivers write the streamed fragments straight into sstables on the
+    // owning shards. With load_and_stream they also leave them out of the
+    // main sstable set until off-strategy compaction integrates them, rather
+    // than triggering regular compaction for each one. Older nodes only know
+    // about repair.
+    const auto reason = _db.local().features().cluster_supports_load_and_stream_offstrategy()
+            ? streaming::stream_reason::load_and_stream : streaming::stream_reason::repair;
     auto erm = _db.local().find_keyspace(ks_name).get_effective_replication_map();
 
     size_t nr_sst_total = sstables.size();
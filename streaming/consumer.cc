@@ -24,6 +24,7 @@
 #include "consumer.hh"
 #include "mutation_source_metadata.hh"
 #include "service/priority_manager.hh"
+#include "service/storage_proxy.hh"
 #include "db/view/view_update_generator.hh"
 #include "db/view/view_update_checks.hh"
 #include "sstables/sstables.hh"
@@ -73,13 +74,17 @@ std::function<future<> (flat_mutation_reader)> make_streaming_consumer(sstring o
                                              encoding_stats{}, pc).then([sst] {
                     return sst->open_data();
                 }).then([cf, sst, offstrategy, reason] {
-                    if (offstrategy && (reason == stream_reason::repair)) {
+                    if (offstrategy && (reason == stream_reason::repair || reason == stream_reason::load_and_stream)) {
                         sstables::sstlog.debug("Enabled automatic off-strategy trigger for table {}.{}",
                                 cf->schema()->ks_name(), cf->schema()->cf_name());
                         cf->enable_off_strategy_trigger();
                     }
                     return cf->add_sstable_and_update_cache(sst, offstrategy);
                 }).then([cf, s, sst, use_view_update_path, &vug]() mutable -> future<> {
+                    // The sstable holds partitions of this shard only.
+                    if (s->caching_options().coordinator_results()) {
+                        service::get_local_storage_proxy().get_result_cache().invalidate(s->id());
+                    }
                     if (!use_view_update_path) {
                         return make_ready_future<>();
                     }
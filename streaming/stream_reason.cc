@@ -33,6 +33,7 @@ std::ostream& operator<<(std::ostream& out, stream_reason r) {
 	case stream_reason::rebuild: out << "rebuild"; break;
 	case stream_reason::repair: out << "repair"; break;
 	case stream_reason::replace: out << "replace"; break;
+	case stream_reason::load_and_stream: out << "load_and_stream"; break;
     }
     return out;
 }
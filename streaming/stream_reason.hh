@@ -34,6 +34,7 @@ enum class stream_reason : uint8_t {
     rebuild,
     repair,
     replace,
+    load_and_stream,
 };
 
 std::ostream& operator<<(std::ostream& out, stream_reason r);
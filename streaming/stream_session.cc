@@ -74,6 +74,7 @@ static sstables::offstrategy is_offstrategy_supported(streaming::stream_reason r
     static const std::unordered_set<streaming::stream_reason> operations_supported = {
         streaming::stream_reason::bootstrap,
         streaming::stream_reason::replace,
+        streaming::stream_reason::load_and_stream,
     };
     return sstables::offstrategy(operations_supported.contains(reason));
 }
@@ -241,7 +241,7 @@ table::make_streaming_reader(schema_ptr s, reader_permit permit,
 }
 
 flat_mutation_reader table::make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
-        const query::partition_slice& slice, mutation_reader::forwarding fwd_mr) const {
+        const query::partition_slice& slice, mutation_reader::forwarding fwd_mr, sstables::unrepaired_only unrepaired) const {
     const auto& pc = service::get_local_streaming_priority();
     auto trace_state = tracing::trace_state_ptr();
     const auto fwd = streamed_mutation::forwarding::no;
@@ -251,7 +251,16 @@ flat_mutation_reader table::make_streaming_reader(schema_ptr schema, reader_perm
     for (auto&& mt : *_memtables) {
         readers.emplace_back(mt->make_flat_reader(schema, permit, range, slice, pc, trace_state, fwd, fwd_mr));
     }
-    readers.emplace_back(make_sstable_reader(schema, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+    auto sstables = _sstables;
+    if (unrepaired) {
+        sstables = make_lw_shared(_compaction_strategy.make_sstable_set(_schema));
+        _sstables->for_each_sstable([&sstables] (const sstables::shared_sstable& sst) mutable {
+            if (!sst->is_repaired()) {
+                sstables->insert(sst);
+            }
+        });
+    }
+    readers.emplace_back(make_sstable_reader(schema, permit, std::move(sstables), range, slice, pc, std::move(trace_state), fwd, fwd_mr));
     return make_combined_reader(std::move(schema), std::move(permit), std::move(readers), fwd, fwd_mr);
 }
 
@@ -760,6 +769,8 @@ void table::set_metrics() {
                     ms::make_histogram("cas_prepare_latency", ms::description("CAS prepare round latency histogram"), [this] {return to_metrics_histogram(_stats.estimated_cas_prepare);})(cf)(ks),
                     ms::make_histogram("cas_propose_latency", ms::description("CAS accept round latency histogram"), [this] {return to_metrics_histogram(_stats.estimated_cas_accept);})(cf)(ks),
                     ms::make_histogram("cas_commit_latency", ms::description("CAS learn round latency histogram"), [this] {return to_metrics_histogram(_stats.estimated_cas_learn);})(cf)(ks),
+                    ms::make_histogram("read_admission_wait_latency", ms::description("Histogram of the time data reads waited for admission"), [this] {return to_metrics_histogram(_stats.estimated_read_admission_wait);})(cf)(ks),
+                    ms::make_histogram("read_disk_wait_latency", ms::description("Histogram of the time data reads which asked for their latency breakdown waited for disk reads"), [this] {return to_metrics_histogram(_stats.estimated_read_disk_wait);})(cf)(ks),
                     ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks)
             });
         }
@@ -1143,6 +1154,18 @@ const sstables::sstable_set& table::get_sstable_set() const {
     return *_main_sstables;
 }
 
+std::optional<std::vector<int64_t>> table::sstable_generations_of(const dht::partition_range& range) const {
+    for (auto&& mt : *_memtables) {
+        if (!mt->empty(range)) {
+            return std::nullopt;
+        }
+    }
+    auto ssts = _sstables->select(range);
+    auto generations = boost::copy_range<std::vector<int64_t>>(ssts | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::generation)));
+    std::sort(generations.begin(), generations.end());
+    return generations;
+}
+
 lw_shared_ptr<const sstable_list> table::get_sstables() const {
     return _sstables->all();
 }
@@ -1885,6 +1908,94 @@ void table::drop_hit_rate(gms::inet_address addr) {
     _cluster_cache_hit_rates.erase(addr);
 }
 
+// Samples needed before the latency quantiles of a replica are trusted.
+static constexpr uint64_t min_replica_read_latency_samples = 100;
+
+// The least a failed read counts as taking towards the ranking of a replica,
+// so that a replica which fails fast isn't preferred.
+static constexpr std::chrono::microseconds failed_replica_read_penalty = 10ms;
+
+// Decays the latency histogram of a replica a little every second, so that
+// its quantiles follow the recent reads. The moving average needs no decay,
+// since it already weighs recent reads the most.
+static void maybe_decay(table::replica_read_latency& e) {
+    auto now = lowres_clock::now();
+    if (now - e.last_decayed > 1s) {
+        e.last_decayed = now;
+        e.histogram *= 0.9;
+    }
+}
+
+void table::replica_read_started(gms::inet_address addr) {
+    _replica_read_latencies[addr].outstanding++;
+}
+
+static table::replica_read_latency& replica_read_done(std::unordered_map<gms::inet_address, table::replica_read_latency>& latencies, gms::inet_address addr) {
+    auto& e = latencies[addr];
+    // The statistics may have been dropped since the read was sent.
+    if (e.outstanding) {
+        e.outstanding--;
+    }
+    return e;
+}
+
+void table::update_replica_read_average(replica_read_latency& e, std::chrono::microseconds latency) {
+    double us = latency.count();
+    if (e.average_us) {
+        _replica_read_average_sum -= *e.average_us;
+        e.average_us = *e.average_us + 0.1 * (us - *e.average_us);
+    } else {
+        ++_replica_read_average_count;
+        e.average_us = us;
+    }
+    _replica_read_average_sum += *e.average_us;
+}
+
+void table::replica_read_finished(gms::inet_address addr, utils::time_estimated_histogram::duration latency) {
+    auto& e = replica_read_done(_replica_read_latencies, addr);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+    e.histogram.add_micro(us.count());
+    update_replica_read_average(e, us);
+}
+
+void table::replica_read_failed(gms::inet_address addr, utils::time_estimated_histogram::duration elapsed) {
+    auto& e = replica_read_done(_replica_read_latencies, addr);
+    update_replica_read_average(e, std::max(std::chrono::duration_cast<std::chrono::microseconds>(elapsed), failed_replica_read_penalty));
+}
+
+double table::replica_read_score(gms::inet_address addr) {
+    auto mean = _replica_read_average_count ? _replica_read_average_sum / _replica_read_average_count : 0.0;
+    auto it = _replica_read_latencies.find(addr);
+    if (it == _replica_read_latencies.end()) {
+        return mean;
+    }
+    return it->second.average_us.value_or(mean) * (1 + it->second.outstanding);
+}
+
+std::optional<std::chrono::microseconds> table::get_replica_read_latency_quantile(gms::inet_address addr, double quantile) {
+    auto it = _replica_read_latencies.find(addr);
+    if (it == _replica_read_latencies.end()) {
+        return std::nullopt;
+    }
+    maybe_decay(it->second);
+    if (it->second.histogram.count() < min_replica_read_latency_samples) {
+        return std::nullopt;
+    }
+    return std::chrono::microseconds(it->second.histogram.quantile(quantile));
+}
+
+void table::drop_replica_read_latency(gms::inet_address addr) {
+    auto it = _replica_read_latencies.find(addr);
+    if (it == _replica_read_latencies.end()) {
+        return;
+    }
+    if (it->second.average_us) {
+        _replica_read_average_sum -= *it->second.average_us;
+        --_replica_read_average_count;
+    }
+    _replica_read_latencies.erase(it);
+}
+
 void
 table::check_valid_rp(const db::replay_position& rp) const {
     if (rp != db::replay_position() && rp < _lowest_allowed_rp) {
@@ -2043,16 +2154,29 @@ table::query(schema_ptr s,
 
     query_state qs(s, cmd, opts, partition_ranges, std::move(accounter));
 
+    // Only reads of data may leave the unselected cells out of rows.
+    std::optional<query::partition_slice> projected_slice;
+    if (opts.request == query::result_request::only_result) {
+        projected_slice.emplace(qs.cmd.slice);
+        projected_slice->options.set<query::partition_slice::option::project_regular_columns>();
+    }
+
     std::optional<query::data_querier> querier_opt;
     if (saved_querier) {
         querier_opt = std::move(*saved_querier);
     }
+    // The querier may have been saved by a digest read of the query, or the
+    // other way around.
+    if (querier_opt && querier_opt->slice().options.contains<query::partition_slice::option::project_regular_columns>() != bool(projected_slice)) {
+        co_await querier_opt->close();
+        querier_opt = {};
+    }
 
     while (!qs.done()) {
         auto&& range = *qs.current_partition_range++;
 
         if (!querier_opt) {
-            querier_opt = query::data_querier(as_mutation_source(), s, permit, range, qs.cmd.slice,
+            querier_opt = query::data_querier(as_mutation_source(), s, permit, range, projected_slice ? *projected_slice : qs.cmd.slice,
                     service::get_local_sstable_query_read_priority(), trace_state);
         }
         auto& q = *querier_opt;
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/random_utils.hh"
+#include "test/lib/log.hh"
+
+#include "utils/bloom_filter.hh"
+#include "utils/bloom_calculations.hh"
+
+using namespace seastar;
+
+static std::vector<bytes> make_keys(size_t n) {
+    std::vector<bytes> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(tests::random::get_bytes(16));
+    }
+    return keys;
+}
+
+// Returns the observed false positive rate over keys which were not added.
+static double check_filter(utils::i_filter& f, const std::vector<bytes>& keys) {
+    for (auto& k : keys) {
+        f.add(k);
+    }
+    for (auto& k : keys) {
+        BOOST_REQUIRE(f.is_present(k));
+        BOOST_REQUIRE(f.is_present(utils::make_hashed_key(k)));
+    }
+    size_t probes = 100000;
+    size_t positives = 0;
+    for (size_t i = 0; i < probes; ++i) {
+        // Longer than the added keys, so it can't be one of them.
+        positives += f.is_present(tests::random::get_bytes(17));
+    }
+    return double(positives) / probes;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_blocked_bloom_filter) {
+    auto keys = make_keys(100000);
+    for (double fp_chance : {0.1, 0.01, 0.001}) {
+        auto f = utils::i_filter::get_filter(keys.size(), fp_chance, utils::filter_format::blocked_format);
+        BOOST_REQUIRE(dynamic_cast<utils::filter::blocked_bloom_filter*>(f.get()));
+        auto rate = check_filter(*f, keys);
+        testlog.info("fp_chance {}: false positive rate {}, memory {}", fp_chance, rate, f->memory_size());
+        // Leave room for statistical noise.
+        BOOST_REQUIRE_LT(rate, fp_chance * 1.5);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_blocked_bloom_filter_round_trip) {
+    auto keys = make_keys(1000);
+    auto f = utils::i_filter::get_filter(keys.size(), 0.01, utils::filter_format::blocked_format);
+    for (auto& k : keys) {
+        f->add(k);
+    }
+    auto& bf = static_cast<utils::filter::bloom_filter&>(*f);
+    BOOST_REQUIRE_EQUAL(bf.bits().size() % utils::filter::blocked_bloom_filter::block_bits, 0);
+
+    // Rebuild the filter from its bits, like sstable::read_filter() does.
+    auto& storage = bf.bits().get_storage();
+    utils::chunked_vector<uint64_t> copy(storage.begin(), storage.end());
+    large_bitset bs(bf.bits().size(), std::move(copy));
+    auto f2 = utils::filter::create_filter(bf.num_hashes(), std::move(bs), utils::filter_format::blocked_format);
+    for (auto& k : keys) {
+        BOOST_REQUIRE(f2->is_present(k));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_blocked_bits_per_element) {
+    for (double fp_chance : {0.5, 0.1, 0.01, 0.001, 0.0001, 0.00001}) {
+        auto bits = utils::bloom_calculations::blocked_bits_per_element(fp_chance);
+        BOOST_REQUIRE_LE(utils::bloom_calculations::blocked_false_positive_rate(bits), fp_chance);
+        if (bits > 1) {
+            BOOST_REQUIRE_GT(utils::bloom_calculations::blocked_false_positive_rate(bits - 1), fp_chance);
+        }
+    }
+    BOOST_REQUIRE_THROW(utils::bloom_calculations::blocked_bits_per_element(1e-9), exceptions::unsupported_operation_exception);
+}
@@ -33,6 +33,13 @@ BOOST_AUTO_TEST_CASE(test_caching_options) {
         auto out_map = co.to_map();
         BOOST_REQUIRE(in_map == out_map);
     }
+    {
+        string_map in_map = { {"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"coordinator_results", "true"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.coordinator_results());
+        BOOST_REQUIRE(in_map == co.to_map());
+        BOOST_REQUIRE(!caching_options::from_map({ {"keys", "ALL"} }).coordinator_results());
+    }
     {
         sstring in_str = "{\"keys\":\"NONE\",\"rows_per_partition\":\"10\"}";
         caching_options co = caching_options::from_sstring(in_str);
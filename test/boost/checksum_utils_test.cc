@@ -89,3 +89,7 @@ BOOST_AUTO_TEST_CASE(test_libdeflate_matches_zlib) {
 BOOST_AUTO_TEST_CASE(test_default_matches_zlib) {
     test<zlib_crc32_checksummer, crc32_utils>();
 }
+
+BOOST_AUTO_TEST_CASE(test_default_adler32_matches_zlib) {
+    test<zlib_adler32_checksummer, adler32_utils>();
+}
@@ -50,6 +50,7 @@
 #include "log.hh"
 #include "service/priority_manager.hh"
 #include "test/lib/exception_utils.hh"
+#include "test/lib/random_utils.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/data_model.hh"
 #include "test/lib/sstable_utils.hh"
@@ -725,6 +726,65 @@ SEASTAR_TEST_CASE(test_commitlog_add_entries) {
     });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_compression) {
+    for (auto type : { commitlog::compression_type::lz4, commitlog::compression_type::zstd }) {
+        commitlog::config cfg;
+        cfg.compression = type;
+        co_await cl_test(cfg, [](commitlog& log) {
+            return seastar::async([&] {
+                // A compressible entry, one which is not, one too large to be
+                // compressed, and a multi-entry write.
+                std::vector<sstring> entries = { sstring(4096, 'a'), tests::random::get_sstring(64), sstring(256 * 1024, 'b') };
+                std::vector<replay_position> rps;
+                auto uuid = utils::UUID_gen::get_time_UUID();
+                for (auto& e : entries) {
+                    auto h = log.add_mutation(uuid, e.size(), db::commitlog::force_sync::no, [&e] (db::commitlog::output& dst) {
+                        dst.write(e.data(), e.size());
+                    }).get0();
+                    rps.push_back(h.release());
+                }
+
+                std::vector<commitlog_entry_writer> writers;
+                std::vector<frozen_mutation> mutations;
+                for (auto i = 0; i < 10; ++i) {
+                    random_mutation_generator gen(random_mutation_generator::generate_counters(false));
+                    mutations.emplace_back(gen(1).front());
+                    writers.emplace_back(gen.schema(), mutations.back(), commitlog_entry_writer::force_sync::no);
+                }
+                auto res = log.add_entries(writers, db::timeout_clock::now() + 60s).get0();
+                for (auto& h : res) {
+                    rps.push_back(h.release());
+                }
+
+                log.sync_all_segments().get();
+                size_t found = 0;
+                for (auto& seg : log.get_active_segment_names()) {
+                    commitlog::descriptor desc(seg, db::commitlog::descriptor::FILENAME_PREFIX);
+                    BOOST_REQUIRE_EQUAL(desc.ver, commitlog::descriptor::segment_version_3);
+                    db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                        auto i = std::find(rps.begin(), rps.end(), buf_rp.position);
+                        BOOST_REQUIRE(i != rps.end());
+                        auto n = size_t(std::distance(rps.begin(), i));
+                        if (n < entries.size()) {
+                            auto linearization_buffer = bytes_ostream();
+                            auto in = buf_rp.buffer.get_istream();
+                            BOOST_REQUIRE_EQUAL(to_sstring_view(in.read_bytes_view(buf_rp.buffer.size_bytes(), linearization_buffer)), entries[n]);
+                        } else {
+                            n -= entries.size();
+                            commitlog_entry_reader r(buf_rp.buffer);
+                            auto s = writers.at(n).schema();
+                            BOOST_REQUIRE_EQUAL(mutations.at(n).unfreeze(s), r.mutation().unfreeze(s));
+                        }
+                        ++found;
+                        return make_ready_future<>();
+                    }).get();
+                }
+                BOOST_REQUIRE_EQUAL(found, rps.size());
+            });
+        });
+    }
+}
+
 SEASTAR_TEST_CASE(test_commitlog_new_segment_odsync){
     commitlog::config cfg;
     cfg.commitlog_segment_size_in_mb = 1;
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "service/coordinator_result_cache.hh"
+#include "types.hh"
+#include "utils/UUID_gen.hh"
+
+using namespace seastar;
+using result_cache = service::coordinator_result_cache;
+
+static query::result make_result(size_t size) {
+    bytes_ostream buf;
+    buf.write(bytes(size, int8_t(1)));
+    return query::result(std::move(buf), query::short_read::no, uint64_t(1), std::optional<uint32_t>(1));
+}
+
+static result_cache::key make_key(utils::UUID table, int64_t token, sstring query = "q") {
+    return result_cache::key{table, dht::token(dht::token::kind::key, token), to_bytes(query)};
+}
+
+SEASTAR_THREAD_TEST_CASE(test_insert_and_find) {
+    result_cache cache(1 << 20, utils::updateable_value<uint32_t>(60000));
+    auto table = utils::UUID_gen::get_time_UUID();
+
+    auto k = make_key(table, 1);
+    BOOST_REQUIRE(!cache.find(k));
+    cache.insert(k, make_result(100), cache.generation(k));
+    auto r = cache.find(k);
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(r->buf().size(), 100);
+    BOOST_REQUIRE(!cache.find(make_key(table, 1, "other")));
+    BOOST_REQUIRE(!cache.find(make_key(table, 2)));
+    BOOST_REQUIRE_EQUAL(cache.get_stats().hits, 1);
+    BOOST_REQUIRE_EQUAL(cache.get_stats().misses, 3);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_invalidate_token) {
+    result_cache cache(1 << 20, utils::updateable_value<uint32_t>(60000));
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto other_table = utils::UUID_gen::get_time_UUID();
+
+    for (auto k : {make_key(table, 1), make_key(table, 1, "other"), make_key(table, 2), make_key(other_table, 1)}) {
+        cache.insert(k, make_result(100), cache.generation(k));
+    }
+    cache.invalidate(table, dht::token(dht::token::kind::key, 1));
+    BOOST_REQUIRE(!cache.find(make_key(table, 1)));
+    BOOST_REQUIRE(!cache.find(make_key(table, 1, "other")));
+    BOOST_REQUIRE(cache.find(make_key(table, 2)));
+    BOOST_REQUIRE(cache.find(make_key(other_table, 1)));
+
+    cache.invalidate(table);
+    BOOST_REQUIRE(!cache.find(make_key(table, 2)));
+    BOOST_REQUIRE(cache.find(make_key(other_table, 1)));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_clear) {
+    result_cache cache(1 << 20, utils::updateable_value<uint32_t>(60000));
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto other_table = utils::UUID_gen::get_time_UUID();
+
+    for (auto k : {make_key(table, 1), make_key(other_table, 2)}) {
+        cache.insert(k, make_result(100), cache.generation(k));
+    }
+    // A query running while the cache is cleared doesn't insert its result.
+    auto k = make_key(table, 3);
+    auto gen = cache.generation(k);
+    cache.clear();
+    cache.insert(k, make_result(100), gen);
+    BOOST_REQUIRE(!cache.find(make_key(table, 1)));
+    BOOST_REQUIRE(!cache.find(make_key(other_table, 2)));
+    BOOST_REQUIRE(!cache.find(k));
+
+    cache.insert(k, make_result(100), cache.generation(k));
+    BOOST_REQUIRE(cache.find(k));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_insert_racing_with_invalidation) {
+    result_cache cache(1 << 20, utils::updateable_value<uint32_t>(60000));
+    auto table = utils::UUID_gen::get_time_UUID();
+
+    // The partition is written to while the query runs.
+    auto k = make_key(table, 1);
+    auto gen = cache.generation(k);
+    cache.invalidate(table, k.token);
+    cache.insert(k, make_result(100), gen);
+    BOOST_REQUIRE(!cache.find(k));
+    BOOST_REQUIRE_EQUAL(cache.get_stats().dropped_inserts, 1);
+
+    // So is the whole table.
+    gen = cache.generation(k);
+    cache.invalidate(table);
+    cache.insert(k, make_result(100), gen);
+    BOOST_REQUIRE(!cache.find(k));
+    BOOST_REQUIRE_EQUAL(cache.get_stats().dropped_inserts, 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_eviction) {
+    const size_t max_memory = 64 * 1024;
+    result_cache cache(max_memory, utils::updateable_value<uint32_t>(60000));
+    auto table = utils::UUID_gen::get_time_UUID();
+
+    const int64_t n = 100;
+    for (int64_t i = 0; i < n; ++i) {
+        auto k = make_key(table, i);
+        cache.insert(k, make_result(1024), cache.generation(k));
+        // Keep the first one recently used.
+        BOOST_REQUIRE(cache.find(make_key(table, 0)));
+    }
+    BOOST_REQUIRE_GT(cache.get_stats().evictions, 0);
+    BOOST_REQUIRE(cache.find(make_key(table, 0)));
+    BOOST_REQUIRE(cache.find(make_key(table, n - 1)));
+    BOOST_REQUIRE(!cache.find(make_key(table, 1)));
+
+    // Results too big for the cache are not inserted.
+    auto k = make_key(table, n);
+    cache.insert(k, make_result(max_memory), cache.generation(k));
+    BOOST_REQUIRE(!cache.find(k));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_expiry) {
+    result_cache cache(1 << 20, utils::updateable_value<uint32_t>(0));
+    auto table = utils::UUID_gen::get_time_UUID();
+
+    auto k = make_key(table, 1);
+    cache.insert(k, make_result(100), cache.generation(k));
+    seastar::sleep(std::chrono::milliseconds(50)).get();
+    BOOST_REQUIRE(!cache.find(k));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_expiry_of_cells) {
+    result_cache cache(1 << 20, utils::updateable_value<uint32_t>(60000));
+    auto table = utils::UUID_gen::get_time_UUID();
+
+    // A result with a cell which already expired isn't inserted.
+    auto k = make_key(table, 1);
+    cache.insert(k, make_result(100), cache.generation(k), gc_clock::now() - std::chrono::seconds(1));
+    BOOST_REQUIRE(!cache.find(k));
+
+    // A result expires with its earliest expiring cell.
+    cache.insert(k, make_result(100), cache.generation(k), gc_clock::now() + std::chrono::seconds(1));
+    BOOST_REQUIRE(cache.find(k));
+    seastar::sleep(std::chrono::milliseconds(1100)).get();
+    BOOST_REQUIRE(!cache.find(k));
+}
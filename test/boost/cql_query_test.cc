@@ -3579,6 +3579,25 @@ SEASTAR_TEST_CASE(test_aggregate_and_simple_selection_together) {
     });
 }
 
+SEASTAR_TEST_CASE(test_parallelized_aggregation) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "create table t (p int, c int, v int, primary key(p, c))");
+        require_rows(e, "select count(*), count(v), sum(v), min(v), max(v) from t", {{L(0), L(0), I(0), std::nullopt, std::nullopt}});
+        for (int p = 0; p < 100; ++p) {
+            for (int c = 0; c < 3; ++c) {
+                cquery_nofail(e, format("insert into t (p, c, v) values ({}, {}, {})", p, c, p * 3 + c));
+            }
+        }
+        cquery_nofail(e, "insert into t (p, c) values (100, 0)");
+        require_rows(e, "select count(*) from t", {{L(301)}});
+        require_rows(e, "select count(v), sum(v), min(v), max(v) from t", {{L(300), I(44850), I(0), I(299)}});
+        require_rows(e, "select max(p), min(c) from t", {{I(100), I(0)}});
+        // Not parallelized, but must still work.
+        require_rows(e, "select count(*) from t where p = 1", {{L(3)}});
+        require_rows(e, "select count(*) from t limit 1", {{L(301)}});
+    });
+}
+
 SEASTAR_TEST_CASE(test_alter_type_on_compact_storage_with_no_regular_columns_does_not_crash) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "CREATE TYPE my_udf (first text);");
@@ -93,3 +93,29 @@ BOOST_AUTO_TEST_CASE(crc_process) {
         BOOST_REQUIRE_EQUAL(c1.get(), c2.get());
     }
 }
+
+// Test crc32::process() on the sizes handled by folding, which get their
+// initial crc from the input processed before.
+BOOST_AUTO_TEST_CASE(crc_process_folding) {
+    const size_t max_size = 3 * 1024;
+
+    uint64_t data64[max_size/8 + 2];
+    uint8_t *data = (reinterpret_cast<uint8_t*>(data64)) + 3;
+
+    for (size_t i = 0; i < max_size; ++i) {
+        data[i] = i * 7 + 1;
+    }
+
+    for (size_t size = 60; size + 5 <= max_size; ++size) {
+        utils::crc32 c1, c2;
+
+        for (size_t i = 0; i < size + 5; ++i) {
+            c1.process_le(data[i]);
+        }
+
+        c2.process(data, 5);
+        c2.process(data + 5, size);
+
+        BOOST_REQUIRE_EQUAL(c1.get(), c2.get());
+    }
+}
@@ -43,6 +43,7 @@
 #include "test/lib/tmpdir.hh"
 #include "db/data_listeners.hh"
 #include "multishard_mutation_query.hh"
+#include "repair/range_digest_cache.hh"
 
 using namespace std::chrono_literals;
 
@@ -784,3 +785,92 @@ SEASTAR_TEST_CASE(upgrade_sstables) {
         }).get();
     });
 }
+
+SEASTAR_TEST_CASE(test_replica_read_latency_ranking) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+
+        const gms::inet_address fast("10.0.0.1");
+        const gms::inet_address slow("10.0.0.2");
+        const gms::inet_address failing("10.0.0.3");
+        const gms::inet_address unknown("10.0.0.4");
+
+        // Nothing is known yet, so all the replicas rank the same.
+        BOOST_REQUIRE_EQUAL(cf.replica_read_score(fast), cf.replica_read_score(unknown));
+
+        for (int i = 0; i < 10; ++i) {
+            cf.replica_read_started(fast);
+            cf.replica_read_finished(fast, std::chrono::microseconds(100));
+            cf.replica_read_started(slow);
+            cf.replica_read_finished(slow, std::chrono::microseconds(3000));
+            // A replica which fails fast mustn't rank before the others.
+            cf.replica_read_started(failing);
+            cf.replica_read_failed(failing, std::chrono::microseconds(10));
+        }
+        BOOST_REQUIRE_LT(cf.replica_read_score(fast), cf.replica_read_score(slow));
+        BOOST_REQUIRE_LT(cf.replica_read_score(slow), cf.replica_read_score(failing));
+
+        // A replica with no completed read ranks at the mean of the others,
+        // rather than before all of them.
+        BOOST_REQUIRE_LT(cf.replica_read_score(fast), cf.replica_read_score(unknown));
+        BOOST_REQUIRE_LT(cf.replica_read_score(unknown), cf.replica_read_score(failing));
+        cf.replica_read_started(unknown);
+        BOOST_REQUIRE_LT(cf.replica_read_score(fast), cf.replica_read_score(unknown));
+
+        // Failures don't count towards the latency quantiles.
+        BOOST_REQUIRE(!cf.get_replica_read_latency_quantile(failing, 0.99));
+
+        // Reads in flight make a replica more expensive.
+        for (int i = 0; i < 100; ++i) {
+            cf.replica_read_started(fast);
+        }
+        BOOST_REQUIRE_LT(cf.replica_read_score(slow), cf.replica_read_score(fast));
+
+        // A dropped replica no longer counts towards the mean.
+        auto mean = cf.replica_read_score(gms::inet_address("10.0.0.5"));
+        cf.drop_replica_read_latency(failing);
+        BOOST_REQUIRE_LT(cf.replica_read_score(gms::inet_address("10.0.0.5")), mean);
+    });
+}
+
+SEASTAR_TEST_CASE(test_repair_range_digest_source_changes_with_the_data) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto& db = e.local_db();
+        auto& cf = db.find_column_family("ks", "cf");
+        auto s = cf.schema();
+        auto range = dht::token_range::make_open_ended_both_sides();
+
+        auto write = [&] (sstring k) {
+            mutation m(s, partition_key::from_single_value(*s, to_bytes(k)));
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", int32_t(42), api::new_timestamp());
+            db.apply(s, freeze(m), tracing::trace_state_ptr(), db::commitlog::force_sync::no, db::no_timeout).get();
+        };
+        auto source = [&] {
+            return repair_range_digest_cache::source_of(cf, s->version(), range);
+        };
+        repair_range_digest_cache cache(16);
+        const repair_range_digest_cache::key key{s->id(), range};
+        const repair_range_digest digest{1, repair_hash(42)};
+
+        write("key1");
+        cf.flush().get();
+        cache.insert(key, digest, source().value());
+        // Nothing changed since the digest was computed, so the range is skipped.
+        BOOST_REQUIRE(cache.find(key, source().value()) == digest);
+
+        // A write leaves the range in a memtable, so its digest can't be used.
+        write("key2");
+        BOOST_REQUIRE(!source());
+
+        // A flush adds an sstable.
+        cf.flush().get();
+        BOOST_REQUIRE(!cache.find(key, source().value()));
+
+        // A compaction replaces the sstables.
+        cache.insert(key, digest, source().value());
+        cf.compact_all_sstables().get();
+        BOOST_REQUIRE(!cache.find(key, source().value()));
+    });
+}
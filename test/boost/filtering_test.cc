@@ -1166,3 +1166,108 @@ SEASTAR_TEST_CASE(test_filtering) {
 
     });
 }
+
+// Comparisons of fixed-width columns are lowered into comparisons of native
+// integers, check they still behave like the comparisons of their types,
+// including for null and empty values.
+SEASTAR_TEST_CASE(test_filtering_on_fixed_width_types) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE fw (p int, c bigint, i int, t timestamp, u uuid, PRIMARY KEY (p, c)) WITH CLUSTERING ORDER BY (c DESC);").get();
+        e.execute_cql("INSERT INTO fw (p, c, i, t, u) VALUES (1, 10, 1, 1000, 00000000-0000-0000-0000-000000000001);").get();
+        e.execute_cql("INSERT INTO fw (p, c, i, t, u) VALUES (1, 20, 2, 2000, 00000000-0000-0000-0000-000000000002);").get();
+        e.execute_cql("INSERT INTO fw (p, c, t, u) VALUES (2, -5, 3000, 00000000-0000-0000-0000-000000000003);").get();
+        e.execute_cql("INSERT INTO fw (p, c, i, t, u) VALUES (3, 30, blobasint(0x), -1000, 10000000-0000-0000-0000-000000000002);").get();
+
+        auto ts = [] (int64_t ms) {
+            return timestamp_type->decompose(db_clock::time_point(std::chrono::milliseconds(ms)));
+        };
+
+        require_rows(e, "SELECT p, c FROM fw WHERE c < 15 ALLOW FILTERING;", {
+            { int32_type->decompose(1), long_type->decompose(int64_t(10)) },
+            { int32_type->decompose(2), long_type->decompose(int64_t(-5)) },
+        });
+        // Neither the null nor the empty value is greater than 1...
+        require_rows(e, "SELECT p, c, i FROM fw WHERE i >= 1 ALLOW FILTERING;", {
+            { int32_type->decompose(1), long_type->decompose(int64_t(10)), int32_type->decompose(1) },
+            { int32_type->decompose(1), long_type->decompose(int64_t(20)), int32_type->decompose(2) },
+        });
+        // ...but the empty value is smaller than 2.
+        require_rows(e, "SELECT p, c, i FROM fw WHERE i < 2 ALLOW FILTERING;", {
+            { int32_type->decompose(1), long_type->decompose(int64_t(10)), int32_type->decompose(1) },
+            { int32_type->decompose(3), long_type->decompose(int64_t(30)), bytes() },
+        });
+        require_rows(e, "SELECT p, c, t FROM fw WHERE t > 0 AND t <= 2000 ALLOW FILTERING;", {
+            { int32_type->decompose(1), long_type->decompose(int64_t(10)), ts(1000) },
+            { int32_type->decompose(1), long_type->decompose(int64_t(20)), ts(2000) },
+        });
+        require_rows(e, "SELECT p, c, t FROM fw WHERE t < 0 ALLOW FILTERING;", {
+            { int32_type->decompose(3), long_type->decompose(int64_t(30)), ts(-1000) },
+        });
+        require_rows(e, "SELECT p, c, u FROM fw WHERE u = 00000000-0000-0000-0000-000000000002 ALLOW FILTERING;", {
+            { int32_type->decompose(1), long_type->decompose(int64_t(20)), uuid_type->decompose(utils::UUID("00000000-0000-0000-0000-000000000002")) },
+        });
+
+        auto prepared_id = e.prepare("SELECT p, c, i FROM fw WHERE c > ? AND i = ? ALLOW FILTERING;").get0();
+        auto msg = e.execute_prepared(prepared_id, {
+                cql3::raw_value::make_value(long_type->decompose(int64_t(0))),
+                cql3::raw_value::make_value(int32_type->decompose(2))}).get0();
+        assert_that(msg).is_rows().with_rows_ignore_order({
+            { int32_type->decompose(1), long_type->decompose(int64_t(20)), int32_type->decompose(2) },
+        });
+        msg = e.execute_prepared(prepared_id, {
+                cql3::raw_value::make_value(long_type->decompose(int64_t(15))),
+                cql3::raw_value::make_value(int32_type->decompose(1))}).get0();
+        assert_that(msg).is_rows().with_size(0);
+    });
+}
+
+SEASTAR_TEST_CASE(test_filtering_with_row_filters) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE rf (p int, c int, s int static, v int, w text, PRIMARY KEY (p, c));").get();
+        for (int p = 0; p < 2; ++p) {
+            e.execute_cql(format("INSERT INTO rf (p, s) VALUES ({}, {});", p, 100 + p)).get();
+            for (int c = 0; c < 20; ++c) {
+                e.execute_cql(format("INSERT INTO rf (p, c, v, w) VALUES ({}, {}, {}, 'x{}');", p, c, c % 10, c)).get();
+            }
+        }
+        e.execute_cql("INSERT INTO rf (p, c, w) VALUES (0, 20, 'null');").get();
+        // The newer cell is the one filtered on, not the one it shadows.
+        e.db().invoke_on_all([] (database& db) {
+            return db.flush_all_memtables();
+        }).get();
+        e.execute_cql("UPDATE rf SET v = 3 WHERE p = 1 AND c = 0;").get();
+        e.execute_cql("DELETE v FROM rf WHERE p = 1 AND c = 3;").get();
+
+        require_rows(e, "SELECT p, c, s, v FROM rf WHERE v = 3 ALLOW FILTERING;", {
+            { int32_type->decompose(0), int32_type->decompose(3), int32_type->decompose(100), int32_type->decompose(3) },
+            { int32_type->decompose(0), int32_type->decompose(13), int32_type->decompose(100), int32_type->decompose(3) },
+            { int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(101), int32_type->decompose(3) },
+            { int32_type->decompose(1), int32_type->decompose(13), int32_type->decompose(101), int32_type->decompose(3) },
+        });
+        require_rows(e, "SELECT c, w FROM rf WHERE p = 0 AND v > 7 AND w >= 'x1' ALLOW FILTERING;", {
+            { int32_type->decompose(8), utf8_type->decompose("x8") },
+            { int32_type->decompose(9), utf8_type->decompose("x9") },
+            { int32_type->decompose(18), utf8_type->decompose("x18") },
+            { int32_type->decompose(19), utf8_type->decompose("x19") },
+        });
+        auto msg = e.execute_cql("SELECT count(*) FROM rf WHERE v < 2 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({{ long_type->decompose(int64_t(7)) }});
+
+        // Rows not satisfying the filters still count towards the page size.
+        std::vector<std::vector<bytes_opt>> rows;
+        lw_shared_ptr<service::pager::paging_state> paging_state;
+        do {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                    cql3::query_options::specific_options{3, paging_state, {}, api::new_timestamp()});
+            msg = e.execute_cql("SELECT c FROM rf WHERE p = 0 AND v = 5 ALLOW FILTERING;", std::move(qo)).get0();
+            auto rs = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+            for (auto& row : rs->rs().result_set().rows()) {
+                rows.push_back(row);
+            }
+            paging_state = extract_paging_state(msg);
+        } while (paging_state);
+        BOOST_REQUIRE_EQUAL(rows.size(), 2);
+        BOOST_REQUIRE(rows[0][0] == int32_type->decompose(5));
+        BOOST_REQUIRE(rows[1][0] == int32_type->decompose(15));
+    });
+}
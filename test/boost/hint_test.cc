@@ -23,6 +23,14 @@
 #include <seastar/testing/test_case.hh>
 
 #include "db/hints/sync_point.hh"
+#include "db/hints/manager.hh"
+#include "frozen_mutation.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/cql_test_env.hh"
+#include "service/storage_proxy.hh"
+#include "db/config.hh"
+
+using sender = db::hints::manager::end_point_hints_manager::sender;
 
 SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
     const unsigned encoded_shard_count = 2;
@@ -77,3 +85,106 @@ SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
 
     return make_ready_future<>();
 }
+
+SEASTAR_TEST_CASE(test_hint_batch_merges_hints_to_the_same_partition) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto pk1 = ss.make_pkey(1);
+    auto pk2 = ss.make_pkey(2);
+
+    mutation m1(s, pk1);
+    ss.add_row(m1, ss.make_ckey(1), "v1");
+    mutation m2(s, pk2);
+    ss.add_row(m2, ss.make_ckey(1), "v2");
+    mutation m3(s, pk1);
+    ss.add_row(m3, ss.make_ckey(2), "v3");
+
+    sender::hint_batch batch;
+    for (auto& m : {m1, m2, m3}) {
+        batch.add_direct(frozen_mutation_and_schema{freeze(m), s});
+    }
+    auto fms = batch.release_direct();
+    BOOST_REQUIRE_EQUAL(fms.size(), 2);
+
+    auto merged = m1;
+    merged.apply(m3);
+    BOOST_REQUIRE_EQUAL(fms[0].unfreeze(s), merged);
+    BOOST_REQUIRE_EQUAL(fms[1].unfreeze(s), m2);
+    BOOST_REQUIRE(batch.direct.empty());
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_hint_batch_failure_resumes_from_its_first_hint) {
+    std::unordered_map<table_schema_version, column_mapping> column_mappings;
+    sender::send_one_file_ctx ctx(column_mappings);
+    auto rp = [] (uint32_t pos) {
+        return db::replay_position(this_shard_id(), 1, pos);
+    };
+    const std::vector<db::replay_position> batch1 = {rp(10), rp(20), rp(30)};
+    const std::vector<db::replay_position> batch2 = {rp(40), rp(50)};
+    const std::vector<db::replay_position> batch3 = {rp(60), rp(70)};
+
+    // Batches are sent in the background, so several are in flight at once.
+    ctx.mark_hints_as_in_progress(batch1);
+    ctx.mark_hints_as_in_progress(batch2);
+    ctx.mark_hints_as_in_progress(batch3);
+    BOOST_REQUIRE_EQUAL(ctx.get_replayed_bound(), rp(10));
+
+    // The bound is inclusive of the last hint sent.
+    ctx.on_hints_send_success(batch1);
+    BOOST_REQUIRE_EQUAL(ctx.get_replayed_bound(), rp(31));
+
+    // The last batch completing first doesn't move the bound past the
+    // batch still in flight before it.
+    ctx.on_hints_send_success(batch3);
+    BOOST_REQUIRE_EQUAL(ctx.get_replayed_bound(), rp(40));
+
+    // All the hints of a failed batch are replayed again, from its first one.
+    ctx.on_hints_send_failure(batch2);
+    BOOST_REQUIRE(ctx.segment_replay_failed);
+    BOOST_REQUIRE(ctx.in_progress_rps.empty());
+    BOOST_REQUIRE_EQUAL(*ctx.first_failed_rp, rp(40));
+    BOOST_REQUIRE_EQUAL(ctx.get_replayed_bound(), rp(40));
+
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_hints_log_per_destination_picks_one_shard_per_end_point) {
+    auto cfg = make_shared<db::config>();
+    cfg->hints_log_per_destination(true);
+
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& proxy = service::get_storage_proxy();
+        for (auto ep : {gms::inet_address("127.0.0.2"), gms::inet_address("127.0.0.3"), gms::inet_address("127.0.0.4")}) {
+            const auto owner = proxy.local().get_hints_manager().owner_shard_for(ep);
+            BOOST_REQUIRE_LT(owner, smp::count);
+            proxy.invoke_on_all([ep, owner] (service::storage_proxy& p) {
+                BOOST_REQUIRE_EQUAL(p.get_hints_manager().owner_shard_for(ep), owner);
+            }).get();
+        }
+    }, cql_test_config(cfg));
+}
+
+SEASTAR_TEST_CASE(test_hints_node_disk_usage_is_gathered_once_for_all_shards) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& proxy = service::get_storage_proxy();
+        proxy.invoke_on_all([] (service::storage_proxy& p) {
+            p.get_hints_manager().set_disk_usage((this_shard_id() + 1) * 1024);
+        }).get();
+
+        // The other shards only see the figure once shard 0 has handed it over.
+        proxy.invoke_on_all([] (service::storage_proxy& p) {
+            BOOST_REQUIRE_EQUAL(p.get_hints_manager().node_disk_usage().used, 0);
+        }).get();
+
+        proxy.invoke_on(0, [] (service::storage_proxy& p) {
+            return p.get_hints_manager().update_node_disk_usage();
+        }).get();
+
+        const size_t expected = smp::count * (smp::count + 1) / 2 * 1024;
+        proxy.invoke_on_all([expected] (service::storage_proxy& p) {
+            BOOST_REQUIRE_EQUAL(p.get_hints_manager().node_disk_usage().used, expected);
+        }).get();
+    });
+}
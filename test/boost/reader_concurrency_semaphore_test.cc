@@ -917,3 +917,103 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_used_blocked) {
         }
     }
 }
+
+static schema_ptr make_keyspace_schema(sstring ks_name) {
+    return schema_builder(ks_name, "cf")
+            .with_column("pk", utf8_type, column_kind::partition_key)
+            .with_column("v", utf8_type)
+            .build();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_fair_queuing) {
+    const auto s1 = make_keyspace_schema("ks1");
+    const auto s2 = make_keyspace_schema("ks2");
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, 64 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+    semaphore.set_fair_queuing(utils::updateable_value<bool>(true));
+
+    reader_permit_opt permit = semaphore.obtain_permit(s1.get(), get_name(), 1024, db::no_timeout).get();
+
+    auto ks1_fut1 = semaphore.obtain_permit(s1.get(), get_name(), 1024, db::no_timeout);
+    auto ks1_fut2 = semaphore.obtain_permit(s1.get(), get_name(), 1024, db::no_timeout);
+    auto ks2_fut = semaphore.obtain_permit(s2.get(), get_name(), 1024, db::no_timeout);
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 3);
+
+    // ks1 consumed memory already, so ks2 goes first, even though it came last.
+    permit = {};
+    permit = ks2_fut.get();
+    BOOST_REQUIRE(!ks1_fut1.available());
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 2);
+
+    permit = {};
+    permit = ks1_fut1.get();
+    permit = {};
+    permit = ks1_fut2.get();
+    permit = {};
+
+    std::map<sstring, uint64_t> admitted;
+    semaphore.for_each_wait_class([&] (std::string_view name, const reader_concurrency_semaphore::wait_class_stats& stats) {
+        admitted[sstring(name)] = stats.reads_admitted;
+    });
+    BOOST_REQUIRE_EQUAL(admitted["ks1"], 2);
+    BOOST_REQUIRE_EQUAL(admitted["ks2"], 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_fair_queuing_eviction) {
+    const auto s1 = make_keyspace_schema("ks1");
+    const auto s2 = make_keyspace_schema("ks2");
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 2, 64 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+    semaphore.set_fair_queuing(utils::updateable_value<bool>(true));
+
+    auto permit1 = semaphore.obtain_permit(s1.get(), get_name(), 1024, db::no_timeout).get();
+    // Make ks1 the class which consumed the most.
+    {
+        auto units = permit1.consume_memory(16 * 1024);
+    }
+    auto permit2 = semaphore.obtain_permit(s2.get(), get_name(), 1024, db::no_timeout).get();
+
+    auto handle2 = semaphore.register_inactive_read(make_empty_flat_reader(s2, permit2));
+    auto handle1 = semaphore.register_inactive_read(make_empty_flat_reader(s1, permit1));
+    BOOST_REQUIRE(handle1);
+    BOOST_REQUIRE(handle2);
+
+    // The read of ks1 is evicted, even though the one of ks2 is older.
+    auto permit3 = semaphore.obtain_permit(s2.get(), get_name(), 1024, db::no_timeout).get();
+    BOOST_REQUIRE(!handle1);
+    BOOST_REQUIRE(handle2);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().permit_based_evictions, 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_fair_queuing_prunes_wait_classes) {
+    const auto s1 = make_keyspace_schema("ks1");
+    const auto s2 = make_keyspace_schema("ks2");
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, 64 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+    semaphore.set_fair_queuing(utils::updateable_value<bool>(true));
+
+    auto wait_classes = [&] {
+        std::set<sstring> names;
+        semaphore.for_each_wait_class([&] (std::string_view name, const reader_concurrency_semaphore::wait_class_stats&) {
+            names.emplace(name);
+        });
+        return names;
+    };
+
+    reader_permit_opt permit = semaphore.obtain_permit(s1.get(), get_name(), 1024, db::no_timeout).get();
+    auto ks2_fut = semaphore.obtain_permit(s2.get(), get_name(), 1024, db::no_timeout);
+    BOOST_REQUIRE((wait_classes() == std::set<sstring>{"*", "ks1", "ks2"}));
+
+    // ks1 has no waiters and no admitted permits left.
+    permit = {};
+    permit = ks2_fut.get();
+    BOOST_REQUIRE((wait_classes() == std::set<sstring>{"*", "ks2"}));
+
+    permit = {};
+    BOOST_REQUIRE((wait_classes() == std::set<sstring>{"*"}));
+
+    // With fair queuing off, the reads go to the default class.
+    semaphore.set_fair_queuing(utils::updateable_value<bool>(false));
+    permit = semaphore.obtain_permit(s1.get(), get_name(), 1024, db::no_timeout).get();
+    BOOST_REQUIRE((wait_classes() == std::set<sstring>{"*"}));
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include "repair/hash_sketch.hh"
+
+static repair_hash_set random_hashes(std::mt19937_64& gen, size_t n) {
+    repair_hash_set hashes;
+    while (hashes.size() < n) {
+        hashes.insert(repair_hash(gen()));
+    }
+    return hashes;
+}
+
+static std::optional<repair_hash_sketch::difference> decode(const repair_hash_set& local, const repair_hash_set& remote, size_t cells) {
+    repair_hash_sketch local_sketch(cells);
+    local_sketch.add(local);
+    repair_hash_sketch remote_sketch(cells);
+    remote_sketch.add(remote);
+    // As the remote sketch is received from the peer
+    local_sketch.subtract(repair_hash_sketch(std::move(remote_sketch).release()));
+    return std::move(local_sketch).decode();
+}
+
+BOOST_AUTO_TEST_CASE(test_identical_sets_have_no_difference) {
+    std::mt19937_64 gen(1);
+    auto hashes = random_hashes(gen, 10000);
+    auto diff = decode(hashes, hashes, repair_hash_sketch::cells_for(0));
+    BOOST_REQUIRE(diff);
+    BOOST_REQUIRE(diff->local.empty());
+    BOOST_REQUIRE(diff->remote.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_difference) {
+    std::mt19937_64 gen(2);
+    for (size_t d : {1, 10, 100, 1000}) {
+        auto common = random_hashes(gen, 10000);
+        auto local_only = random_hashes(gen, d / 2);
+        auto remote_only = random_hashes(gen, d - d / 2);
+        auto local = common;
+        local.insert(local_only.begin(), local_only.end());
+        auto remote = common;
+        remote.insert(remote_only.begin(), remote_only.end());
+
+        auto cells = repair_hash_sketch::cells_for(d);
+        BOOST_REQUIRE_EQUAL(cells % repair_hash_sketch::hash_count, 0);
+        auto diff = decode(local, remote, cells);
+        BOOST_REQUIRE(diff);
+        BOOST_REQUIRE(diff->local == local_only);
+        BOOST_REQUIRE(diff->remote == remote_only);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_fails_on_too_large_difference) {
+    std::mt19937_64 gen(3);
+    auto local = random_hashes(gen, 1000);
+    auto remote = random_hashes(gen, 1000);
+    BOOST_REQUIRE(!decode(local, remote, repair_hash_sketch::cells_for(10)));
+}
+
+BOOST_AUTO_TEST_CASE(test_subtract_sketches_of_different_sizes) {
+    repair_hash_sketch a(repair_hash_sketch::cells_for(10));
+    repair_hash_sketch b(repair_hash_sketch::cells_for(100));
+    BOOST_REQUIRE_THROW(a.subtract(b), std::invalid_argument);
+    BOOST_REQUIRE_THROW(repair_hash_sketch(std::vector<repair_hash_sketch::cell>(4)), std::invalid_argument);
+}
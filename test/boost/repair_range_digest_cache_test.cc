@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include "repair/range_digest_cache.hh"
+#include "utils/UUID_gen.hh"
+
+static dht::token_range range(int64_t start, int64_t end) {
+    return dht::token_range::make({dht::token::from_int64(start), false}, {dht::token::from_int64(end), true});
+}
+
+static repair_range_digest_cache::fingerprint fingerprint(std::vector<int64_t> sstable_generations) {
+    return repair_range_digest_cache::fingerprint_of(sstable_generations);
+}
+
+static repair_range_digest digest(uint64_t seed, uint64_t hash) {
+    return repair_range_digest{seed, repair_hash(hash)};
+}
+
+BOOST_AUTO_TEST_CASE(test_find_with_same_source) {
+    repair_range_digest_cache cache(16);
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto version = utils::UUID_gen::get_time_UUID();
+    repair_range_digest_cache::source src{version, fingerprint({1, 2, 3})};
+    cache.insert({table, range(0, 100)}, digest(7, 42), src);
+
+    BOOST_REQUIRE(cache.find({table, range(0, 100)}, src) == digest(7, 42));
+    BOOST_REQUIRE(!cache.find({table, range(0, 101)}, src));
+    BOOST_REQUIRE(!cache.find({utils::UUID_gen::get_time_UUID(), range(0, 100)}, src));
+
+    cache.insert({table, range(0, 100)}, digest(8, 43), src);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1);
+    BOOST_REQUIRE(cache.find({table, range(0, 100)}, src) == digest(8, 43));
+}
+
+BOOST_AUTO_TEST_CASE(test_changed_source_drops_digest) {
+    repair_range_digest_cache cache(16);
+    auto table = utils::UUID_gen::get_time_UUID();
+    auto version = utils::UUID_gen::get_time_UUID();
+    cache.insert({table, range(0, 100)}, digest(7, 42), {version, fingerprint({1, 2, 3})});
+
+    // An sstable was flushed or compacted
+    BOOST_REQUIRE(!cache.find({table, range(0, 100)}, {version, fingerprint({1, 2, 4})}));
+    BOOST_REQUIRE_EQUAL(cache.size(), 0);
+
+    cache.insert({table, range(0, 100)}, digest(7, 42), {version, fingerprint({1, 2, 3})});
+    // The schema was altered
+    BOOST_REQUIRE(!cache.find({table, range(0, 100)}, {utils::UUID_gen::get_time_UUID(), fingerprint({1, 2, 3})}));
+    BOOST_REQUIRE_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_least_recently_used_are_evicted) {
+    repair_range_digest_cache cache(2);
+    auto table = utils::UUID_gen::get_time_UUID();
+    repair_range_digest_cache::source src{utils::UUID_gen::get_time_UUID(), fingerprint({1})};
+    cache.insert({table, range(0, 100)}, digest(1, 1), src);
+    cache.insert({table, range(100, 200)}, digest(1, 2), src);
+    BOOST_REQUIRE(cache.find({table, range(0, 100)}, src));
+    cache.insert({table, range(200, 300)}, digest(1, 3), src);
+
+    BOOST_REQUIRE_EQUAL(cache.size(), 2);
+    BOOST_REQUIRE(cache.find({table, range(0, 100)}, src));
+    BOOST_REQUIRE(!cache.find({table, range(100, 200)}, src));
+    BOOST_REQUIRE(cache.find({table, range(200, 300)}, src));
+}
@@ -21,6 +21,8 @@
 
 
 #include <boost/test/unit_test.hpp>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/util/backtrace.hh>
 #include <seastar/util/alloc_failure_injector.hh>
@@ -35,6 +37,7 @@
 #include "schema_builder.hh"
 #include "test/lib/simple_schema.hh"
 #include "row_cache.hh"
+#include "db/saved_caches.hh"
 #include <seastar/core/thread.hh>
 #include "memtable.hh"
 #include "partition_slice_builder.hh"
@@ -42,6 +45,7 @@
 #include "test/lib/log.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include "test/lib/random_utils.hh"
+#include "test/lib/tmpdir.hh"
 
 #include <boost/range/algorithm/min_element.hpp>
 
@@ -553,6 +557,108 @@ static std::vector<mutation> make_ring(schema_ptr s, int n_mutations) {
     return mutations;
 }
 
+SEASTAR_TEST_CASE(test_walk_recent_partitions) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        {
+            lru_marker marker;
+            auto batch = tracker.walk_recent_partitions(marker, 10);
+            BOOST_REQUIRE(batch.keys.empty());
+            BOOST_REQUIRE(batch.done);
+        }
+
+        std::vector<mutation> mutations = make_ring(s, 5);
+        for (auto&& m : mutations) {
+            cache.populate(m);
+        }
+        cache.touch(mutations[2].decorated_key());
+
+        // Walk the LRU in batches, as saved_caches_manager does.
+        std::vector<dht::decorated_key> keys;
+        lru_marker marker;
+        while (true) {
+            auto batch = tracker.walk_recent_partitions(marker, 1);
+            BOOST_REQUIRE_LE(batch.keys.size(), 1);
+            for (auto& [ks, dk] : batch.keys) {
+                BOOST_REQUIRE_EQUAL(ks->id(), s->id());
+                if (keys.empty() || !keys.back().equal(*s, dk)) {
+                    keys.push_back(dk);
+                }
+            }
+            if (batch.done) {
+                break;
+            }
+        }
+
+        BOOST_REQUIRE_EQUAL(keys.size(), mutations.size());
+        // The most recently used partition comes first.
+        BOOST_REQUIRE(keys.front().equal(*s, mutations[2].decorated_key()));
+        BOOST_REQUIRE(keys.back().equal(*s, mutations[0].decorated_key()));
+
+        cache.evict();
+        lru_marker after_eviction;
+        BOOST_REQUIRE(tracker.walk_recent_partitions(after_eviction, 10).keys.empty());
+    });
+}
+
+SEASTAR_TEST_CASE(test_saved_caches_serialization) {
+    return seastar::async([] {
+        db::saved_caches_manager::saved_keys keys;
+        keys[utils::make_random_uuid()] = {to_bytes("key1"), to_bytes("key2")};
+        keys[utils::make_random_uuid()] = {};
+        keys[utils::make_random_uuid()] = {bytes(1024, int8_t(0x5a))};
+        // Spans several write buffers.
+        auto& many = keys[utils::make_random_uuid()];
+        for (int i = 0; i < 10000; ++i) {
+            many.push_back(bytes(100, int8_t(i)));
+        }
+
+        tmpdir dir;
+        auto path = (dir.path() / "row_cache-0.db").native();
+        auto write_file = [&] (const db::saved_caches_manager::saved_keys& keys) {
+            auto f = open_file_dma(path, open_flags::wo | open_flags::create | open_flags::truncate).get0();
+            auto out = make_file_output_stream(std::move(f)).get0();
+            db::saved_caches_manager::write(out, keys).get();
+            out.flush().get();
+            out.close().get();
+        };
+        auto read_file = [&] {
+            auto in = make_file_input_stream(open_file_dma(path, open_flags::ro).get0());
+            auto close_in = deferred_close(in);
+            return db::saved_caches_manager::read(in).get0();
+        };
+        auto rewrite_file = [&] (noncopyable_function<void(bytes&)> corrupt) {
+            auto in = make_file_input_stream(open_file_dma(path, open_flags::ro).get0());
+            auto close_in = deferred_close(in);
+            bytes data;
+            for (auto buf = in.read().get0(); !buf.empty(); buf = in.read().get0()) {
+                data.append(reinterpret_cast<const int8_t*>(buf.get()), buf.size());
+            }
+            corrupt(data);
+            auto f = open_file_dma(path, open_flags::wo | open_flags::create | open_flags::truncate).get0();
+            auto out = make_file_output_stream(std::move(f)).get0();
+            out.write(reinterpret_cast<const char*>(data.data()), data.size()).get();
+            out.flush().get();
+            out.close().get();
+        };
+
+        write_file(keys);
+        BOOST_REQUIRE(read_file() == keys);
+
+        rewrite_file([] (bytes& data) { data[data.size() / 2] ^= 1; });
+        BOOST_REQUIRE_THROW(read_file(), std::runtime_error);
+
+        write_file(keys);
+        rewrite_file([] (bytes& data) { data.resize(data.size() - 1); });
+        BOOST_REQUIRE_THROW(read_file(), std::runtime_error);
+    });
+}
+
 SEASTAR_TEST_CASE(test_query_of_incomplete_range_goes_to_underlying) {
     return seastar::async([] {
         auto s = make_schema();
@@ -3777,3 +3883,66 @@ SEASTAR_TEST_CASE(test_scans_erase_dummies) {
         BOOST_REQUIRE_EQUAL(tracker.get_stats().rows, 2);
     });
 }
+
+SEASTAR_TEST_CASE(test_reads_of_some_columns_leave_out_the_other_cells) {
+    return seastar::async([] {
+        auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v1", int32_type)
+            .with_column("v2", int32_type)
+            .build();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto& v2 = *s->get_column_definition("v2");
+
+        auto pk = dht::decorate_key(*s, partition_key::from_single_value(*s, int32_type->decompose(0)));
+        auto ck = [&] (int32_t v) {
+            return clustering_key::from_single_value(*s, int32_type->decompose(v));
+        };
+        mutation m(s, pk);
+        auto add_row = [&] (int32_t k, row_marker marker, api::timestamp_type v2_ts) {
+            m.partition().clustered_row(*s, ck(k)).apply(marker);
+            m.set_clustered_cell(ck(k), "v1", data_value(k), 10);
+            m.set_clustered_cell(ck(k), "v2", data_value(k), v2_ts);
+        };
+        // v2 can be left out: the marker keeps the row live as long as v2 does.
+        add_row(0, row_marker(10), 10);
+        // v2 can't: it may be what makes the row live.
+        add_row(1, row_marker(), 10);
+        add_row(2, row_marker(10), 20);
+        add_row(3, row_marker(10, gc_clock::duration(3600), gc_clock::now() + gc_clock::duration(3600)), 10);
+
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(m);
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+        cache.populate(m);
+
+        auto read = [&] (const query::partition_slice& slice) {
+            auto rd = cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(pk), slice);
+            auto close_rd = deferred_close(rd);
+            auto got = read_mutation_from_flat_mutation_reader(rd).get0();
+            BOOST_REQUIRE(got);
+            return std::move(*got);
+        };
+
+        assert_that(read(s->full_slice())).is_equal_to(m);
+
+        // Mutation and digest reads get whole rows.
+        auto slice = partition_slice_builder(*s).with_regular_column(to_bytes("v1")).build();
+        assert_that(read(slice)).is_equal_to(m);
+
+        slice.options.set<query::partition_slice::option::project_regular_columns>();
+        auto got = read(slice);
+        auto has_v2 = [&] (int32_t k) {
+            auto r = got.partition().find_row(*s, ck(k));
+            BOOST_REQUIRE(r);
+            return r->find_cell(v2.id) != nullptr;
+        };
+        BOOST_REQUIRE(!has_v2(0));
+        BOOST_REQUIRE(has_v2(1));
+        BOOST_REQUIRE(has_v2(2));
+        BOOST_REQUIRE(has_v2(3));
+        BOOST_REQUIRE_EQUAL(got.partition().live_row_count(*s), 4);
+    });
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/variant_utils.hh>
+
+#include "test/lib/random_utils.hh"
+
+#include "message/rpc_compression.hh"
+
+using namespace netw;
+
+SEASTAR_THREAD_TEST_CASE(test_rpc_compression_config_parsing) {
+    auto cfg = rpc_compression_config::parse("zstd");
+    for (auto group : { rpc_connection_group::gossip, rpc_connection_group::streaming, rpc_connection_group::statement }) {
+        BOOST_REQUIRE(cfg.algorithm(group) == rpc_compression_algorithm::zstd);
+    }
+
+    cfg = rpc_compression_config::parse("lz4, streaming:zstd,gossip : none");
+    BOOST_REQUIRE(cfg.algorithm(rpc_connection_group::gossip) == rpc_compression_algorithm::none);
+    BOOST_REQUIRE(cfg.algorithm(rpc_connection_group::streaming) == rpc_compression_algorithm::zstd);
+    BOOST_REQUIRE(cfg.algorithm(rpc_connection_group::statement) == rpc_compression_algorithm::lz4);
+
+    BOOST_REQUIRE_THROW(rpc_compression_config::parse("gzip"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(rpc_compression_config::parse("reads:zstd"), std::invalid_argument);
+}
+
+static sstring linearize(const rpc::rcv_buf& buf) {
+    return std::visit(make_visitor(
+        [] (const temporary_buffer<char>& b) {
+            return sstring(b.get(), b.size());
+        },
+        [] (const std::vector<temporary_buffer<char>>& bufs) {
+            sstring ret;
+            for (auto& b : bufs) {
+                ret += sstring(b.get(), b.size());
+            }
+            return ret;
+        }), buf.bufs);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_zstd_rpc_compressor) {
+    rpc_compression_config cfg;
+    cfg.algorithms.fill(rpc_compression_algorithm::zstd);
+    rpc_compression compression(cfg);
+
+    auto* client_factory = compression.client_factory(rpc_connection_group::statement);
+    BOOST_REQUIRE(client_factory);
+    // zstd first, with lz4 as a fall back
+    BOOST_REQUIRE_EQUAL(client_factory->supported(), "ZSTD,LZ4_FRAGMENTED,LZ4");
+
+    auto client = client_factory->negotiate("ZSTD", false);
+    auto server = compression.server_factory().negotiate(client_factory->supported(), true);
+    BOOST_REQUIRE(client && server);
+    BOOST_REQUIRE_EQUAL(server->name(), "ZSTD");
+
+    // Fragment the input the way rpc does for large messages, and check the
+    // compressor copes with both fragmented input and chunked output.
+    auto fragment = [] (const sstring& msg, size_t fragment_size) {
+        std::vector<temporary_buffer<char>> bufs;
+        for (size_t pos = 0; pos < msg.size(); pos += fragment_size) {
+            auto size = std::min(fragment_size, msg.size() - pos);
+            bufs.emplace_back(msg.data() + pos, size);
+        }
+        return rpc::snd_buf(std::move(bufs), msg.size());
+    };
+
+    for (auto msg : { sstring(), sstring(100000, 'x'), tests::random::get_sstring(100000) }) {
+        for (auto fragment_size : { size_t(0), size_t(1000), size_t(40000) }) {
+            constexpr size_t head_space = 8;
+            auto src = fragment_size ? fragment(msg, fragment_size) : rpc::snd_buf(temporary_buffer<char>(msg.data(), msg.size()));
+            auto compressed = client->compress(head_space, std::move(src));
+            auto size = compressed.size - head_space;
+            auto bufs = std::visit(make_visitor(
+                [] (temporary_buffer<char>& b) {
+                    std::vector<temporary_buffer<char>> ret;
+                    ret.push_back(std::move(b));
+                    return ret;
+                },
+                [] (std::vector<temporary_buffer<char>>& bufs) {
+                    return std::move(bufs);
+                }), compressed.bufs);
+            bufs.front().trim_front(head_space);
+            auto decompressed = server->decompress(rpc::rcv_buf(std::move(bufs), size));
+            BOOST_REQUIRE_EQUAL(linearize(decompressed), msg);
+        }
+    }
+}
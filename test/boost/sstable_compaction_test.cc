@@ -71,6 +71,7 @@
 #include <unistd.h>
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/algorithm/cxx11/none_of.hpp>
 #include <boost/algorithm/cxx11/is_sorted.hpp>
 #include <boost/icl/interval_map.hpp>
 #include "test/lib/test_services.hh"
@@ -1846,6 +1847,76 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_run_selection_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        column_family_for_tests cf(env.manager());
+        auto close_cf = deferred_stop(cf);
+        std::map<sstring, sstring> options;
+        options.emplace("sstable_size_in_mb", "1");
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+        auto key_and_token_pair = token_generation_for_current_shard(2);
+        auto min_key = key_and_token_pair[0].first;
+        auto max_key = key_and_token_pair[1].first;
+
+        unsigned gen = 1;
+        auto make_run = [&] (unsigned fragments, bool all_candidates, std::vector<shared_sstable>& candidates) {
+            auto run_id = utils::make_random_uuid();
+            for (unsigned i = 0; i < fragments; i++) {
+                auto sst = env.make_sstable(cf.schema(), "", gen++, la, big);
+                sstables::test(sst).set_values(min_key, max_key, stats_metadata{});
+                sstables::test(sst).set_data_file_size(1024*1024);
+                sstables::test(sst).set_run_identifier(run_id);
+                column_family_test(cf).add_sstable(sst);
+                if (all_candidates || i == 0) {
+                    candidates.push_back(std::move(sst));
+                }
+            }
+        };
+
+        // 4 runs of 2 fragments each, plus one run only partially available for compaction.
+        std::vector<shared_sstable> candidates;
+        for (auto i = 0; i < cf->schema()->min_compaction_threshold(); i++) {
+            make_run(2, true, candidates);
+        }
+        make_run(2, false, candidates);
+
+        auto table_s = make_table_state_for_test(cf, env);
+        auto desc = cs.get_sstables_for_compaction(*table_s, candidates);
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), size_t(cf->schema()->min_compaction_threshold() * 2));
+        BOOST_REQUIRE(boost::algorithm::none_of(desc.sstables, [&] (const shared_sstable& sst) {
+            return sst == candidates.back();
+        }));
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, uint64_t(1024*1024));
+
+        desc = cs.get_major_compaction_job(*table_s, candidates);
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, uint64_t(1024*1024));
+    });
+}
+
+SEASTAR_TEST_CASE(incremental_compaction_strategy_backlog_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        column_family_for_tests cf(env.manager());
+        auto close_cf = deferred_stop(cf);
+
+        auto backlog_of = [&] (bool same_run) {
+            auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, {});
+            auto run_id = utils::make_random_uuid();
+            for (auto gen = 1; gen <= 4; gen++) {
+                auto sst = env.make_sstable(cf.schema(), "", gen, la, big);
+                sstables::test(sst).set_data_file_size(1024*1024);
+                sstables::test(sst).set_run_identifier(same_run ? run_id : utils::make_random_uuid());
+                cs.get_backlog_tracker().add_sstable(sst);
+            }
+            return cs.get_backlog_tracker().backlog();
+        };
+
+        // A single run has nothing left to compact, while 4 runs of the same size do.
+        // Allow for rounding errors, the backlog is measured in bytes.
+        BOOST_REQUIRE_LT(backlog_of(true), 1);
+        BOOST_REQUIRE_GT(backlog_of(false), 1024*1024);
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto tmp = tmpdir();
@@ -4192,6 +4263,198 @@ SEASTAR_TEST_CASE(test_twcs_single_key_reader_filtering) {
     });
 }
 
+SEASTAR_TEST_CASE(test_single_key_reader_skips_expired_sstables) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "single_key_reader_skips_expired_sstables")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .set_gc_grace_seconds(0)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)]() {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::md, big);
+        };
+
+        auto pkey = partition_key::from_single_value(*s, int32_type->decompose(0));
+        auto ckey = [&] (int32_t ck) {
+            return clustering_key::from_single_value(*s, int32_type->decompose(ck));
+        };
+        auto make_row = [&] (int32_t ck, api::timestamp_type ts) {
+            mutation m(s, pkey);
+            m.set_clustered_cell(ckey(ck), to_bytes("v"), int32_t(0), ts);
+            return m;
+        };
+        auto make_expired_delete = [&] (int32_t ck, api::timestamp_type ts) {
+            mutation m(s, pkey);
+            m.partition().apply_delete(*s, ckey(ck), tombstone(ts, gc_clock::now() - std::chrono::hours(1)));
+            return m;
+        };
+
+        // Older than all the other data of the partition, so skipped.
+        auto sst1 = make_sstable_containing(sst_gen, {make_expired_delete(0, 1)});
+        auto sst2 = make_sstable_containing(sst_gen, {make_row(1, 2)});
+        // Covers the row of sst2, so read.
+        auto sst3 = make_sstable_containing(sst_gen, {make_expired_delete(1, 3)});
+        auto dkey = sst1->get_first_decorated_key();
+
+        auto cm = make_lw_shared<compaction_manager>();
+        column_family::config cfg = column_family_test_config(env.manager(), env.semaphore());
+        ::cf_stats cf_stats{0};
+        cfg.cf_stats = &cf_stats;
+        cfg.datadir = tmp.path().string();
+        auto tracker = make_lw_shared<cache_tracker>();
+        cell_locker_stats cl_stats;
+        column_family cf(s, cfg, column_family::no_commitlog(), *cm, cl_stats, *tracker);
+        cf.mark_ready_for_writes();
+        cf.start();
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto set = cs.make_sstable_set(s);
+        set.insert(std::move(sst1));
+        set.insert(std::move(sst2));
+        set.insert(std::move(sst3));
+
+        reader_permit permit = env.make_reader_permit();
+        utils::estimated_histogram eh;
+        auto pr = dht::partition_range::make_singular(dkey);
+        auto reader = set.create_single_key_sstable_reader(
+                &cf, s, permit, eh, pr, s->full_slice(), default_priority_class(),
+                tracing::trace_state_ptr(), ::streamed_mutation::forwarding::no,
+                ::mutation_reader::forwarding::no);
+        auto close_reader = deferred_close(reader);
+
+        auto m = read_mutation_from_flat_mutation_reader(reader).get0();
+        BOOST_REQUIRE(m);
+        BOOST_REQUIRE_EQUAL(cf_stats.expired_sstables_skipped_by_reads, 1);
+        BOOST_REQUIRE_EQUAL(m->partition().live_row_count(*s), 0);
+        BOOST_REQUIRE(!m->partition().find_row(*s, ckey(0)));
+        BOOST_REQUIRE(m->partition().find_row(*s, ckey(1)));
+    });
+}
+
+SEASTAR_TEST_CASE(test_repaired_sstables_stay_repaired) {
+    BOOST_REQUIRE(smp::count == 1);
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "repaired_sstables_stay_repaired")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+        auto make_insert = [&] (int32_t pk) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("v"), int32_t(pk), api::new_timestamp());
+            return m;
+        };
+
+        auto mut1 = make_insert(1);
+        auto mut2 = make_insert(2);
+        auto mut3 = make_insert(3);
+        auto sst1 = make_sstable_containing(sst_gen, {mut1});
+        auto sst2 = make_sstable_containing(sst_gen, {mut2});
+        auto sst3 = make_sstable_containing(sst_gen, {mut3});
+        BOOST_REQUIRE(!sst1->is_repaired());
+
+        sst1->mutate_repaired_at(2000).get();
+        sst2->mutate_repaired_at(1000).get();
+        auto reloaded = env.reusable_sst(s, tmp.path().string(), sst1->generation(), sst1->get_version()).get0();
+        BOOST_REQUIRE_EQUAL(reloaded->repaired_at(), 2000);
+
+        column_family_for_tests cf(env.manager(), s);
+        auto stop_cf = deferred_stop(cf);
+        for (auto& sst : {sst1, sst2, sst3}) {
+            column_family_test(cf).add_sstable(sst);
+        }
+
+        // Incremental repairs only read the unrepaired sstables.
+        {
+            auto reader = cf->make_streaming_reader(s, env.make_reader_permit(), query::full_partition_range, s->full_slice(),
+                    mutation_reader::forwarding::no, sstables::unrepaired_only::yes);
+            assert_that(std::move(reader))
+                    .produces(mut3)
+                    .produces_end_of_stream();
+        }
+
+        auto compact = [&] (std::vector<shared_sstable> to_compact) {
+            auto new_sstables = compact_sstables(sstables::compaction_descriptor(std::move(to_compact), cf->get_sstable_set(), default_priority_class()), *cf, sst_gen).get0().new_sstables;
+            BOOST_REQUIRE_EQUAL(new_sstables.size(), 1);
+            return new_sstables[0];
+        };
+        // The output of a compaction is repaired since the oldest repair of its input...
+        auto repaired = compact({sst1, sst2});
+        BOOST_REQUIRE_EQUAL(repaired->repaired_at(), 1000);
+        // ...unless some of it wasn't repaired.
+        BOOST_REQUIRE(!compact({repaired, sst3})->is_repaired());
+    });
+}
+
+SEASTAR_TEST_CASE(test_repaired_and_unrepaired_sstables_are_compacted_apart) {
+    BOOST_REQUIRE(smp::count == 1);
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "repaired_and_unrepaired_sstables_are_compacted_apart")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->enable();
+        auto stop_cm = defer([cm] { cm->stop().get(); });
+
+        column_family::config cfg = column_family_test_config(env.manager(), env.semaphore());
+        cfg.datadir = tmp.path().string();
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        auto cl_stats = make_lw_shared<cell_locker_stats>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, *cl_stats, *tracker);
+        cf->start();
+        cf->mark_ready_for_writes();
+        auto stop_cf = deferred_stop(*cf);
+
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+        auto make_insert = [&] (int32_t pk) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("v"), int32_t(pk), api::new_timestamp());
+            return m;
+        };
+        std::vector<shared_sstable> ssts;
+        for (int32_t pk = 0; pk < 4; ++pk) {
+            auto sst = make_sstable_containing(sst_gen, {make_insert(pk)});
+            // Every other sstable is repaired.
+            if (pk % 2) {
+                sst->mutate_repaired_at(1000 * pk).get();
+            }
+            column_family_test(cf).add_sstable(sst);
+            column_family_test::update_sstables_known_generation(*cf, sst->generation());
+            ssts.push_back(std::move(sst));
+        }
+
+        // Regular compaction picks its descriptor from either group, never from both.
+        auto groups = compaction_manager_test(*cm).split_by_repair_state(*cf, ssts);
+        BOOST_REQUIRE_EQUAL(groups.size(), 2);
+        BOOST_REQUIRE_EQUAL(groups[0].size(), 2);
+        BOOST_REQUIRE(boost::algorithm::none_of(groups[0], std::mem_fn(&sstable::is_repaired)));
+        BOOST_REQUIRE_EQUAL(groups[1].size(), 2);
+        BOOST_REQUIRE(boost::algorithm::all_of(groups[1], std::mem_fn(&sstable::is_repaired)));
+
+        // Major compaction compacts each group on its own.
+        cf->compact_all_sstables().get();
+        auto compacted = boost::copy_range<std::vector<shared_sstable>>(*cf->get_sstables());
+        BOOST_REQUIRE_EQUAL(compacted.size(), 2);
+        auto repaired = boost::copy_range<std::vector<shared_sstable>>(compacted | boost::adaptors::filtered(std::mem_fn(&sstable::is_repaired)));
+        BOOST_REQUIRE_EQUAL(repaired.size(), 1);
+        BOOST_REQUIRE_EQUAL(repaired.front()->repaired_at(), 1000);
+    });
+}
+
 SEASTAR_TEST_CASE(max_ongoing_compaction_test) {
     return test_env::do_with_async([] (test_env& env) {
         BOOST_REQUIRE(smp::count == 1);
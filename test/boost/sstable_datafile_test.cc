@@ -2716,6 +2716,80 @@ SEASTAR_TEST_CASE(sstable_run_identifier_correctness) {
     });
 }
 
+SEASTAR_TEST_CASE(test_blocked_bloom_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "blocked_bloom_filter_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        std::vector<mutation> muts;
+        for (int i = 0; i < 1000; i++) {
+            mutation mut(s, partition_key::from_exploded(*s, {to_bytes(format("key{}", i))}));
+            mut.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(i)), 0);
+            muts.push_back(std::move(mut));
+        }
+        std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+
+        auto tmp = tmpdir();
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.blocked_bloom_filter = true;
+        auto sst = make_sstable_easy(env, tmp.path(), make_flat_mutation_reader_from_mutations(s, env.make_reader_permit(), muts), cfg, 1,
+                sstables::get_highest_sstable_version(), muts.size());
+
+        // make_sstable_easy() loads the sstable back, so the filter was read from disk.
+        BOOST_REQUIRE(sst->has_blocked_bloom_filter());
+        for (auto& m : muts) {
+            BOOST_REQUIRE(sst->filter_has_key(*s, m.decorated_key()));
+        }
+        assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit()))
+            .produces(muts)
+            .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_zstd_compression_dictionary) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "compression_dictionary_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", utf8_type)
+                .set_compressor_params(compression_parameters(std::map<sstring, sstring>{
+                    {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+                    {"chunk_length_in_kb", "4"},
+                }))
+                .build();
+
+        std::vector<mutation> muts;
+        for (int i = 0; i < 5000; i++) {
+            mutation mut(s, partition_key::from_exploded(*s, {to_bytes(format("key{}", i))}));
+            auto value = format("{{\"id\": {}, \"name\": \"user{}\", \"email\": \"user{}@example.com\", \"active\": {}}}", i, i, i, i % 2 == 0);
+            mut.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(value), 0);
+            muts.push_back(std::move(mut));
+        }
+        std::sort(muts.begin(), muts.end(), mutation_decorated_key_less_comparator());
+
+        auto tmp = tmpdir();
+        auto write = [&] (int64_t generation, size_t dictionary_sample_size) {
+            sstable_writer_config cfg = env.manager().configure_writer();
+            cfg.compression_dictionary_sample_size = dictionary_sample_size;
+            return make_sstable_easy(env, tmp.path(), make_flat_mutation_reader_from_mutations(s, env.make_reader_permit(), muts), cfg, generation,
+                    sstables::get_highest_sstable_version(), muts.size());
+        };
+        auto plain = write(1, 0);
+        auto sst = write(2, 128 * 1024);
+
+        // make_sstable_easy() loads the sstable back, so the dictionary was read from disk.
+        BOOST_REQUIRE(!plain->has_component(component_type::CompressionDictionary));
+        BOOST_REQUIRE(sst->has_component(component_type::CompressionDictionary));
+        BOOST_REQUIRE(sst->get_compression().dictionary());
+        testlog.info("Data.db size without dictionary: {}, with: {}", plain->ondisk_data_size(), sst->ondisk_data_size());
+        BOOST_REQUIRE_LT(sst->ondisk_data_size(), plain->ondisk_data_size());
+
+        assert_that(sst->as_mutation_source().make_reader(s, env.make_reader_permit()))
+            .produces(muts)
+            .produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(test_reads_cassandra_static_compact) {
     return test_env::do_with_async([] (test_env& env) {
         // CREATE COLUMNFAMILY cf (key varchar PRIMARY KEY, c2 text, c1 text) WITH COMPACT STORAGE ;
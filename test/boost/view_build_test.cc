@@ -176,6 +176,37 @@ SEASTAR_TEST_CASE(test_builder_with_multiple_partitions_of_batch_size_rows) {
     });
 }
 
+SEASTAR_TEST_CASE(test_builder_with_concurrent_batches) {
+    cql_test_config cfg;
+    cfg.db_config->view_building_concurrency(16);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        for (auto i = 0; i < 1024; ++i) {
+            e.execute_cql(format("insert into cf (p, c, v) values ({:d}, {:d}, {:d})", i, i % 3, i % 7)).get();
+        }
+
+        auto f1 = e.local_view_builder().wait_until_built("ks", "vcf1");
+        auto f2 = e.local_view_builder().wait_until_built("ks", "vcf2");
+        e.execute_cql("create materialized view vcf1 as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+        e.execute_cql("create materialized view vcf2 as select * from cf "
+                      "where p is not null and c is not null "
+                      "primary key (c, p)").get();
+
+        f1.get();
+        f2.get();
+        auto built = db::system_keyspace::load_built_views().get0();
+        BOOST_REQUIRE_EQUAL(built.size(), 2);
+
+        auto msg = e.execute_cql("select count(*) from vcf1").get0();
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(1024L)}}});
+        msg = e.execute_cql("select count(*) from vcf2").get0();
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(1024L)}}});
+    }, std::move(cfg));
+}
+
 SEASTAR_TEST_CASE(test_builder_view_added_during_ongoing_build) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
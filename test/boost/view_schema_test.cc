@@ -34,6 +34,9 @@
 #include "test/lib/cql_assertions.hh"
 #include "exceptions/unrecognized_entity_exception.hh"
 #include "db/config.hh"
+#include "service/storage_proxy.hh"
+#include "frozen_mutation.hh"
+#include "utils/fb_utilities.hh"
 #include "types/set.hh"
 #include "types/list.hh"
 #include "types/map.hh"
@@ -3174,3 +3177,58 @@ SEASTAR_TEST_CASE(test_mv_allow_some_column_drops) {
         BOOST_REQUIRE_THROW(e.execute_cql("alter table cf2 drop d").get(), exceptions::invalid_request_exception);
     });
 }
+
+// View updates to a paired replica are merged by view partition and sent in
+// batches when view_update_batch_window_in_ms is set. No messaging service
+// listens in cql_test_env, so each batch message fails and its updates are
+// sent again one at a time to the local replica, which applies them.
+SEASTAR_TEST_CASE(test_view_update_batches) {
+    cql_test_config test_cfg;
+    test_cfg.db_config->view_update_batch_window_in_ms(10);
+    auto db_cfg = test_cfg.db_config;
+    return do_with_cql_env_thread([db_cfg] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v text, primary key (p, c))").get();
+        e.execute_cql("create materialized view mv as select * from cf where p is not null and c is not null primary key (c, p)").get();
+        auto s = e.local_db().find_schema("ks", "mv");
+        auto make_update = [s] (int c, int p, sstring v) {
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(c)));
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(p)), "v", data_value(v), api::new_timestamp());
+            return frozen_mutation_and_schema{freeze(m), s};
+        };
+        auto& proxy = service::get_local_storage_proxy();
+        auto target = utils::fb_utilities::get_broadcast_address();
+        auto send = [&] (int c, int p, sstring v) {
+            return proxy.send_view_update_to_endpoint(make_update(c, p, std::move(v)), target, nullptr, service::allow_hints::no);
+        };
+
+        // The two updates to view partition 1 are merged.
+        auto stats = proxy.get_view_update_batch_stats();
+        std::vector<future<>> updates;
+        updates.push_back(send(1, 1, "a"));
+        updates.push_back(send(1, 2, "b"));
+        updates.push_back(send(2, 1, "c"));
+        when_all_succeed(updates.begin(), updates.end()).discard_result().get();
+        BOOST_REQUIRE_EQUAL(proxy.get_view_update_batch_stats().batches, stats.batches + 1);
+        BOOST_REQUIRE_EQUAL(proxy.get_view_update_batch_stats().updates, stats.updates + 3);
+        BOOST_REQUIRE_EQUAL(proxy.get_view_update_batch_stats().mutations, stats.mutations + 2);
+        assert_that(e.execute_cql("select c, p, v from mv").get0()).is_rows().with_rows_ignore_order({
+            {int32_type->decompose(1), int32_type->decompose(1), utf8_type->decompose("a")},
+            {int32_type->decompose(1), int32_type->decompose(2), utf8_type->decompose("b")},
+            {int32_type->decompose(2), int32_type->decompose(1), utf8_type->decompose("c")},
+        });
+
+        // A batch reaching view_update_batch_size_in_kb is sent without
+        // waiting for the window to end.
+        db_cfg->view_update_batch_window_in_ms(3600 * 1000);
+        db_cfg->view_update_batch_size_in_kb(1);
+        stats = proxy.get_view_update_batch_stats();
+        updates.clear();
+        updates.push_back(send(3, 1, "d"));
+        updates.push_back(send(3, 2, sstring(2048, 'e')));
+        when_all_succeed(updates.begin(), updates.end()).discard_result().get();
+        BOOST_REQUIRE_EQUAL(proxy.get_view_update_batch_stats().batches, stats.batches + 1);
+        BOOST_REQUIRE_EQUAL(proxy.get_view_update_batch_stats().updates, stats.updates + 2);
+        BOOST_REQUIRE_EQUAL(proxy.get_view_update_batch_stats().mutations, stats.mutations + 1);
+        assert_that(e.execute_cql("select c, p, v from mv where c = 3").get0()).is_rows().with_size(2);
+    }, test_cfg);
+}
@@ -221,3 +221,8 @@ void compaction_manager_test::deregister_compaction(const sstables::compaction_d
         testlog.debug("compaction_manager_test: deregister_compaction uuid={}: task not found", c.compaction_uuid);
     }
 }
+
+std::vector<std::vector<sstables::shared_sstable>>
+compaction_manager_test::split_by_repair_state(const column_family& cf, std::vector<sstables::shared_sstable> candidates) const {
+    return _cm.split_by_repair_state(cf, std::move(candidates));
+}
@@ -360,6 +360,8 @@ class compaction_manager_test {
     sstables::compaction_data& register_compaction(utils::UUID output_run_id = {}, column_family* cf = nullptr);
 
     void deregister_compaction(const sstables::compaction_data& c);
+
+    std::vector<std::vector<sstables::shared_sstable>> split_by_repair_state(const column_family& cf, std::vector<sstables::shared_sstable> candidates) const;
 };
 
 future<compaction_result> compact_sstables(sstables::compaction_descriptor descriptor, column_family& cf,
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ *
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/bloom_filter.hh"
+#include "utils/bloom_calculations.hh"
+#include "test/lib/random_utils.hh"
+
+#include "seastar/include/seastar/testing/perf_tests.hh"
+
+// Compares lookups in the classic and the split block bloom filters sized
+// for the same false positive chance. The filters are large enough not to
+// fit in the CPU caches, as with many sstables on a node.
+struct bloom_filter_test {
+    static constexpr int64_t nr_keys = 4 * 1024 * 1024;
+    static constexpr double fp_chance = 0.01;
+    static constexpr size_t nr_lookups = 1024;
+
+    utils::filter_ptr murmur3_filter;
+    utils::filter_ptr blocked_filter;
+    std::vector<utils::hashed_key> present_keys;
+    std::vector<utils::hashed_key> absent_keys;
+
+    bloom_filter_test() {
+        auto spec = utils::bloom_calculations::compute_bloom_spec(utils::bloom_calculations::max_buckets_per_element(nr_keys), fp_chance);
+        murmur3_filter = utils::filter::create_filter(spec.K, nr_keys, spec.buckets_per_element, utils::filter_format::m_format);
+        blocked_filter = utils::filter::create_filter(utils::filter::blocked_bloom_filter::words_per_block, nr_keys,
+                utils::bloom_calculations::blocked_bits_per_element(fp_chance), utils::filter_format::blocked_format);
+        for (int64_t i = 0; i < nr_keys; ++i) {
+            auto key = tests::random::get_bytes(16);
+            murmur3_filter->add(key);
+            blocked_filter->add(key);
+            if (present_keys.size() < nr_lookups) {
+                present_keys.push_back(utils::make_hashed_key(key));
+            }
+        }
+        for (size_t i = 0; i < nr_lookups; ++i) {
+            absent_keys.push_back(utils::make_hashed_key(tests::random::get_bytes(17)));
+        }
+    }
+
+    size_t next = 0;
+
+    void lookup(utils::i_filter& f, const std::vector<utils::hashed_key>& keys) {
+        perf_tests::do_not_optimize(f.is_present(keys[next++ % keys.size()]));
+    }
+};
+
+PERF_TEST_F(bloom_filter_test, murmur3_present) {
+    lookup(*murmur3_filter, present_keys);
+}
+
+PERF_TEST_F(bloom_filter_test, murmur3_absent) {
+    lookup(*murmur3_filter, absent_keys);
+}
+
+PERF_TEST_F(bloom_filter_test, blocked_present) {
+    lookup(*blocked_filter, present_keys);
+}
+
+PERF_TEST_F(bloom_filter_test, blocked_absent) {
+    lookup(*blocked_filter, absent_keys);
+}
@@ -23,6 +23,8 @@
 #include "sstables/checksum_utils.hh"
 #include "test/lib/make_random_string.hh"
 #include "utils/gz/crc_combine.hh"
+#include "utils/crc.hh"
+#include "utils/arch/x86/crc32-clmul.hh"
 
 #include "seastar/include/seastar/testing/perf_tests.hh"
 
@@ -67,3 +69,73 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+// Checksums of a compressed chunk of the default size, by implementation.
+// The tests return the number of bytes they checksum, so the reported
+// time is per byte: 1 / median in ns is the throughput in GB/s.
+struct checksum_throughput_test {
+    static constexpr size_t size = 4 * 1024;
+    const sstring data = make_random_string(size);
+
+    const uint8_t* bytes() const {
+        return reinterpret_cast<const uint8_t*>(data.data());
+    }
+};
+
+PERF_TEST_F(checksum_throughput_test, zlib_crc32) {
+    perf_tests::do_not_optimize(zlib_crc32_checksummer::checksum(data.data(), data.size()));
+    return size;
+}
+
+PERF_TEST_F(checksum_throughput_test, libdeflate_crc32) {
+    perf_tests::do_not_optimize(libdeflate_crc32_checksummer::checksum(data.data(), data.size()));
+    return size;
+}
+
+PERF_TEST_F(checksum_throughput_test, zlib_adler32) {
+    perf_tests::do_not_optimize(zlib_adler32_checksummer::checksum(data.data(), data.size()));
+    return size;
+}
+
+PERF_TEST_F(checksum_throughput_test, libdeflate_adler32) {
+    perf_tests::do_not_optimize(libdeflate_adler32_checksummer::checksum(data.data(), data.size()));
+    return size;
+}
+
+// CRC32C, as used by the commitlog, with the kernel picked for the CPU.
+PERF_TEST_F(checksum_throughput_test, crc32c) {
+    utils::crc32 c;
+    c.process(bytes(), size);
+    perf_tests::do_not_optimize(c.get());
+    return size;
+}
+
+// CRC32C with the crc32 instruction alone, 8 bytes at a time, as done
+// for buffers too small to fold.
+PERF_TEST_F(checksum_throughput_test, crc32c_sse42) {
+    utils::crc32 c;
+    for (size_t i = 0; i < size; i += 8) {
+        c.process_le(seastar::read_le<uint64_t>(data.data() + i));
+    }
+    perf_tests::do_not_optimize(c.get());
+    return size;
+}
+
+#if defined(__x86_64__)
+
+PERF_TEST_F(checksum_throughput_test, crc32c_pclmul) {
+    perf_tests::do_not_optimize(utils::x86::crc32c_pclmul(0, bytes(), size));
+    return size;
+}
+
+// Measures crc32c_pclmul again on CPUs without AVX-512 and VPCLMULQDQ.
+PERF_TEST_F(checksum_throughput_test, crc32c_vpclmul) {
+    if (utils::x86::crc32c_vpclmul_supported()) {
+        perf_tests::do_not_optimize(utils::x86::crc32c_vpclmul(0, bytes(), size));
+    } else {
+        perf_tests::do_not_optimize(utils::x86::crc32c_pclmul(0, bytes(), size));
+    }
+    return size;
+}
+
+#endif
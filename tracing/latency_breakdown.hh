@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <seastar/core/shared_ptr.hh>
+
+namespace tracing {
+
+// Where the time of a request went, as opposed to tracing, which records
+// what it did. Unlike trace_state, it is cheap enough to be accumulated for
+// every request: plain counters, with no allocation or formatting on the
+// read path.
+//
+// Replicas accumulate the part of their reads in the reader permit (see
+// reader_permit::latency_breakdown()), which the database adds to the
+// breakdown of the request, when given one, once the read is done. Disk
+// reads are only timed when the request asked for its breakdown, see
+// reader_permit::enable_latency_breakdown().
+struct latency_breakdown {
+    using clock = std::chrono::steady_clock;
+    using duration = clock::duration;
+
+    // Time waiting for admission by the reader concurrency semaphore.
+    duration admission_wait{};
+    // Time waiting for disk reads, and their number.
+    duration disk_wait{};
+    uint64_t disk_reads = 0;
+    // Partitions and rows read from sstables because the cache missed them.
+    uint64_t cache_misses = 0;
+    // Time the shard spent reclaiming LSA memory while reading.
+    duration lsa_reclaim{};
+    // Time the coordinator waited for replicas, local and remote.
+    duration replica_wait{};
+
+    latency_breakdown& operator+=(const latency_breakdown& o) {
+        admission_wait += o.admission_wait;
+        disk_wait += o.disk_wait;
+        disk_reads += o.disk_reads;
+        cache_misses += o.cache_misses;
+        lsa_reclaim += o.lsa_reclaim;
+        replica_wait += o.replica_wait;
+        return *this;
+    }
+};
+
+using latency_breakdown_ptr = seastar::lw_shared_ptr<latency_breakdown>;
+
+} // namespace tracing
@@ -859,7 +859,14 @@ cql_server::connection::init_cql_serialization_format() {
 
 std::unique_ptr<cql_server::response>
 make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata = false);
+        cql_protocol_version_type version, bool skip_metadata = false, const tracing::latency_breakdown* latency_breakdown = nullptr);
+
+// Custom payloads were introduced in version 4 of the protocol.
+static void maybe_init_latency_breakdown(const service::client_state& client_state, service::query_state& query_state, cql_protocol_version_type version) {
+    if (version > 3 && client_state.is_protocol_extension_set(cql_protocol_extension::LATENCY_BREAKDOWN)) {
+        query_state.set_latency_breakdown(make_lw_shared<tracing::latency_breakdown>());
+    }
+}
 
 template<typename Process>
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
@@ -914,6 +921,7 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
     auto query = in.read_long_string_view();
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
+    maybe_init_latency_breakdown(client_state, query_state, version);
     q_state->options = in.read_options(version, serialization_format, qp.local().get_cql_config());
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
@@ -936,7 +944,8 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata,
+                    q_state->query_state.get_latency_breakdown().get())));
         }
     });
 }
@@ -999,6 +1008,7 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
+    maybe_init_latency_breakdown(client_state, query_state, version);
     if (version == 1) {
         std::vector<cql3::raw_value_view> values;
         in.read_value_view_list(version, values);
@@ -1048,7 +1058,8 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata,
+                    q_state->query_state.get_latency_breakdown().get())));
         }
     });
 }
@@ -1443,14 +1454,40 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
     }
 };
 
+// The latency breakdown is returned as a custom payload, which follows the
+// tracing id and the warnings, see docs/protocol-extensions.md.
+static void write_latency_breakdown(cql_server::response& response, const tracing::latency_breakdown& lb) {
+    auto us = [] (tracing::latency_breakdown::duration d) -> int64_t {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    const std::pair<std::string_view, int64_t> entries[] = {
+        {"admission_wait_us", us(lb.admission_wait)},
+        {"disk_wait_us", us(lb.disk_wait)},
+        {"disk_reads", lb.disk_reads},
+        {"cache_misses", lb.cache_misses},
+        {"lsa_reclaim_us", us(lb.lsa_reclaim)},
+        {"replica_wait_us", us(lb.replica_wait)},
+    };
+    response.set_frame_flag(cql_frame_flags::custom_payload);
+    response.write_short(std::size(entries));
+    for (auto&& [name, value] : entries) {
+        response.write_string(name);
+        response.write_int(sizeof(int64_t));
+        response.write_long(value);
+    }
+}
+
 std::unique_ptr<cql_server::response>
 make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata) {
+        cql_protocol_version_type version, bool skip_metadata, const tracing::latency_breakdown* latency_breakdown) {
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, tr_state);
     if (__builtin_expect(!msg.warnings().empty() && version > 3, false)) {
         response->set_frame_flag(cql_frame_flags::warning);
         response->write_string_list(msg.warnings());
     }
+    if (latency_breakdown) {
+        write_latency_breakdown(*response, *latency_breakdown);
+    }
     cql_server::fmt_visitor fmt{version, *response, skip_metadata};
     msg.accept(fmt);
     return response;
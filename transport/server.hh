@@ -84,6 +84,7 @@ enum class cql_compression {
 enum cql_frame_flags {
     compression = 0x01,
     tracing     = 0x02,
+    custom_payload = 0x04,
     warning     = 0x08,
 };
 
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__x86_64__)
+
+#include <x86intrin.h>
+
+#include "utils/crc.hh"
+#include "crc32-clmul.hh"
+
+#define arch_target(name) [[gnu::target(name)]]
+
+// The input is folded into a few 128-bit accumulators: each accumulator is
+// multiplied by x^d mod P, d being the distance to the data it is xored
+// with, and reduced to 128 bits by splitting it into two 64-bit halves
+// multiplied by separate constants. Folding keeps the accumulators congruent
+// to the input modulo P, so once folded into a single one, its crc is the crc
+// of the input, and the crc32 instruction computes it.
+//
+// Each pair of constants folds by d bits. With P the CRC32C polynomial
+// 0x11edc6f41 and bitrev32() reversing the 32 bits of a value, they are:
+//     { bitrev32(x^(d+32) mod P) << 1, bitrev32(x^(d-32) mod P) << 1 }
+// for the low and the high 64-bit half of the accumulator.
+
+namespace utils::x86 {
+
+static inline uint32_t crc32c_tail(uint32_t crc, const uint8_t* in, size_t size) {
+    while (size >= 8) {
+        crc = _mm_crc32_u64(crc, seastar::read_le<uint64_t>(reinterpret_cast<const char*>(in)));
+        in += 8;
+        size -= 8;
+    }
+    while (size) {
+        crc = _mm_crc32_u8(crc, *in);
+        ++in;
+        --size;
+    }
+    return crc;
+}
+
+static inline uint32_t crc32c_of(__m128i x) {
+    uint32_t crc = _mm_crc32_u64(0, _mm_extract_epi64(x, 0));
+    return _mm_crc32_u64(crc, _mm_extract_epi64(x, 1));
+}
+
+static inline __m128i fold_128(__m128i x, __m128i k) {
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+static inline __m128i load_128(const uint8_t* in) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+}
+
+uint32_t crc32c_pclmul(uint32_t crc, const uint8_t* in, size_t size) {
+    const __m128i k_512 = _mm_set_epi64x(0x9e4addf8, 0x740eef02);
+    const __m128i k_128 = _mm_set_epi64x(0x14cd00bd6, 0xf20c0dfe);
+
+    // The register is xored into the first bytes of the input, like the
+    // crc32 instruction does.
+    __m128i x0 = _mm_xor_si128(load_128(in), _mm_cvtsi32_si128(crc));
+    __m128i x1 = load_128(in + 16);
+    __m128i x2 = load_128(in + 32);
+    __m128i x3 = load_128(in + 48);
+    in += 64;
+    size -= 64;
+
+    // Four independent accumulators, to hide the latency of pclmulqdq.
+    while (size >= 64) {
+        x0 = _mm_xor_si128(fold_128(x0, k_512), load_128(in));
+        x1 = _mm_xor_si128(fold_128(x1, k_512), load_128(in + 16));
+        x2 = _mm_xor_si128(fold_128(x2, k_512), load_128(in + 32));
+        x3 = _mm_xor_si128(fold_128(x3, k_512), load_128(in + 48));
+        in += 64;
+        size -= 64;
+    }
+
+    x1 = _mm_xor_si128(fold_128(x0, k_128), x1);
+    x2 = _mm_xor_si128(fold_128(x1, k_128), x2);
+    x3 = _mm_xor_si128(fold_128(x2, k_128), x3);
+    while (size >= 16) {
+        x3 = _mm_xor_si128(fold_128(x3, k_128), load_128(in));
+        in += 16;
+        size -= 16;
+    }
+
+    return crc32c_tail(crc32c_of(x3), in, size);
+}
+
+arch_target("avx512f,avx512vl,vpclmulqdq")
+static inline __m512i fold_512(__m512i x, __m512i k) {
+    return _mm512_xor_si512(_mm512_clmulepi64_epi128(x, k, 0x00), _mm512_clmulepi64_epi128(x, k, 0x11));
+}
+
+arch_target("avx512f,avx512vl,vpclmulqdq")
+static inline __m512i load_512(const uint8_t* in) {
+    return _mm512_loadu_si512(in);
+}
+
+arch_target("avx512f,avx512vl,vpclmulqdq")
+uint32_t crc32c_vpclmul(uint32_t crc, const uint8_t* in, size_t size) {
+    const __m512i k_2048 = _mm512_broadcast_i32x4(_mm_set_epi64x(0xb9e02b86, 0xdcb17aa4));
+    const __m512i k_512 = _mm512_broadcast_i32x4(_mm_set_epi64x(0x9e4addf8, 0x740eef02));
+
+    // Same as crc32c_pclmul(), with four 128-bit accumulators in each
+    // 512-bit register.
+    __m512i x0 = _mm512_xor_si512(load_512(in), _mm512_zextsi128_si512(_mm_cvtsi32_si128(crc)));
+    __m512i x1 = load_512(in + 64);
+    __m512i x2 = load_512(in + 128);
+    __m512i x3 = load_512(in + 192);
+    in += 256;
+    size -= 256;
+
+    while (size >= 256) {
+        x0 = _mm512_xor_si512(fold_512(x0, k_2048), load_512(in));
+        x1 = _mm512_xor_si512(fold_512(x1, k_2048), load_512(in + 64));
+        x2 = _mm512_xor_si512(fold_512(x2, k_2048), load_512(in + 128));
+        x3 = _mm512_xor_si512(fold_512(x3, k_2048), load_512(in + 192));
+        in += 256;
+        size -= 256;
+    }
+
+    x1 = _mm512_xor_si512(fold_512(x0, k_512), x1);
+    x2 = _mm512_xor_si512(fold_512(x1, k_512), x2);
+    x3 = _mm512_xor_si512(fold_512(x2, k_512), x3);
+    while (size >= 64) {
+        x3 = _mm512_xor_si512(fold_512(x3, k_512), load_512(in));
+        in += 64;
+        size -= 64;
+    }
+
+    // Fold the four 128-bit accumulators into the last one, by 384, 256
+    // and 128 bits.
+    __m128i x = _mm512_extracti32x4_epi32(x3, 3);
+    x = _mm_xor_si128(x, fold_128(_mm512_extracti32x4_epi32(x3, 0), _mm_set_epi64x(0x1d82c63da, 0x1c291d04)));
+    x = _mm_xor_si128(x, fold_128(_mm512_extracti32x4_epi32(x3, 1), _mm_set_epi64x(0xba4fc28e, 0x1384aa63a)));
+    x = _mm_xor_si128(x, fold_128(_mm512_extracti32x4_epi32(x3, 2), _mm_set_epi64x(0x14cd00bd6, 0xf20c0dfe)));
+
+    return crc32c_tail(crc32c_of(x), in, size);
+}
+
+bool crc32c_vpclmul_supported() {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("vpclmulqdq");
+}
+
+}
+
+namespace utils {
+
+arch_target("default") uint32_t crc32c_clmul_impl(uint32_t crc, const uint8_t* in, size_t size) {
+    return x86::crc32c_pclmul(crc, in, size);
+}
+
+arch_target("avx512f,avx512vl,vpclmulqdq") uint32_t crc32c_clmul_impl(uint32_t crc, const uint8_t* in, size_t size) {
+    if (size >= x86::crc32c_vpclmul_min_size) {
+        return x86::crc32c_vpclmul(crc, in, size);
+    }
+    return x86::crc32c_pclmul(crc, in, size);
+}
+
+uint32_t crc32::crc32_clmul(uint32_t crc, const uint8_t* in, size_t size) {
+    return crc32c_clmul_impl(crc, in, size);
+}
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021-present ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(__x86_64__)
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C (Castagnoli) kernels folding the input with carry-less
+// multiplication, as in Intel's "Fast CRC Computation for Generic
+// Polynomials Using PCLMULQDQ Instruction". The crc is the raw register,
+// as with the crc32 instruction, and utils::crc32.
+//
+// utils::crc32::process() picks the fastest one the CPU supports, they are
+// only exposed for tests and benchmarks.
+namespace utils::x86 {
+
+// At least 64 bytes, 16 bytes at a time. Needs PCLMULQDQ, part of the
+// baseline we build for.
+constexpr size_t crc32c_pclmul_min_size = 64;
+uint32_t crc32c_pclmul(uint32_t crc, const uint8_t* in, size_t size);
+
+// At least 256 bytes, 64 bytes at a time. Needs AVX-512 and VPCLMULQDQ.
+constexpr size_t crc32c_vpclmul_min_size = 256;
+uint32_t crc32c_vpclmul(uint32_t crc, const uint8_t* in, size_t size);
+bool crc32c_vpclmul_supported();
+
+}
+
+#endif
@@ -39,6 +39,8 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+
 #include "bloom_calculations.hh"
 
 namespace utils {
@@ -100,5 +102,31 @@ std::vector<int> initialize_opt_k() {
 }
 
 std::vector<int> opt_k_per_buckets = initialize_opt_k();
+
+double blocked_false_positive_rate(int bits_per_element) {
+    // The number of keys landing in a block follows a Poisson distribution.
+    // A block holding i keys answers yes for another key if the bit probed
+    // in each of its 8 words of 32 bits is set.
+    const double lambda = double(blocked_block_bits) / bits_per_element;
+    const auto max_keys = int(lambda + 20 * std::sqrt(lambda) + 50);
+    double p = std::exp(-lambda);
+    double rate = 0;
+    for (int i = 0; i <= max_keys; i++) {
+        rate += p * std::pow(1 - std::pow(1 - 1.0 / 32, i), 8);
+        p *= lambda / (i + 1);
+    }
+    return rate;
+}
+
+int blocked_bits_per_element(double max_false_pos_prob) {
+    for (int bits = 1; bits <= max_blocked_bits_per_element; bits++) {
+        if (blocked_false_positive_rate(bits) <= max_false_pos_prob) {
+            return bits;
+        }
+    }
+    throw exceptions::unsupported_operation_exception(format("Unable to satisfy {:f} with {:d} bits per element in a blocked filter",
+            max_false_pos_prob, max_blocked_bits_per_element));
+}
+
 }
 }
@@ -153,6 +153,24 @@ namespace bloom_calculations {
         }
         return std::min(probs.size() - 1, size_t(v));
     }
+
+    int constexpr blocked_block_bits = 256;
+    int constexpr max_blocked_bits_per_element = 64;
+
+    /**
+     * Returns the expected false positive rate of a split block bloom filter
+     * (utils::filter::blocked_bloom_filter) using the given number of bits
+     * per element.
+     */
+    double blocked_false_positive_rate(int bits_per_element);
+
+    /**
+     * Returns the smallest number of bits per element for which a split block
+     * bloom filter has a false positive rate not greater than the given one.
+     *
+     * @throws unsupported_operation_exception if the rate cannot be achieved
+     */
+    int blocked_bits_per_element(double max_false_pos_prob);
 }
 
 }
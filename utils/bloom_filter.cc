@@ -47,9 +47,17 @@
 #include <seastar/core/align.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <bit>
 #include <cstdlib>
 #include "bloom_filter.hh"
 
+#ifdef __x86_64__
+#include <x86intrin.h>
+#define arch_target(name) [[gnu::target(name)]]
+#else
+#define arch_target(name)
+#endif
+
 namespace utils {
 namespace filter {
 
@@ -103,12 +111,94 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+// Multiplying the key hash by each of the salts gives the bit to probe in
+// the corresponding word of the block.
+static constexpr std::array<uint32_t, blocked_bloom_filter::words_per_block> block_salts = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+static inline uint32_t block_word_mask(uint32_t h, unsigned word) {
+    return uint32_t(1) << ((h * block_salts[word]) >> 27);
+}
+
+// Bits are numbered as in large_bitset, so word i of a block is made of bits
+// [32 * i, 32 * (i + 1)) of the block.
+arch_target("default") bool block_contains_impl(const uint64_t* block, uint32_t h) {
+    for (unsigned w = 0; w < blocked_bloom_filter::words_per_block; ++w) {
+        auto word = uint32_t(block[w / 2] >> (32 * (w % 2)));
+        auto mask = block_word_mask(h, w);
+        if ((word & mask) != mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __x86_64__
+
+// On little endian, loading the four 64-bit words of the block as eight
+// 32-bit lanes gives the words in order.
+arch_target("avx2") bool block_contains_impl(const uint64_t* block, uint32_t h) {
+    auto salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block_salts.data()));
+    auto shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(h), salts), 27);
+    auto mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+    auto bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    // Tests that (~bits & mask) == 0
+    return _mm256_testc_si256(bits, mask);
+}
+
+#endif
+
+blocked_bloom_filter::blocked_bloom_filter(bitmap&& bs) noexcept
+    : bloom_filter(words_per_block, std::move(bs), filter_format::blocked_format)
+    , _nr_blocks(bits().size() / block_bits)
+{ }
+
+// The high half of the hash selects the block, the low half the bits in it.
+static inline uint64_t block_index(hashed_key key, uint64_t nr_blocks) {
+    return (static_cast<unsigned __int128>(key.hash()[0]) * nr_blocks) >> 64;
+}
+
+bool blocked_bloom_filter::is_present(hashed_key key) {
+    if (!_nr_blocks) {
+        return true;
+    }
+    // chunked_vector chunks hold a multiple of 4 words, so a block is never split.
+    constexpr size_t words_per_int = block_bits / 64;
+    auto& storage = bits().get_storage();
+    auto block = &storage[block_index(key, _nr_blocks) * words_per_int];
+    return block_contains_impl(block, uint32_t(key.hash()[1]));
+}
+
+void blocked_bloom_filter::add(const bytes_view& key) {
+    auto hk = make_hashed_key(key);
+    if (!_nr_blocks) {
+        return;
+    }
+    auto h = uint32_t(hk.hash()[1]);
+    auto first_bit = block_index(hk, _nr_blocks) * block_bits;
+    for (unsigned w = 0; w < words_per_block; ++w) {
+        bits().set(first_bit + 32 * w + std::countr_zero(block_word_mask(h, w)));
+    }
+}
+
+bool blocked_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
+    if (format == filter_format::blocked_format) {
+        return std::make_unique<blocked_bloom_filter>(std::move(bitset));
+    }
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
 
 filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter_format format) {
     int64_t num_bits = (num_elements * buckets_per) + bloom_calculations::EXCESS;
+    if (format == filter_format::blocked_format) {
+        num_bits = align_up<int64_t>(num_bits, blocked_bloom_filter::block_bits);
+        return std::make_unique<blocked_bloom_filter>(large_bitset(num_bits));
+    }
     num_bits = align_up<int64_t>(num_bits, 64);  // Seems to be implied in origin
     large_bitset bitset(num_bits);
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
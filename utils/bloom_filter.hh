@@ -100,6 +100,28 @@ struct murmur3_bloom_filter: public bloom_filter {
     {}
 };
 
+// A split block bloom filter: all the bits of a key are set in a single
+// 256-bit block, one bit in each of its eight 32-bit words. A lookup touches
+// a single cache line and checks all the bits with one vector comparison
+// where AVX2 is available. For the same size, the false positive rate is
+// somewhat higher than that of bloom_filter, which
+// bloom_calculations::blocked_bits_per_element() accounts for.
+class blocked_bloom_filter: public bloom_filter {
+public:
+    static constexpr unsigned block_bits = 256;
+    static constexpr unsigned words_per_block = 8;
+private:
+    uint64_t _nr_blocks;
+public:
+    explicit blocked_bloom_filter(bitmap&& bs) noexcept;
+
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+};
+
 struct always_present_filter: public i_filter {
 
     virtual bool is_present(const bytes_view& key) override {
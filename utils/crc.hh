@@ -100,7 +100,19 @@ class crc32 {
         process_le(in);
     }
 
+#if defined(__x86_64__)
+    // Folds the input with carry-less multiplication, see utils/arch/x86/crc32-clmul.cc.
+    // Needs at least 64 bytes.
+    static uint32_t crc32_clmul(uint32_t crc, const uint8_t* in, size_t size);
+#endif
+
     void process(const uint8_t* in, size_t size) {
+#if defined(__x86_64__)
+        if (size >= 64) {
+            _r = crc32_clmul(_r, in, size);
+            return;
+        }
+#endif
         if ((reinterpret_cast<uintptr_t>(in) & 1) && size >= 1) {
             process_le(*in);
             ++in;
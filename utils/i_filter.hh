@@ -51,6 +51,8 @@ using filter_ptr = std::unique_ptr<i_filter>;
 enum class filter_format {
     k_l_format,
     m_format,
+    // Split block filter, see filter::blocked_bloom_filter.
+    blocked_format,
 };
 
 class hashed_key {
@@ -849,6 +849,26 @@ class tree {
                 return nullptr;
             }
         }
+
+        /*
+         * Returns pointer on the owning tree, found by walking up to the root.
+         */
+        tree_ptr owning_tree() noexcept {
+            if (is_end()) {
+                return _tree;
+            }
+
+            node_base* n = revalidate();
+            if (n->is_inline()) {
+                return tree::from_inline(n);
+            }
+
+            node_ptr nd = node::from_base(n);
+            while (!nd->is_root()) {
+                nd = nd->_parent.n;
+            }
+            return nd->_parent.t;
+        }
     };
 
     using iterator_base_const = iterator_base<true>;
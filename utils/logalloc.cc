@@ -871,6 +871,7 @@ class segment_pool {
         uint64_t memory_freed;
         uint64_t memory_compacted;
         uint64_t memory_evicted;
+        std::chrono::steady_clock::duration reclaim_time;
     };
 private:
     stats _stats{};
@@ -880,6 +881,9 @@ class segment_pool {
     void on_memory_allocation(size_t size);
     void on_memory_deallocation(size_t size);
     void on_memory_eviction(size_t size);
+    void on_reclaim(std::chrono::steady_clock::duration d) noexcept {
+        _stats.reclaim_time += d;
+    }
     size_t unreserved_free_segments() const { return _free_segments - std::min(_free_segments, _emergency_reserve_max); }
     size_t free_segments() const { return _free_segments; }
 };
@@ -2159,6 +2163,7 @@ class reclaim_timer {
 
     ~reclaim_timer() {
         _duration = clock::now() - _start;
+        shard_segment_pool.on_reclaim(std::chrono::duration_cast<std::chrono::steady_clock::duration>(_duration));
         _stall_detected = _duration >= engine().get_blocked_reactor_notify_ms();
         if (_debug_enabled || _stall_detected) {
             report();
@@ -2717,6 +2722,10 @@ uint64_t memory_evicted() {
     return shard_segment_pool.statistics().memory_evicted;
 }
 
+std::chrono::steady_clock::duration reclaim_time() {
+    return shard_segment_pool.statistics().reclaim_time;
+}
+
 occupancy_stats lsa_global_occupancy_stats() {
     return occupancy_stats(shard_segment_pool.total_free_memory(), shard_segment_pool.total_memory_in_use());
 }
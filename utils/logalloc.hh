@@ -840,6 +840,9 @@ uint64_t memory_allocated();
 uint64_t memory_freed();
 uint64_t memory_compacted();
 uint64_t memory_evicted();
+// Total time the shard spent in reclamation cycles, with the resolution of
+// utils::coarse_steady_clock.
+std::chrono::steady_clock::duration reclaim_time();
 
 occupancy_stats lsa_global_occupancy_stats();
 
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <boost/intrusive/list.hpp>
+#include <seastar/core/loop.hh>
 #include <seastar/core/memory.hh>
 
 class evictable {
@@ -52,6 +53,22 @@ class evictable {
     }
 };
 
+// A position in an lru, which lets a walk over it be resumed after a
+// preemption point. See lru::walk_from_most_recent().
+class lru_marker final : public evictable {
+    bool _evicted = false;
+public:
+    virtual void on_evicted() noexcept override {
+        _evicted = true;
+    }
+
+    // The marker reached the least recently used end and was evicted, so
+    // there is nothing left to walk.
+    bool evicted() const noexcept {
+        return _evicted;
+    }
+};
+
 class lru {
 private:
     friend class evictable;
@@ -92,6 +109,34 @@ class lru {
         return reclaiming_result::reclaimed_something;
     }
 
+    // Calls func on up to max elements, from the most recently used one
+    // towards the least recently used one. The walk starts at the marker if
+    // it's linked, or else at the most recently used end. The marker is then
+    // linked past the last element visited, so that the next call resumes
+    // from there. Elements touched in the meantime move behind the marker and
+    // are not visited again.
+    // Returns stop_iteration::yes when no element is left to visit.
+    // func must not modify the lru.
+    template <typename Func>
+    seastar::stop_iteration walk_from_most_recent(lru_marker& marker, size_t max, Func&& func) {
+        if (marker.evicted()) {
+            return seastar::stop_iteration::yes;
+        }
+        auto it = marker.is_linked() ? _list.iterator_to(marker) : _list.end();
+        size_t visited = 0;
+        while (it != _list.begin() && visited < max) {
+            --it;
+            func(*it);
+            ++visited;
+        }
+        if (it == _list.begin()) {
+            return seastar::stop_iteration::yes;
+        }
+        marker.unlink_from_lru();
+        _list.insert(it, marker);
+        return seastar::stop_iteration::no;
+    }
+
     // Evicts all elements.
     // May stall the reactor, use only in tests.
     void evict_all() {
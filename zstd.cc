@@ -25,6 +25,8 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
 
 #include "compress.hh"
 #include "utils/class_registrator.hh"
@@ -32,8 +34,49 @@
 static const sstring COMPRESSION_LEVEL = "compression_level";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 
+struct cdict_deleter {
+    void operator()(ZSTD_CDict* cdict) const noexcept {
+        ZSTD_freeCDict(cdict);
+    }
+};
+
+struct ddict_deleter {
+    void operator()(ZSTD_DDict* ddict) const noexcept {
+        ZSTD_freeDDict(ddict);
+    }
+};
+
+class zstd_dictionary final : public compression_dictionary {
+    bytes _content;
+    // Digested for decompression once, and used by all the compressors
+    // of the dictionary. References _content.
+    std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+public:
+    explicit zstd_dictionary(bytes content)
+        : _content(std::move(content))
+        , _ddict(ZSTD_createDDict_byReference(_content.data(), _content.size())) {
+        if (!_ddict) {
+            throw std::runtime_error("Unable to load ZSTD dictionary");
+        }
+    }
+
+    virtual bytes_view content() const override {
+        return _content;
+    }
+
+    const ZSTD_DDict* ddict() const {
+        return _ddict.get();
+    }
+};
+
 class zstd_processor : public compressor {
     int _compression_level = 3;
+    size_t _chunk_len;
+
+    const zstd_dictionary* _dictionary = nullptr;
+    // Digested for compression with _dictionary on first use, since
+    // only writers need it. References the dictionary content.
+    mutable std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
 
     // Manages memory for the compression context.
     std::unique_ptr<char[], free_deleter> _cctx_raw;
@@ -44,8 +87,13 @@ class zstd_processor : public compressor {
     std::unique_ptr<char[], free_deleter> _dctx_raw;
     // Decompression context. Observer of _dctx_raw.
     ZSTD_DCtx* _dctx;
+
+    ZSTD_compressionParameters cparams() const;
+    void init_contexts();
+    const ZSTD_CDict* cdict() const;
 public:
     zstd_processor(const opt_getter&);
+    zstd_processor(const zstd_processor& base, const zstd_dictionary& dictionary);
 
     size_t uncompress(const char* input, size_t input_len, char* output,
                     size_t output_len) const override;
@@ -55,6 +103,13 @@ class zstd_processor : public compressor {
 
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
+
+    bool supports_dictionary() const override {
+        return true;
+    }
+    std::unique_ptr<compression_dictionary> train_dictionary(const std::vector<bytes_view>& samples, size_t max_size) const override;
+    std::unique_ptr<compression_dictionary> make_dictionary(bytes content) const override;
+    compressor_ptr with_dictionary(const compression_dictionary& dictionary) const override;
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
@@ -80,14 +135,29 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
+    init_contexts();
+}
+
+zstd_processor::zstd_processor(const zstd_processor& base, const zstd_dictionary& dictionary)
+    : compressor(COMPRESSOR_NAME)
+    , _compression_level(base._compression_level)
+    , _chunk_len(base._chunk_len)
+    , _dictionary(&dictionary) {
+    init_contexts();
+}
+
+ZSTD_compressionParameters zstd_processor::cparams() const {
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
-    auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+    return ZSTD_getCParams(_compression_level, _chunk_len, _dictionary ? _dictionary->content().size() : 0);
+}
+
+void zstd_processor::init_contexts() {
+    auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams());
     // According to the ZSTD documentation, pointer to the context buffer must be 8-bytes aligned.
     _cctx_raw = allocate_aligned_buffer<char>(cctx_size, 8);
     _cctx = ZSTD_initStaticCCtx(_cctx_raw.get(), cctx_size);
@@ -98,13 +168,27 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     auto dctx_size = ZSTD_estimateDCtxSize();
     _dctx_raw = allocate_aligned_buffer<char>(dctx_size, 8);
     _dctx = ZSTD_initStaticDCtx(_dctx_raw.get(), dctx_size);
-    if (!_cctx) {
+    if (!_dctx) {
         throw std::runtime_error("Unable to initialize ZSTD decompression context");
     }
 }
 
+const ZSTD_CDict* zstd_processor::cdict() const {
+    if (!_cdict) {
+        auto content = _dictionary->content();
+        _cdict.reset(ZSTD_createCDict_advanced(content.data(), content.size(), ZSTD_dlm_byRef, ZSTD_dct_auto,
+                cparams(), ZSTD_defaultCMem));
+        if (!_cdict) {
+            throw std::runtime_error("Unable to initialize ZSTD compression dictionary");
+        }
+    }
+    return _cdict.get();
+}
+
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
+    auto ret = _dictionary
+            ? ZSTD_decompress_usingDDict(_dctx, output, output_len, input, input_len, _dictionary->ddict())
+            : ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -113,7 +197,9 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
+    auto ret = _dictionary
+            ? ZSTD_compress_usingCDict(_cctx, output, output_len, input, input_len, cdict())
+            : ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -132,5 +218,47 @@ std::map<sstring, sstring> zstd_processor::options() const {
     return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
 }
 
+std::unique_ptr<compression_dictionary> zstd_processor::train_dictionary(const std::vector<bytes_view>& samples, size_t max_size) const {
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    size_t total_size = 0;
+    for (auto& sample : samples) {
+        sizes.push_back(sample.size());
+        total_size += sample.size();
+    }
+    bytes buffer(bytes::initialized_later(), total_size);
+    auto out = buffer.begin();
+    for (auto& sample : samples) {
+        out = std::copy(sample.begin(), sample.end(), out);
+    }
+
+    // Fixed parameters rather than letting zstd search for the best ones,
+    // which takes a lot longer, so that training is cheap enough to run
+    // as part of writing an sstable. The frequency table (2^f entries) is
+    // sized for the small inputs it is given.
+    ZDICT_fastCover_params_t params = {};
+    params.k = 1024;
+    params.d = 8;
+    params.f = 16;
+    params.accel = 1;
+    params.zParams.compressionLevel = _compression_level;
+
+    bytes dictionary(bytes::initialized_later(), max_size);
+    auto ret = ZDICT_trainFromBuffer_fastCover(dictionary.data(), dictionary.size(), buffer.data(), sizes.data(), sizes.size(), params);
+    if (ZDICT_isError(ret)) {
+        return nullptr;
+    }
+    dictionary.resize(ret);
+    return std::make_unique<zstd_dictionary>(std::move(dictionary));
+}
+
+std::unique_ptr<compression_dictionary> zstd_processor::make_dictionary(bytes content) const {
+    return std::make_unique<zstd_dictionary>(std::move(content));
+}
+
+compressor_ptr zstd_processor::with_dictionary(const compression_dictionary& dictionary) const {
+    return ::make_shared<zstd_processor>(*this, dynamic_cast<const zstd_dictionary&>(dictionary));
+}
+
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>
     registrator(COMPRESSOR_NAME);